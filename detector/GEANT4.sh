@@ -1,8 +1,13 @@
 #!/bin/bash
 # FLOUNDER-specific GEANT4 environment
 
-# Force single-threaded mode to avoid ROOT threading issues
-export G4FORCE_RUN_MANAGER_TYPE=Serial
+# Run-manager type is chosen by flndr (--threads=N; N=1 forces serial).
+# Set FLNDR_FORCE_SERIAL=1 to pin every Geant4 app in this shell to serial mode.
+if [ "${FLNDR_FORCE_SERIAL:-0}" = "1" ]; then
+  export G4FORCE_RUN_MANAGER_TYPE=Serial
+else
+  unset G4FORCE_RUN_MANAGER_TYPE
+fi
 
 export G4VIS_DEFAULT_DRIVER=TSG_OFFSCREEN
 
@@ -39,4 +44,4 @@ export G4_ROOTRACKER="/Users/jingyuanzhang/Desktop/AstroParticle/FLOUNDER/data/g
 export G4_ZSHIFT_MM=-20000
 export FLNDR_OPTICS_DIR="/Users/jingyuanzhang/Desktop/AstroParticle/FLOUNDER/detector/optics"
 
-echo "FLOUNDER environment loaded (single-threaded mode)"
+echo "FLOUNDER environment loaded (run manager: ${G4FORCE_RUN_MANAGER_TYPE:-flndr --threads})"
@@ -2,9 +2,13 @@
 #include <G4String.hh>
 #include <G4VUserActionInitialization.hh>
 
+#include <memory>
 #include <string>
 #include <optional>
 
+class PMTDigitizer;
+class RootrackerSource;
+
 struct RunProfileConfig {
   bool enableDigitizer = false;
   bool enableTTS = true;
@@ -16,6 +20,18 @@ struct RunProfileConfig {
   std::optional<double> qeFlatOverride;
   std::optional<double> qeScaleFactor;
   std::optional<double> thresholdOverride;
+  // --qe_prethin: optical photons survive birth with photonKeepProbability
+  // (qe_scale * max QE); the digitizer divides it back out.
+  bool qePrethin = false;
+  double photonKeepProbability = 1.0;
+  // --photon_weight: survivors of pre-thinning are kept with 1/w at weight w.
+  double photonWeight = 1.0;
+  // Rootracker slice for batch jobs (--shard=i/N or --first_entry/--n_entries).
+  int shardIndex = -1;
+  int shardCount = 0;
+  long long firstEntry = -1;
+  long long nEntries = -1;
+  std::string outputTag;   // e.g. ".shard3", inserted into output file names
 };
 
 class ActionInitialization : public G4VUserActionInitialization {
@@ -23,11 +39,18 @@ public:
   ActionInitialization(const G4String& rfile,
                        double zshift,
                        RunProfileConfig profile);
-  ~ActionInitialization() override = default;
+  ~ActionInitialization() override;
+  void BuildForMaster() const override;
   void Build() const override;
 
 private:
   G4String fRootFile;
   double   fZshift;
   RunProfileConfig fProfile;
+  // Built on the master so every worker claims entries from one prefetching reader.
+  std::unique_ptr<RootrackerSource> fSource;
+  // Sub-event mode only: master-side digitizer fed by OpticalSubEvent.
+  mutable std::unique_ptr<PMTDigitizer> fMasterDigitizer;
+
+  PMTDigitizer* MakeDigitizer() const;
 };
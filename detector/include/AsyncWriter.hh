@@ -0,0 +1,50 @@
+#pragma once
+
+#include "BoundedQueue.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Dedicated output thread for one simulation thread. The owner submits one
+// job per event (typically "fill these records into the tree"); jobs run in
+// submission order on the I/O thread, so TTree::Fill, basket compression and
+// file-system latency stay off the event loop. Single producer, single
+// consumer: each worker/digitizer owns its own writer.
+class AsyncWriter {
+public:
+  using Job = std::function<void()>;
+
+  explicit AsyncWriter(std::size_t depth = 64);
+  ~AsyncWriter(); // drains pending jobs, then joins the I/O thread
+
+  AsyncWriter(const AsyncWriter&) = delete;
+  AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+  // Queue a job; blocks (back-pressure) while `depth` jobs are pending.
+  void Submit(Job job);
+  // Wait until every submitted job has run; rethrows the first job failure.
+  void Flush();
+
+private:
+  void Loop();
+
+  BoundedQueue<Job> fQueue;
+  // The queue itself is lock-free; the mutex only orders sleeping against
+  // waking. Each signaller changes the state, then takes the mutex before it
+  // notifies, so a waiter that has checked its predicate cannot miss it.
+  std::mutex fWakeMutex;
+  std::condition_variable fWake;    // I/O thread: a job was queued, or stop
+  std::condition_variable fNotFull; // owner: the I/O thread popped a job
+  std::condition_variable fDrained; // owner: the I/O thread finished a job
+  std::atomic<bool> fStop{false};
+  std::atomic<std::uint64_t> fSubmitted{0};
+  std::atomic<std::uint64_t> fDone{0};
+  std::exception_ptr fError; // written by the I/O thread before fDone advances
+  std::thread fThread;       // last: starts once every member above exists
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "PMTHit.hh"
+
+#include <G4ThreeVector.hh>
+
+#include <cstddef>
+
+class G4LogicalVolume;
+class G4OpticalSurface;
+class G4Track;
+
+// Batched optical photon tracer (--optical_backend=batch). The water cans
+// DetectorConstruction builds are a G4Box or G4Tubs with photocathode discs
+// on the walls, so photons can be moved analytically instead of through the
+// Geant4 navigator.
+//
+// The stacking action queues each new optical photon (after thinning and
+// weighting) and kills the G4Track; at the end of the event PMTSD flushes
+// the queue. Photons are kept as structure-of-arrays and moved in passes:
+// every pass draws the random numbers, then runs branch-free loops over the
+// whole batch (interaction length, wall distance, nearest disc crossing,
+// advance) that the compiler vectorizes, and finally resolves the
+// interactions and compacts the survivors. The disc test only covers the
+// discs the SurfaceHits aperture map lists along each step.
+//
+// Physics: absorption and Rayleigh (1 + cos^2) scattering from the water
+// MPT, following the processes switched on in G4OpticalParameters; the wall
+// absorbs with 1 - REFLECTIVITY(lambda), then reflects Lambertian (ground)
+// or specularly (polished), with Fresnel transmission to the world for a
+// dielectric_dielectric wall. A photon crossing a photocathode disc from
+// either side is a hit. Not modelled: Mie, polarization, Fresnel at the
+// photocathode and the disc thickness.
+namespace BatchOptics {
+
+// Main, before the detector is built.
+void Configure();
+bool Enabled();
+
+// DetectorConstruction, after the PMT registry is frozen and the aperture
+// map is built: snapshot the can (placed at `canOffset` in the world,
+// unrotated), the wall surface and the photocathode radius. Returns false if
+// the can shape is unsupported.
+bool Build(const G4LogicalVolume* canLV, const G4ThreeVector& canOffset,
+           const G4OpticalSurface* wallSurface, double cathodeRadius);
+bool Ready();
+
+// Stacking action: queue a new optical photon on this thread.
+void Enqueue(const G4Track* track);
+// PMTSD, end of event: trace this thread's queue into `hits` and clear it.
+// Returns the number of hits added.
+std::size_t Flush(PMTHitsCollection* hits);
+
+// Master, begin/end of run.
+void ResetCounters();
+void Report();
+
+} // namespace BatchOptics
@@ -1,20 +1,28 @@
 #pragma once
 
+#include <memory>
 #include <string>
 
+#include "NativeGeometry.hh"
+#include "PMTLayout.hh"
+
 #include <G4GDMLParser.hh>
 #include <G4String.hh> 
 #include <G4VUserDetectorConstruction.hh>
 
+class G4LogicalVolume;
+
 class DetectorConstruction : public G4VUserDetectorConstruction {
 public:
   explicit DetectorConstruction(const G4String& gdmlPath,
                                 std::string opticsConfigPath = std::string(),
                                 int checkOverlapsN = 0,
                                 double qeOverride = std::numeric_limits<double>::quiet_NaN(),
-                                double qeFlat = std::numeric_limits<double>::quiet_NaN());
+                                double qeFlat = std::numeric_limits<double>::quiet_NaN(),
+                                std::string geometryConfigPath = std::string());
   ~DetectorConstruction() override = default;
   G4VPhysicalVolume* Construct() override;
+  void ConstructSDandField() override;
 private:
   G4String fGdmlPath;
   std::string fOpticsPath;
@@ -22,4 +30,9 @@ private:
   double fQeOverride = std::numeric_limits<double>::quiet_NaN();
   double fQeFlat = std::numeric_limits<double>::quiet_NaN();
   G4GDMLParser fParser;
+  std::string fGeometryPath;                          // native builder YAML (empty => GDML)
+  std::unique_ptr<NativeGeometryConfig> fNative;
+  G4LogicalVolume* fCanLV = nullptr; // water can, set by Construct()
+  std::unique_ptr<PMTLayout> fPMTLayout;             // PMT positions and shared rotations
+  std::unique_ptr<G4VPVParameterisation> fPMTParam;  // parameterised placement (FLNDR_PMT_PLACEMENT)
 };
@@ -9,6 +9,13 @@
 #include "G4VPhysicalVolume.hh"
 #include "G4ThreeVector.hh"
 
+class G4OpBoundaryProcess;
+class G4Track;
+
+// The optical boundary process (cached per thread after the first lookup);
+// its GetStatus() describes the current step.
+G4OpBoundaryProcess* FindBoundaryProcess(const G4Track* track);
+
 struct HitCandidate {
   int    pmt{};
   double t_ns{};
@@ -38,7 +45,7 @@ public:
 
   const DigitizerParams& Params() const { return params_; }
 
-  void Digitize(int event_id, const std::vector<HitCandidate>& candidates,
+  void Digitize(int event_id, double t0_ns, const std::vector<HitCandidate>& candidates,
                 std::vector<DigiHit>& out_hits) const;
   void AddDarkNoise(int event_id, double t0_ns, std::vector<DigiHit>& out_hits) const;
 
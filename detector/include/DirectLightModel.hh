@@ -0,0 +1,69 @@
+#pragma once
+
+#include <G4ThreeVector.hh>
+#include <G4VFastSimulationModel.hh>
+
+#include <vector>
+
+class G4MaterialPropertiesTable;
+class G4Region;
+class G4Track;
+struct PMTSnapshot;
+
+// Analytic direct light (profile day2fast). Every optical photon born in the
+// water-can region is intercepted before its first step: its straight ray is
+// intersected with the photocathode discs of the frozen PMT table, and the
+// nearest disc it crosses records a hit with probability
+// exp(-d/L_abs - d/L_scat) at t + d/v_group, using the water MPT and the
+// scattering processes that are switched on. QE stays with the digitizer.
+// Only the discs the SurfaceHits aperture map lists along the ray, up to
+// the can wall, are tested, so the cost per photon does not grow with the
+// PMT count.
+//
+// The photon is then killed, except for a random fraction
+// IndirectFraction() which is tracked on at weight w/f to sample scattered
+// and reflected light. A kept photon whose ray crosses a disc is marked with
+// that PMT; PMTSD drops it if it still enters that PMT on its emission ray,
+// since that light was already counted here. The check is on positions, not
+// directions: refraction into the photocathode turns a direct photon.
+namespace DirectLight {
+
+constexpr const char* kRegionName = "WaterCanRegion";
+
+// Main, before the physics list and detector are built.
+void Configure(double indirectFraction);
+bool Enabled();
+double IndirectFraction();
+
+// DirectLightModel: `track` is kept for indirect sampling although its ray
+// was counted on PMT `pmtId`.
+void MarkCounted(const G4Track& track, int pmtId);
+// PMTSD: true if `track` was marked for `pmtId` and enters it at `entry`
+// (global) on the straight line from its vertex.
+bool IsDirectArrival(const G4Track& track, int pmtId, const G4ThreeVector& entry);
+
+} // namespace DirectLight
+
+class DirectLightModel : public G4VFastSimulationModel {
+public:
+  DirectLightModel(const G4String& name, G4Region* region);
+  ~DirectLightModel() override = default;
+
+  G4bool IsApplicable(const G4ParticleDefinition& particle) override;
+  G4bool ModelTrigger(const G4FastTrack& fastTrack) override;
+  void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) override;
+
+private:
+  // Slot of the nearest photocathode disc crossed by the ray (can
+  // coordinates), or -1; `distance` in mm.
+  int Intersect(const G4ThreeVector& pos, const G4ThreeVector& dir, double& distance) const;
+  double InverseAttenuationLength(const G4MaterialPropertiesTable* mpt, double energy) const;
+  void Deposit(const G4Track& track, int pmtId, double time, double weight, double path);
+
+  const PMTSnapshot* fPMTs = nullptr;
+  std::vector<int> fAllSlots; // candidates when there is no aperture map
+  double fCathodeRadius2 = 0.0;  // mm^2
+  bool fRayleigh = false;
+  bool fMie = false;
+  int fHCId = -1;
+};
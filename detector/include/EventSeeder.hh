@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Per-event engine seeding keyed on the input record rather than on
+// processing order. With it enabled, the seeds of event `key` (rootracker
+// entry, or G4 event id in gun mode) depend only on (run seed, key), so
+// serial, multithreaded and sharded runs reproduce the same hits for the
+// same entry.
+namespace EventSeeder {
+
+// Philox4x32-10 (Salmon et al., SC'11): counter-based, so any (key, counter)
+// pair can be evaluated directly without stepping a stream.
+std::array<std::uint32_t, 4> Philox4x32(std::array<std::uint32_t, 4> ctr,
+                                        std::array<std::uint32_t, 2> key);
+
+void Configure(std::uint64_t runSeed, bool perEvent);
+bool Enabled();
+std::uint64_t RunSeed();
+
+// Reseed the calling thread's engine for `key`. Call after the input record
+// is known and before anything in the event draws a random number.
+// `stream` selects an independent sequence for work done outside the event
+// (e.g. deferred digitization). No-op unless per-event seeding is enabled.
+void SeedEvent(long long key, std::uint32_t stream = 0);
+
+// Random numbers drawn straight from Philox4x32 at counters {block, id, 0, 0},
+// block = 0, 1, ...: one independent stream per `id` under `key`, usable on
+// any thread without touching the G4 engine. Draws depend only on (key, id)
+// and the number of earlier draws from the same stream.
+class PhiloxStream {
+public:
+  PhiloxStream(std::uint64_t key, std::uint32_t id);
+
+  double Flat();                           // uniform in (0, 1)
+  double Gauss(double mean, double sigma);
+  long Poisson(double mean);               // same method as G4Poisson
+
+private:
+  std::uint32_t Next();
+
+  std::array<std::uint32_t, 2> fKey;
+  std::uint32_t fId;
+  std::uint32_t fBlock = 0;
+  std::array<std::uint32_t, 4> fWords{};
+  int fUsed = 4;
+  bool fHasSpare = false;
+  double fSpare = 0.0;
+};
+
+} // namespace EventSeeder
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include <G4ThreeVector.hh>
@@ -11,18 +14,47 @@ struct PMTRecord {
   G4ThreeVector normal;   // unit vector pointing into water
 };
 
+// Immutable, id-indexed PMT table (structure of arrays, slots sorted by id).
+// Published once geometry construction is done; readers never lock.
+struct PMTSnapshot {
+  std::vector<int>    id;          // copy number per slot
+  std::vector<double> x, y, z;     // center [mm]
+  std::vector<double> nx, ny, nz;  // unit normal into water
+
+  std::size_t Size() const { return id.size(); }
+  // Slot of copy number `pmtId`, or -1. O(1) for dense ids (the usual case).
+  int Slot(int pmtId) const;
+  G4ThreeVector Position(int slot) const { return {x[slot], y[slot], z[slot]}; }
+  G4ThreeVector Normal(int slot) const { return {nx[slot], ny[slot], nz[slot]}; }
+
+  int minId = 0;
+  std::vector<int> slotOfId;       // pmtId - minId -> slot (-1 if absent); empty if ids are sparse
+};
+
 class GeometryRegistry {
 public:
   static GeometryRegistry& Instance();
 
+  // Construction phase (DetectorConstruction): O(1) amortised per insert.
   void ClearPMTs();
   void RegisterPMT(int id, const G4ThreeVector& position, const G4ThreeVector& normal);
+  // Freeze the registered PMTs into a new snapshot and publish it.
+  void Freeze();
+
+  // Lock-free once frozen; nullptr before the first Freeze().
+  const PMTSnapshot* Snapshot() const { return fSnapshot.load(std::memory_order_acquire); }
+
   bool GetPMT(int id, PMTRecord& out) const;
   const std::vector<PMTRecord>& GetPMTs() const { return fPMTs; }
 
 private:
   GeometryRegistry() = default;
 
-  mutable std::mutex fMutex;
+  mutable std::mutex fMutex;  // construction phase only
   std::vector<PMTRecord> fPMTs;
+  std::unordered_map<int, std::size_t> fIndex; // id -> fPMTs slot
+
+  std::atomic<const PMTSnapshot*> fSnapshot{nullptr};
+  // Superseded snapshots stay alive: a reader may still hold a pointer.
+  std::vector<std::unique_ptr<const PMTSnapshot>> fSnapshots;
 };
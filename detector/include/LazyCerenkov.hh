@@ -0,0 +1,58 @@
+#pragma once
+
+#include <G4ThreeVector.hh>
+
+#include <string>
+
+class G4StackManager;
+class G4Step;
+
+// Deferred Cerenkov emission (--lazy_cerenkov=N). G4Cerenkov is switched
+// off; instead every charged step in a material with RINDEX is recorded as
+// a compact emitter segment (end points, times, direction, 1/beta, mean
+// photon count). Once the urgent stack runs dry the stacking action asks
+// for the next chunk: at most N photons are sampled from the pending
+// segments with G4Cerenkov's spectrum and cone, and pushed through the
+// normal classification. The G4Track stack then never holds more than one
+// chunk of photons, however energetic the event is.
+//
+// Two-stage running reuses the segments. Stage 1 (--segments_out) writes
+// each event's segments to a file and emits nothing, so only the charged
+// shower is simulated. Stage 2 (--segments_in) skips the shower: the
+// primary generator loads one stored event at a time and its photons are
+// emitted from the segments under the stage-2 optics. The stored segments
+// keep 1/beta, charge and path length, and the photon yield is recomputed
+// from the stage-2 RINDEX. Segments below the stage-1 Cerenkov threshold
+// are not stored.
+namespace LazyCerenkov {
+
+constexpr int kDefaultChunk = 10000;
+
+// Main: enable with `chunk` photons per batch (0 => off).
+void Configure(int chunk);
+bool Enabled();
+int ChunkSize();
+
+// Main, after Configure: stage 1 / stage 2 segment files. Throw
+// std::runtime_error if the file cannot be opened or is not a segment file.
+void WriteTo(const std::string& path);
+void ReadFrom(const std::string& path);
+bool Writing();
+bool Replaying();
+// Primary generator, stage 2: queue the next stored event on this thread.
+// Returns false once the file is exhausted.
+bool LoadNextEvent(long long& key, double& t0ns, G4ThreeVector& x0);
+
+// Stepping action, every step: record a segment if the step radiates.
+void Record(const G4Step* step);
+// Stacking action: PrepareNewEvent / NewStage.
+void BeginEvent();
+// Push up to ChunkSize() photons; returns how many were pushed. In stage 1
+// nothing is pushed and the event's segments are written once it is done.
+int Emit(G4StackManager* stack);
+
+// Master, begin/end of run. Report also flushes the stage-1 file.
+void ResetCounters();
+void Report();
+
+} // namespace LazyCerenkov
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "PMTLayout.hh"
+
+#include <string>
+
+class G4VPhysicalVolume;
+
+// Native detector builder (--geometry=<cfg.yaml>): the world box, the water
+// can and the wall PMT layout knobs come from a small YAML file instead of
+// a GDML parse, for the fixed can designs and for layout scans without
+// regenerating GDML through macros/make_geo.C. The volumes are named as in
+// the make_geo.C GDML ("TopVolume", and the can LV/PV from G4_CAN_LV or
+// "Detector"), so everything after the geometry source is unchanged. The
+// GDML path (G4_GDML) stays the default. See detector/config/geometry.yaml.
+struct NativeGeometryConfig {
+  std::string path;
+  std::string shape = "tubs";   // tubs | box
+  double worldHalfX = 0.0;      // G4 units
+  double worldHalfY = 0.0;
+  double worldHalfZ = 0.0;
+  double canRadius = 0.0;       // tubs
+  double canHalfZ = 0.0;        // tubs and box
+  double canHalfX = 0.0;        // box
+  double canHalfY = 0.0;        // box
+  PMTWallSpec pmts;
+};
+
+namespace NativeGeometry {
+
+// Parse and validate the YAML; throws std::runtime_error on bad input.
+NativeGeometryConfig LoadFromYaml(const std::string& path);
+
+// Build the world (G4_Galactic) holding the can (G4_WATER) named `canName`,
+// centred. Returns the world PV.
+G4VPhysicalVolume* Build(const NativeGeometryConfig& cfg, const std::string& canName);
+
+// "tubs r=1.50m halfz=20.00m pmts: ..." for the startup log.
+std::string Describe(const NativeGeometryConfig& cfg);
+
+} // namespace NativeGeometry
@@ -0,0 +1,32 @@
+#pragma once
+
+class G4Step;
+
+// Russian roulette for long-lived optical photons (--roulette_reflections=K,
+// --roulette_distance_m=X, --roulette_survival=p). Photons that bounce
+// around the can cost the most steps and rarely arrive inside the gate.
+// Each time a photon completes another K boundary reflections (from the
+// G4OpBoundaryProcess status) or another X metres of path, it plays once:
+// it survives with probability p and its weight is multiplied by 1/p,
+// otherwise it is killed. PMTSD stores the weight as the hit's PE, so the
+// expected detected PE are unchanged.
+//
+// The end-of-run line reports the killed fraction and the Kish effective
+// sample size (sum w)^2 / sum w^2 of the detected hits.
+namespace OpticalRoulette {
+
+// Main: K reflections and/or X [mm] per round (0 => that trigger off).
+void Configure(int reflections, double distanceMm, double survival);
+bool Enabled();
+
+// Stepping action, every optical photon step still alive. Returns true if
+// the track was killed.
+bool Apply(const G4Step* step);
+// PMTSD: a hit of weight `weight` was recorded.
+void RecordHit(double weight);
+
+// Master, begin/end of run.
+void ResetCounters();
+void Report();
+
+} // namespace OpticalRoulette
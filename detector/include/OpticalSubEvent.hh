@@ -0,0 +1,80 @@
+#pragma once
+
+#include "PMTHit.hh"
+
+#include <G4ClassificationOfNewTrack.hh>
+#include <G4VUserTrackInformation.hh>
+
+#include <map>
+#include <vector>
+
+class G4Event;
+class G4Track;
+
+// Sub-event parallel optical tracking (--subevent_photons=N, Geant4 >= 11.2).
+// The stacking action routes optical photons into batches of N that the
+// G4SubEvtRunManager farms out to idle workers, so one big event is no longer
+// tracked on a single thread. Photons carry their parent event's key and t0;
+// each sub-event collects its hits and PhotonBudget counters per parent key
+// and posts them once when it ends. The sink counts the routed photons of
+// every event still in flight: the thread that posts an event's last
+// outstanding part (the parent or its last sub-event) gets the event back
+// to digitize, and the sink releases it.
+namespace OpticalSubEvent {
+
+constexpr int kType = 0; // sub-event type registered with the run manager
+
+// Tag carried by routed photons (the sub-event G4Event has no vertex info).
+class PhotonTag : public G4VUserTrackInformation {
+public:
+  PhotonTag(long long key, double t0_ns) : fKey(key), fT0ns(t0_ns) {}
+  long long Key() const { return fKey; }
+  double T0ns() const { return fT0ns; }
+
+private:
+  long long fKey;
+  double fT0ns;
+};
+
+// PhotonBudget counters of photons tracked in sub-events (weighted).
+struct Budget {
+  double nProduced = 0.0;
+  double nAtWall = 0.0;
+  double nAtPMT = 0.0;
+};
+
+struct EventHits {
+  double t0_ns = 0.0;
+  std::vector<PMTHit> hits;
+  Budget budget;
+};
+
+// Main: enable with `batch` photons per sub-event (0 => off).
+void Configure(int batch);
+bool Enabled();
+int BatchSize();
+// True when compiled against a Geant4 with sub-event support.
+bool Supported();
+
+// Stacking (parent event): tag `track` and return the sub-event classification.
+G4ClassificationOfNewTrack Route(const G4Track* track, const G4Event* event);
+// Events processed as sub-events carry no primary vertex of their own.
+bool IsSubEvent(const G4Event* event);
+
+// Stacking on sub-event workers: a routed photon arrived in this sub-event.
+void Arrive(const G4Track* track);
+// PMTSD / fast models on sub-event workers.
+void AddHit(const PhotonTag& tag, const PMTHit& hit);
+// Stepping on sub-event workers: the budget of the photon's parent event in
+// this sub-event, or nullptr for an untagged photon.
+Budget* BudgetOf(const G4Track* track);
+
+// End of a sub-event: post what it collected. End of a parent event: post
+// the number of photons it routed (an event without any is complete at
+// once). Both return the events this completed, ordered by key.
+std::map<long long, EventHits> CloseSubEvent();
+std::map<long long, EventHits> CloseEvent(long long key, double t0_ns);
+// Master, end of run: events still waiting for sub-events (aborted runs).
+std::map<long long, EventHits> Drain();
+
+} // namespace OpticalSubEvent
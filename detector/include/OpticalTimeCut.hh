@@ -0,0 +1,32 @@
+#pragma once
+
+class G4Step;
+
+// Gate-aware time cut for optical photons (--gate_time_cut=1). The PMT
+// digitizer drops every sample after t0 + gate_offset_ns + gate_ns, so a
+// photon whose global time passes that point (plus a margin for TTS/jitter
+// smearing) can never become a PE; it is killed at that step instead of
+// being tracked until it is absorbed.
+//
+// To report what the cut saves, one in every kProbeEvery photons that reach
+// the cut is left alive as a probe and its remaining steps are counted; the
+// saved steps are extrapolated from the probes.
+namespace OpticalTimeCut {
+
+constexpr unsigned kProbeEvery = 100;
+
+// Main: cut at `gateEndNs` (gate_offset_ns + gate_ns) + `marginNs` after t0.
+void Configure(double gateEndNs, double marginNs);
+bool Enabled();
+double CutNs(); // relative to the event t0
+
+// Stepping action, every optical photon step. The cut is measured from the
+// event t0 (PrimaryVertexInfo, as the digitizer gate is); sub-event photons
+// use the t0 carried by their tag. Returns true if the track was killed.
+bool Apply(const G4Step* step);
+
+// Master, begin/end of run.
+void ResetCounters();
+void Report();
+
+} // namespace OpticalTimeCut
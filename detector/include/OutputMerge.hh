@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Per-worker ROOT output handling for multithreaded runs.
+// Workers write their own shard files (no shared TFile), close them at end of
+// run and register them here; the master merges them once every worker has
+// finished, so the event loop never waits on a merge.
+namespace OutputMerge {
+
+// Insert `tag` before the extension: (pmt_digi.root, ".shard3") -> pmt_digi.shard3.root.
+std::string TagPath(const std::string& path, const std::string& tag);
+
+// Worker threads get distinct shard files (pmt_digi.root -> pmt_digi.w<N>.root)
+// so no TFile is shared across threads. Returns `path` unchanged off-worker.
+std::string ShardPath(const std::string& path);
+
+// Worker side: shard `shardPath` (already closed) belongs to `mergedPath`.
+void RegisterShard(const std::string& mergedPath, const std::string& shardPath);
+
+// Master side: merge every registered shard group into its merged file,
+// write the run manifest once per merged file and remove the shards
+// (kept when FLNDR_KEEP_SHARDS=1). Subsequent runs append to the same file.
+void MergePendingShards();
+
+// Merge the `hits` trees (and `digi_events` indexes) of `shards` into
+// `outPath`, ordered by event id. With append=true existing trees in
+// `outPath` are extended.
+// Returns the number of records written; throws std::runtime_error on I/O errors.
+std::size_t MergeHitsTrees(const std::vector<std::string>& shards,
+                           const std::string& outPath,
+                           bool append);
+
+} // namespace OutputMerge
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <optional>
 
 #include <G4UserEventAction.hh>
 
+class AsyncWriter;
+class PMTHit;
+namespace OpticalSubEvent { struct EventHits; }
+
 struct PMTDigitizerConfig {
   double qe_scale = 1.0;
   double tts_sigma_ps = 150.0;
@@ -46,17 +52,42 @@ public:
   void EndOfEventAction(const G4Event*) override;
 
   static PMTDigitizerConfig LoadConfig(const std::string& path);
+  // qe_scale * max(QE) after the command-line overrides: the largest chance
+  // that any photon is detected.
+  static double PeakEfficiency(const std::string& configPath,
+                               std::optional<double> qeFlatOverride,
+                               std::optional<double> qeScaleFactor);
+  // End of the standard gate relative to t0 (gate_offset_ns + gate_ns, or
+  // the --gate_ns_override width): no sample after it is ever digitized.
+  static double GateEndNs(const std::string& configPath,
+                          std::optional<double> gateNsOverride);
+
+  // Photons were kept at birth with `keepProbability` (--qe_prethin); QE is
+  // applied conditionally, as qe_scale * QE(lambda) / keepProbability.
+  void SetPhotonKeepProbability(double keepProbability);
+
+  // Wait for queued hits to reach the tree (before anything else touches the file).
+  void FlushOutput();
+  // Worker end-of-run: close this thread's shard and hand it to OutputMerge.
+  void CloseOutput();
+
+  // Master end-of-run in sub-event mode: digitize the events OpticalSubEvent
+  // still holds (their sub-events never all reported), in event-key order.
+  void DigitizeSubEventHits();
 
 private:
-  void ensureInitialized();
+  void ensureInitialized(bool needHitsCollection = true);
   void ensureOutput();
   void cachePMTs();
   void digitizeEvent(const G4Event*);
+  void digitizeHits(long long eventKey, double t0_ns, const std::vector<const PMTHit*>& hits);
+  void digitizeSubEvents(std::map<long long, OpticalSubEvent::EventHits>& events);
   double sampleQE(double wavelength_nm) const;
   void emitFinalSummary() const;
 
   std::string configPath_;
   std::string outputPath_;
+  std::string shardPath_;
   std::optional<double> qeFlatOverride_;
   std::optional<double> qeScaleFactor_;
   std::optional<double> thresholdOverride_;
@@ -70,6 +101,7 @@ private:
   bool loggedTimingSigma_ = false;
   bool loggedEffectiveCfg_ = false;
   bool loggedGateConfig_ = false;
+  bool loggedShardPath_ = false;
   bool enableTTS_ = true;
   bool enableJitter_ = true;
   std::string gateMode_ = "standard";
@@ -81,11 +113,13 @@ private:
 
   int hitsCollectionId_ = -1;
   double sigma_ns_ = 0.0;
+  double photonKeep_ = 1.0;
 
   std::vector<int> allPmts_;
 
   struct Writer;
   Writer* writer_ = nullptr;
+  std::unique_ptr<AsyncWriter> io_; // fills writer_ off the event loop
 
   unsigned long long eventsProcessed_ = 0;
   double totalPEs_ = 0.0;
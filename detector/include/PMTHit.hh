@@ -19,6 +19,10 @@ public:
   G4double pe{0.0};
   G4double wavelength_nm{0.0};
   G4int    flags{0};
+  // Filled only with --photon_records (see PhotonRecords.hh).
+  G4double path_length{0.0};
+  G4int    n_rayleigh{0};
+  G4int    n_mie{0};
 
   void Print() override;
 };
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <CLHEP/Units/SystemOfUnits.h>
+#include <G4RotationMatrix.hh>
+#include <G4ThreeVector.hh>
+#include <G4VPVParameterisation.hh>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class G4LogicalVolume;
+class G4OpticalSurface;
+class G4VPhysicalVolume;
+
+// PMT wall layouts of the water cans DetectorConstruction builds. Copy
+// number i sits at position[i] with rotation[i], in the can frame. The
+// rotations are a small shared set: one per box face, one per phi column
+// of the tubs rings.
+struct PMTLayout {
+  std::vector<G4ThreeVector> position;
+  std::vector<const G4RotationMatrix*> rotation;
+  std::vector<std::unique_ptr<G4RotationMatrix>> rotations; // owns the shared set
+  int rings = 0;   // tubs only
+  int perRing = 0; // tubs only
+
+  std::size_t Size() const { return position.size(); }
+};
+
+// Box can faces that carry PMTs (bit mask, BoxWallLayout order).
+enum BoxFace : unsigned {
+  kBoxFacePosX = 1u << 0,
+  kBoxFaceNegX = 1u << 1,
+  kBoxFacePosY = 1u << 2,
+  kBoxFaceNegY = 1u << 3,
+  kBoxFacePosZ = 1u << 4,
+  kBoxFaceNegZ = 1u << 5,
+  kBoxSideFaces = kBoxFacePosX | kBoxFaceNegX | kBoxFacePosY | kBoxFaceNegY,
+};
+
+// Wall PMT layout knobs. The defaults are the layout DetectorConstruction
+// has always used for the GDML cans; the native builder reads them from
+// its YAML (NativeGeometry).
+struct PMTWallSpec {
+  double pmtRadius = 0.10 * CLHEP::m;
+  double wallGap = 5.0 * CLHEP::mm;   // box: wall to disc plane; tubs: wall to disc rim
+  double zPitch = 0.50 * CLHEP::m;
+  int nPhi = 48;                      // tubs: PMTs per ring
+  double xPitch = 0.375 * CLHEP::m;   // box
+  double yPitch = 0.375 * CLHEP::m;   // box
+  unsigned boxFaces = kBoxSideFaces;  // box
+};
+
+// Faces of a box can selected by `faces`, `inset` from the walls. Side
+// faces are gridded in (y|x, z), the z faces in (x, y).
+std::unique_ptr<PMTLayout> BoxWallLayout(double halfX, double halfY, double halfZ,
+                                         double zPitch, double xPitch, double yPitch, double inset,
+                                         unsigned faces = kBoxSideFaces);
+// Rings of `nPhi` PMTs facing the axis on the side of a tubs can, with the
+// disc rims `wallGap` from the wall.
+std::unique_ptr<PMTLayout> TubsWallLayout(double rOuter, double zHalf, double pmtRadius,
+                                          double zPitch, int nPhi, double wallGap = 5.0 * CLHEP::mm);
+
+// Copy number -> layout transform, for one G4PVParameterised holding every PMT.
+class PMTWallParameterisation : public G4VPVParameterisation {
+public:
+  explicit PMTWallParameterisation(const PMTLayout& layout) : fLayout(layout) {}
+  void ComputeTransformation(const G4int copyNo, G4VPhysicalVolume* pv) const override;
+
+private:
+  const PMTLayout& fLayout; // outlives the geometry (owned by the caller)
+};
+
+enum class PMTPlacement { kParameterised, kCopies };
+
+// FLNDR_PMT_PLACEMENT=param (default) | copies.
+PMTPlacement PMTPlacementFromEnv();
+const char* PMTPlacementName(PMTPlacement placement);
+
+// Put the layout into `mother` as "PMT" volumes: one G4PVParameterised
+// (kParameterised; needs `mother` to have no other daughters) or one
+// G4PVPlacement per copy (kCopies). `param` receives the parameterisation,
+// which must outlive the geometry. Returns the volumes created.
+std::vector<G4VPhysicalVolume*> PlacePMTs(const PMTLayout& layout, G4LogicalVolume* pmtLV,
+                                          G4LogicalVolume* mother, PMTPlacement placement,
+                                          std::unique_ptr<G4VPVParameterisation>& param);
+
+// How the photocathode optical surface is attached. kSkin (default): one
+// G4LogicalSkinSurface on the photocathode LV, whatever the PMT count.
+// kBorder: one G4LogicalBorderSurface water -> PMT volume per placed volume
+// (one per copy with kCopies), kept for timing comparisons.
+enum class CathodeSurface { kSkin, kBorder };
+
+// FLNDR_CATHODE_SURFACE=skin (default) | border.
+CathodeSurface CathodeSurfaceFromEnv();
+const char* CathodeSurfaceName(CathodeSurface mode);
+
+// Attach `surface` to the PMT volumes `pmts` (all of `pmtLV`, daughters of
+// `waterPV`). Returns the number of logical surfaces created.
+std::size_t AttachCathodeSurface(const std::vector<G4VPhysicalVolume*>& pmts, G4LogicalVolume* pmtLV,
+                                 G4VPhysicalVolume* waterPV, G4OpticalSurface* surface,
+                                 CathodeSurface mode);
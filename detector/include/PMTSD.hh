@@ -19,5 +19,7 @@ private:
   G4int totalHits_{0};
   G4int hitsThisEvent_{0};
   G4int currentEventId_{-1};
+  long long currentEventKey_{-1};
+  G4double currentT0ns_{0.0};
   bool attachmentsLogged_{false};
 };
@@ -11,24 +11,19 @@
 // forward decls to avoid heavy includes in the header
 class IORunAction;    // owner of ROOT file + Digitizer (set once from ActionInitialization)
 
-struct PrimaryInfo {
-  static void Set(const G4ThreeVector& x0, double t0_ns);
-  static const G4ThreeVector& X0();
-  static double T0ns();
-};
-
 class PhotonBudgetEventAction : public G4UserEventAction {
 public:
   PhotonBudgetEventAction() = default;
   void BeginOfEventAction(const G4Event*) override;
   void EndOfEventAction(const G4Event*) override;
-  // counters this event
-  unsigned long long nProduced = 0;
-  unsigned long long nAtWall   = 0;
-  unsigned long long nAtPMT    = 0;
+  // counters this event: sums of photon weights (plain counts unless --photon_weight)
+  double nProduced = 0.0;
+  double nAtWall   = 0.0;
+  double nAtPMT    = 0.0;
   double firstResidualNs = std::numeric_limits<double>::quiet_NaN();
   // --- Day-4 enriched timing/geometry (for QC)
-  double t0_ns       = 0.0;                                      // event start time we set from PrimaryInfo
+  G4ThreeVector x0;                                              // event vertex from PrimaryVertexInfo
+  double t0_ns       = 0.0;                                      // event start time from PrimaryVertexInfo
   double t_first_ns  = std::numeric_limits<double>::quiet_NaN(); // time of first qualifying hit (PMT if present, else WALL)
   double d_first_mm  = std::numeric_limits<double>::quiet_NaN(); // |x_first - x0| in mm
   double tof_geom_ns = std::numeric_limits<double>::quiet_NaN(); // n·d/c in ns (geometric)
@@ -39,6 +34,8 @@ public:
   // config
   static void SetCSVPath(const std::string& path);
   static void SetIORun(IORunAction* io); // NEW: optional hook so EndOfEvent can write ROOT hits/events
+  // Master end-of-run, sub-event mode: rows of events whose sub-events never all reported.
+  static void WritePendingRows();
 
 private:
   static std::string s_csv_path;
@@ -2,6 +2,11 @@
 #include "G4UserEventAction.hh"
 #include "G4UserStackingAction.hh"
 
+#include <atomic>
+
+class G4Event;
+class PhotonLibrary;
+
 class PhotonCountEventAction : public G4UserEventAction {
 public:
   PhotonCountEventAction() : count_(0) {}
@@ -12,13 +17,29 @@ public:
   static unsigned long long GetTotal();
 private:
   unsigned long long count_;
-  static unsigned long long total_;
+  static std::atomic<unsigned long long> total_; // summed over worker threads
 };
 
 class PhotonCountStackingAction : public G4UserStackingAction {
 public:
   explicit PhotonCountStackingAction(PhotonCountEventAction* evt) : evt_(evt) {}
   G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track) override;
+  // --lazy_cerenkov: feed the deferred photons in chunks whenever the urgent stack empties.
+  void NewStage() override;
+  void PrepareNewEvent() override;
+  // QE pre-thinning: keep each new optical photon with this probability
+  // (counted as created either way). 1 => track every photon.
+  void SetPhotonKeepProbability(double p) { keep_ = p; }
+  // Statistical weighting: of the photons that pass QE pre-thinning, keep
+  // 1/w and give the survivors weight w. 1 => unweighted.
+  void SetPhotonWeight(double w) { weight_ = w; }
 private:
+  bool Survives(const G4Track* track) const; // thinning + weighting of a new photon
+  // --photon_library: sample this photon's PMT hit (if any) into the event.
+  void DepositFromLibrary(const PhotonLibrary& library, const G4Track* track,
+                          const G4Event* event);
   PhotonCountEventAction* evt_;
+  double keep_ = 1.0;
+  double weight_ = 1.0;
+  int hcId_ = -1;
 };
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Voxelized photon-detection library: for every (voxel, direction bin,
+// wavelength bin) cell, the probability that a photon emitted there reaches
+// each PMT's photocathode and the mean/RMS of its arrival time. Built by
+// flndr_buildlib with the optical photon gun; flndr --photon_library=<file>
+// then samples PMT hits from it instead of tracking optical photons.
+//
+// The file is the in-memory layout (header, CSR cell offsets, entries) and is
+// mapped read-only, so every job on a node shares one copy in the page cache.
+class PhotonLibrary {
+public:
+  struct Header {
+    char magic[8];                 // "FLNDRPL1"
+    std::uint32_t version;
+    std::uint32_t nPMT;            // PMTs in the geometry that built it (informational)
+    std::int32_t nVoxel[3];        // x, y, z
+    std::int32_t nCosTheta;        // direction: cos(theta) in [-1, 1] ...
+    std::int32_t nPhi;             // ... and phi in [-pi, pi), about +z
+    std::int32_t nLambda;          // wavelength bins in [lambdaMin, lambdaMax)
+    double lo[3];                  // voxel grid bounds [mm]
+    double hi[3];
+    double lambdaMin;              // [nm]
+    double lambdaMax;
+    std::uint64_t photonsPerCell;  // gun photons behind each probability
+    std::uint64_t nCells;
+    std::uint64_t nEntries;
+  };
+  struct Entry {
+    std::int32_t pmt;
+    float prob;                    // P(photocathode hit on this PMT | photon in cell)
+    float tMeanNs;                 // arrival time after emission
+    float tRmsNs;
+  };
+  static constexpr std::uint32_t kVersion = 1;
+
+  ~PhotonLibrary();
+  PhotonLibrary(const PhotonLibrary&) = delete;
+  PhotonLibrary& operator=(const PhotonLibrary&) = delete;
+
+  // Map `path`; throws std::runtime_error if it is missing or malformed.
+  static std::unique_ptr<PhotonLibrary> Open(const std::string& path);
+  // flndr_buildlib: write a library; `offsets` has nCells + 1 elements.
+  static void Write(const std::string& path, Header header,
+                    const std::vector<std::uint64_t>& offsets,
+                    const std::vector<Entry>& entries);
+
+  // Process-wide library used by the fast optical mode (nullptr => off).
+  static void SetShared(std::unique_ptr<PhotonLibrary> library);
+  static const PhotonLibrary* Shared();
+
+  const Header& Info() const { return *fHeader; }
+  const std::string& Path() const { return fPath; }
+
+  // Cell of a photon at (x, y, z) [mm] with unit direction (dx, dy, dz) and
+  // wavelength [nm]; -1 outside the voxel grid. Wavelengths are clamped.
+  std::int64_t Cell(double x, double y, double z,
+                    double dx, double dy, double dz, double lambda_nm) const;
+  // Entries of `cell`, ordered by PMT.
+  const Entry* Begin(std::int64_t cell) const { return fEntries + fOffsets[cell]; }
+  const Entry* End(std::int64_t cell) const { return fEntries + fOffsets[cell + 1]; }
+
+private:
+  PhotonLibrary() = default;
+
+  std::string fPath;
+  void* fMap = nullptr;
+  std::size_t fMapSize = 0;
+  const Header* fHeader = nullptr;
+  const std::uint64_t* fOffsets = nullptr;
+  const Entry* fEntries = nullptr;
+};
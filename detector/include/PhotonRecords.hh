@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+
+class G4Step;
+class PMTHit;
+
+// Per-photon detection records for water-model reweighting
+// (--photon_records=<file.csv>). Every photocathode hit is written with its
+// wavelength, arrival time after t0, weight, total path length and the
+// number of Rayleigh and Mie scatters on the way. Because the path is
+// stored, tools/qc/optics_reweight.py can give every detected photon its
+// probability ratio under another ABSLENGTH(lambda)/RAYLEIGH(lambda) table:
+// one run then yields PE and timing for many water models.
+//
+// Paths are taken as water paths: the PMTs sit directly in the can, so that
+// holds unless a photon leaves the can and comes back.
+namespace PhotonRecords {
+
+// Main: write records to `csvPath` (truncated, header first).
+void Configure(const std::string& csvPath);
+bool Enabled();
+const std::string& Path();
+
+// Stepping action, every optical photon step: count Rayleigh/Mie scatters.
+void CountScatter(const G4Step* step);
+// Fill the hit's scatter counts from the track's tally so far.
+void FillScatters(int trackId, PMTHit& hit);
+
+// PMTSD / fast models: queue one detected photon of event `key` on this
+// thread. PMTSD::EndOfEvent writes the queue.
+void Add(long long key, double t0_ns, const PMTHit& hit);
+void Flush();
+
+// Master, begin/end of run.
+void ResetCounters();
+void Report();
+
+} // namespace PhotonRecords
@@ -12,6 +12,7 @@ struct OpticalProcessConfig {
   bool enableBoundary  = true;
   int  maxPhotonsPerStep = 300;
   double maxBetaChangePerStep = 10.0;
+  bool fastDirectLight = false;  // day2fast: fast simulation for optical photons
 };
 
 class PhysicsList : public FTFP_BERT {
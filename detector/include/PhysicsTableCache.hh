@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+
+class G4VUserPhysicsList;
+
+// Cached physics tables (--physics_cache=<dir>, FLNDR_PHYSICS_CACHE). The
+// tables FTFP_BERT + G4OpticalPhysics build at the first run initialisation
+// are written with G4VUserPhysicsList::StorePhysicsTable to <dir>/<key> at
+// the end of the first run of a process that had to build them. Later
+// processes with the same key read them back (SetPhysicsTableRetrieved).
+// The key hashes the physics list and its optical process switches, the
+// production cut, the Geant4 version and the contents of the optics and
+// geometry files (materials and their property tables). An entry is
+// published by renaming a complete temporary directory, so concurrent QC
+// jobs never read a partial one. Geant4 still rebuilds any table whose
+// stored cuts or materials do not match the current ones.
+//
+// The startup timer runs with or without a cache. It times the run
+// manager's Init phases: /run/initialize (geometry and physics
+// construction), then the first BeamOn (physics tables and geometry
+// closing). The [STARTUP] line at the start of the first run reports them.
+namespace PhysicsTableCache {
+
+// Main, first thing: start the clock and watch the run manager state.
+void StartTimer();
+
+// Hex FNV-1a hash of `text`, for building keys.
+std::string Hash(const std::string& text);
+
+// Main, after the physics list and its cuts are set: use entry Hash(key)
+// under `root`, and retrieve from it if a complete entry exists.
+void Configure(const std::string& root, const std::string& key, G4VUserPhysicsList* physicsList);
+bool Enabled();
+bool Retrieved();
+const std::string& Directory();
+
+// Master, start of the first run: print the startup phase times.
+void ReportStartup();
+// Master, end of run: store the tables if this process built them.
+void StoreIfMissing();
+
+} // namespace PhysicsTableCache
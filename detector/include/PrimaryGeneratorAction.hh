@@ -24,8 +24,10 @@ public:
 private:
   RootrackerPrimaryGenerator* EnsureRootracker();
   void AnnounceModeOnce();
+  void GenerateFromSegments(G4Event* event);
   void AimAtPMTCommand(const G4String& args);
-  void AimAtPMT(int id, double offset_mm, double energy_eV, int count);
+  void AimAtPMT(int id, double offset_mm, double energy_eV, int count, double tilt_deg = 0.0,
+                bool fromWater = false);
   void SetPhotonGunCount(int count);
 
   G4String fRootFile;
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <G4ThreeVector.hh>
+#include <G4VUserEventInformation.hh>
+
+class G4Event;
+
+// Event-scoped primary vertex (position, start time, source entry).
+// Filled by the primary generators and read back from the G4Event by the
+// digitizers and stepping actions, so concurrent events never share state.
+class PrimaryVertexInfo : public G4VUserEventInformation {
+public:
+  PrimaryVertexInfo(const G4ThreeVector& x0, double t0_ns, long long entry = -1)
+    : fX0(x0), fT0ns(t0_ns), fEntry(entry) {}
+  ~PrimaryVertexInfo() override = default;
+
+  void Print() const override;
+
+  const G4ThreeVector& X0() const { return fX0; }
+  double T0ns() const { return fT0ns; }
+  long long Entry() const { return fEntry; } // rootracker entry, -1 for gun events
+
+  // Attach (or overwrite) the vertex record on an event being generated.
+  static void Attach(G4Event* event, const G4ThreeVector& x0, double t0_ns, long long entry = -1);
+  static const PrimaryVertexInfo* Find(const G4Event* event);
+  // Convenience accessors: origin / t0=0 when the event carries no record.
+  static G4ThreeVector X0Of(const G4Event* event);
+  static double T0nsOf(const G4Event* event);
+  // Stable event key for outputs and seeding: the rootracker entry when known,
+  // otherwise the G4 event id (independent of which worker ran the event).
+  static long long KeyOf(const G4Event* event);
+
+private:
+  G4ThreeVector fX0;
+  double fT0ns = 0.0;
+  long long fEntry = -1;
+};
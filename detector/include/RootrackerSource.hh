@@ -0,0 +1,111 @@
+#pragma once
+
+#include "BoundedQueue.hh"
+
+#include <G4String.hh>
+#include <G4Types.hh>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class G4GenericMessenger;
+class TFile;
+class TTree;
+
+// Compact, already-decoded primary of one G4_ROOTRACKER entry.
+struct RootrackerPrimary {
+  long long entry = -1;
+  int    pdg = 0;          // 0 => no suitable final state in this entry
+  double p4_MeV[4]{};      // px, py, pz, E
+  double vtx_mm_ns[4]{};   // x, y, z (before z shift) [mm], t [ns]
+};
+
+// Process-wide G4_ROOTRACKER reader shared by every worker's generator.
+// One file handle; a prefetch thread decodes entries in order into a bounded
+// lock-free queue, and workers claim records from it, so each entry is
+// simulated exactly once and no worker waits on ROOT decompression.
+// Owned by ActionInitialization on the master and steered by /rootracker/
+// commands there; the file is opened lazily on the first claim.
+class RootrackerSource {
+public:
+  RootrackerSource(const G4String& fileName, G4double zShiftMM);
+  ~RootrackerSource();
+
+  // The master-owned instance workers claim from (nullptr if none exists).
+  static RootrackerSource* Shared();
+
+  // Worker: claim the next decoded entry; false once the tree is exhausted.
+  bool Claim(RootrackerPrimary& out);
+
+  // Master, between runs: stop prefetching and rewind the cursor to the first
+  // entry not handed out yet (or to `entry` via SetNextEntry).
+  void Stop();
+  void SetNextEntry(long long entry);
+  long long NextEntry() const { return fNextEntry.load(); }
+
+  G4double ZShiftMM() const { return fZShiftMM.load(); }
+  void SetZShiftMM(G4double dz) { fZShiftMM.store(dz); }
+  void SetPrefetchDepth(G4int depth);
+
+  long long Claimed() const { return fClaimed.load(); }
+
+  // Restrict the run to a slice of the tree (batch sharding). Either an
+  // explicit [first, first+count) range (count<0 => to the end) or shard
+  // `index` of `count` equal slices; resolved once the entry count is known.
+  void SetEntryRange(long long first, long long count);
+  void SetShard(int index, int count);
+  // Resolved slice [RangeBegin, RangeEnd); opens the tree if needed.
+  long long RangeBegin();
+  long long RangeEnd();
+
+private:
+  bool OpenTree();
+  void ResolveRangeLocked();
+  void StartLocked();
+  void ProducerLoop(long long first);
+  bool Decode(long long entry, RootrackerPrimary& out);
+  void SetEventIndexCmd(G4int entry) { SetNextEntry(entry); }
+
+  std::mutex fControlMutex; // Configure/Start/Stop
+  G4String fFileName;
+  std::unique_ptr<TFile> fFile;
+  TTree* fTree = nullptr;
+  long long fEntries = 0;
+  bool fHasStatus = false;
+
+  // Slice requested on the command line; fRangeEnd<0 => end of tree.
+  long long fRangeBegin = 0;
+  long long fRangeEnd = -1;
+  long long fRangeCount = -1;
+  int fShardIndex = -1;
+  int fShardCount = 0;
+  bool fRangeResolved = false;
+
+  // Branch buffers (typical ROOTRACKER names); only the producer touches them.
+  static constexpr int kMAX = 10000;
+  double EvtVtx[4]{};
+  int    StdHepN = 0;
+  int    StdHepPdg[kMAX];
+  int    StdHepStatus[kMAX];
+  double StdHepP4[kMAX][4];
+
+  std::unique_ptr<BoundedQueue<RootrackerPrimary>> fQueue;
+  std::size_t fDepth = 256;
+  // Sleep/wake only; the queue stays lock-free. Signallers change the state,
+  // then take the mutex before notifying, so no wakeup is lost.
+  std::mutex fWaitMutex;
+  std::condition_variable fNotEmpty; // workers: a record was pushed, or the producer is done
+  std::condition_variable fNotFull;  // producer: a record was claimed, or stop
+  std::thread fProducer;
+  std::atomic<bool> fRunning{false};
+  std::atomic<bool> fStopRequested{false};
+  std::atomic<bool> fProducerDone{false};
+  std::atomic<long long> fNextEntry{0};  // first entry not yet handed to a worker
+  std::atomic<long long> fClaimed{0};
+  std::atomic<G4double> fZShiftMM{0.0};
+
+  std::unique_ptr<G4GenericMessenger> fMsg;
+};
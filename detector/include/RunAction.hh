@@ -2,6 +2,8 @@
 
 #include <G4UserRunAction.hh>
 
+class PMTDigitizer;
+
 class RunAction : public G4UserRunAction {
 public:
   RunAction();
@@ -9,4 +11,11 @@ public:
 
   void BeginOfRunAction(const G4Run* run) override;
   void EndOfRunAction(const G4Run* run) override;
+
+  // Digitizer bound to this thread (not owned): workers close its shard at end
+  // of run; in sub-event mode the master's one digitizes the merged hits.
+  void SetDigitizer(PMTDigitizer* digitizer) { fDigitizer = digitizer; }
+
+private:
+  PMTDigitizer* fDigitizer = nullptr;
 };
@@ -21,6 +21,9 @@ class TFile;
 struct RunManifest {
   std::string profile;
   std::string macro;
+  std::string geometrySource = "gdml";  // gdml | native (--geometry)
+  std::string geometryPath;             // G4_GDML file or native geometry YAML
+  std::string geometryContents;         // native YAML only
   std::string opticsPath;
   std::string opticsContents;
   std::string pmtPath;
@@ -36,13 +39,45 @@ struct RunManifest {
   bool quiet = false;
   int  opticalVerboseLevel = 0;
   int  summaryEvery = 0;
+  int  threads = 1;
+  unsigned long long seed = 0;   // 0 => engine default
+  bool eventSeeding = false;     // per-event seeds from (seed, entry)
+  int  subEventPhotons = 0;      // optical photons per sub-event (0 => off)
+  int  digiThreads = 1;          // TaskPool lanes for per-PMT digitization
+  int  shardIndex = -1;          // --shard=i/N (-1 => not sharded)
+  int  shardCount = 0;
+  long long entryFirst = -1;     // rootracker entries processed: [first, end)
+  long long entryEnd = -1;
   double qeScaleOverride = std::numeric_limits<double>::quiet_NaN();
   double qeFlatOverride = std::numeric_limits<double>::quiet_NaN();
+  bool qePrethin = false;               // optical photons thinned by peak QE at birth
+  double photonKeepProbability = 1.0;
+  double photonWeight = 1.0;            // optical photon statistical weight (1 => off)
+  std::string photonLibrary;            // fast optical mode library (empty => tracking)
+  int  lazyCerenkovChunk = 0;     // deferred Cerenkov photons per chunk (0 => G4Cerenkov)
+  std::string segmentsOut;              // stage-1 segment file (empty => not written)
+  std::string segmentsIn;               // stage-2 segment file being replayed
+  std::string photonRecords;            // per-photon reweighting CSV (empty => off)
+  int  rouletteReflections = 0;   // optical roulette every K reflections (0 => off)
+  double rouletteDistanceM = 0.0; // ... and/or every X metres (0 => off)
+  double rouletteSurvival = 1.0;  // survival probability per round
+  std::string opticalBackend = "geant4"; // geant4 | batch
+  std::string pmtMode = "volume";       // volume | surface (SurfaceHits aperture map)
+  std::string pmtPlacement = "param";   // param | copies (FLNDR_PMT_PLACEMENT)
+  std::string cathodeSurface = "skin";  // skin | border (FLNDR_CATHODE_SURFACE)
+  std::string physicsCache;             // physics table cache entry (empty => off)
+  bool physicsTablesRetrieved = false;  // tables read from physicsCache
+  bool directLight = false;             // day2fast analytic direct light
+  double fastIndirectFraction = 0.0;    // photons still tracked for indirect light
+  double gateTimeCutNs = std::numeric_limits<double>::quiet_NaN(); // optical time cut after t0 (NaN => off)
   double thresholdPEOverride = std::numeric_limits<double>::quiet_NaN();
 };
 
 void SetRunManifest(RunManifest manifest);
+// Master, end of run: record the rootracker entry slice actually processed.
+void SetManifestEntryRange(long long first, long long end);
 const RunManifest& GetRunManifest();
+// Output files are tracked per thread: each worker flushes only the files it opened.
 void RegisterOutputFile(TFile* file);
 void WriteManifestToFile(TFile* file, const std::string& objectName = "run_manifest");
 void FlushManifestToOutputs();
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <G4ThreeVector.hh>
+
+#include <vector>
+
+class G4LogicalVolume;
+
+// Surface-hit PMT mode (--pmt_mode=surface). The photocathode discs are not
+// placed as daughters of the water can, so the navigator has no PMT volumes
+// to voxelize or test on each step. PMTSD sits on the water LV and only acts
+// on optical steps that start or end on the can border; the straight
+// segment of such a step is resolved against an analytic aperture map built
+// from the PMT registry. Each wall face (box: +-x, +-y, +-z; tubs: the side
+// as a (phi, z) grid, and the endcaps) has a grid of disc-sized cells that
+// list the discs near them. Only the part of the segment within the shell
+// of wall that holds the discs is walked, and only the listed discs are
+// tested exactly. The cost of a wall crossing therefore does not depend on
+// the PMT count. Copy numbers and positions match the volume layout.
+//
+// The map is also built for the direct-light model and the batch tracer,
+// which use Candidates() to cull the discs a ray can reach.
+//
+// Not modelled: refraction into the photocathode material, and a photon
+// that crosses a disc and is then scattered or absorbed before it reaches
+// the wall (discs sit within a few cm of the wall).
+namespace SurfaceHits {
+
+// Main, before the detector is built.
+void Configure();
+bool Enabled();
+
+// DetectorConstruction, after the PMT registry is frozen: snapshot the can
+// (placed at `canOffset` in the world, unrotated) and build the aperture
+// map. Returns false if the can shape is unsupported.
+bool Build(const G4LogicalVolume* canLV, const G4ThreeVector& canOffset, double cathodeRadius);
+bool Ready();
+
+// PMTSD: copy number of the first disc the segment pre -> post (world
+// coordinates) crosses, or -1. `fraction` is where along the segment it
+// crosses, in [0, 1].
+int Find(const G4ThreeVector& pre, const G4ThreeVector& post, double& fraction);
+
+// DirectLight, BatchOptics: slots (indices into the frozen PMT table) of the
+// discs listed along the segment from `a` over `length` along unit `dir`, in
+// can coordinates, each once. Every disc the segment crosses is among them.
+void Candidates(const G4ThreeVector& a, const G4ThreeVector& dir, double length, std::vector<int>& slots);
+// Distance from `a` inside the can to its wall along unit `dir`, in can
+// coordinates.
+double ExitDistance(const G4ThreeVector& a, const G4ThreeVector& dir);
+
+// Master, begin/end of run.
+void ResetCounters();
+void Report();
+
+} // namespace SurfaceHits
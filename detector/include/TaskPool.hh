@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Process-wide helper threads for data-parallel loops inside one event
+// (e.g. per-PMT digitization of very large hit collections). Several G4
+// workers may call ParallelFor at once; the caller always runs iterations
+// itself, so a call makes progress even when every helper is busy.
+namespace TaskPool {
+
+// Total lanes per loop, including the caller. <= 1 runs loops inline.
+// Call before the first ParallelFor (main, before the run starts).
+void Configure(int lanes);
+int Lanes();
+
+// Run fn(i) for i in [0, n), in any order and on any lane; returns once all
+// have finished and rethrows the first exception thrown by fn.
+void ParallelFor(std::size_t n, const std::function<void(std::size_t)>& fn);
+
+} // namespace TaskPool
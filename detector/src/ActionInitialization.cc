@@ -5,28 +5,79 @@
 #include "PhotonCountActions.hh"
 #include "PhotonBudget.hh"
 #include "IO.hh"
+#include "OpticalSubEvent.hh"
+#include "OutputMerge.hh"
 #include "PMTDigitizer.hh"
+#include "RootrackerSource.hh"
 #include "G4OpticalParameters.hh"   // for FAST_MODE toggle (optional)
 
+#include <algorithm>
 #include <cstdlib>
 #include <utility>
 
 ActionInitialization::ActionInitialization(const G4String& rfile,
                                            double zshift,
                                            RunProfileConfig profile)
-: fRootFile(rfile), fZshift(zshift), fProfile(std::move(profile)) {}
+: fRootFile(rfile), fZshift(zshift), fProfile(std::move(profile)) {
+  if (!fRootFile.empty()) {
+    fSource = std::make_unique<RootrackerSource>(fRootFile, fZshift);
+    if (fProfile.shardCount > 0) {
+      fSource->SetShard(fProfile.shardIndex, fProfile.shardCount);
+    } else if (fProfile.firstEntry >= 0 || fProfile.nEntries >= 0) {
+      fSource->SetEntryRange(std::max(0LL, fProfile.firstEntry), fProfile.nEntries);
+    }
+  }
+}
+
+ActionInitialization::~ActionInitialization() = default;
+
+PMTDigitizer* ActionInitialization::MakeDigitizer() const {
+  std::string digiCfg = fProfile.pmtConfigPath.empty()
+                          ? "detector/config/pmt.yaml"
+                          : fProfile.pmtConfigPath;
+  std::string digiOut = OutputMerge::TagPath(fProfile.pmtOutputPath.empty()
+                                               ? "docs/day4/pmt_digi.root"
+                                               : fProfile.pmtOutputPath,
+                                             fProfile.outputTag);
+  auto* digitizer = new PMTDigitizer(digiCfg, digiOut,
+                                     fProfile.qeFlatOverride,
+                                     fProfile.qeScaleFactor,
+                                     fProfile.thresholdOverride,
+                                     fProfile.enableTTS,
+                                     fProfile.enableJitter,
+                                     fProfile.gateMode,
+                                     fProfile.gateNsOverride);
+  if (fProfile.qePrethin) digitizer->SetPhotonKeepProbability(fProfile.photonKeepProbability);
+  return digitizer;
+}
+
+void ActionInitialization::BuildForMaster() const {
+  // Master only sees run boundaries (manifest echo + totals); events live on workers.
+  auto* runAction = new RunAction();
+  SetUserAction(runAction);
+  if (fProfile.enableDigitizer && OpticalSubEvent::Enabled()) {
+    // Workers digitize events as their last sub-event ends; the master only
+    // picks up events still incomplete at end of run.
+    fMasterDigitizer.reset(MakeDigitizer());
+    runAction->SetDigitizer(fMasterDigitizer.get());
+  }
+}
 
- void ActionInitialization::Build() const {
+void ActionInitialization::Build() const {
   // Primary generator (supports rootracker or particle gun)
   SetUserAction(new PrimaryGeneratorAction(fRootFile, fZshift));
 
   // Run-level accounting
-  SetUserAction(new RunAction());
+  auto* runAction = new RunAction();
+  SetUserAction(runAction);
 
   // --- Day-2: photon counting baseline
   auto* pcEvt = new PhotonCountEventAction();
   SetUserAction(pcEvt);
-  SetUserAction(new PhotonCountStackingAction(pcEvt));
+  auto* pcStack = new PhotonCountStackingAction(pcEvt);
+  if (fProfile.qePrethin) pcStack->SetPhotonKeepProbability(fProfile.photonKeepProbability);
+  pcStack->SetPhotonWeight(fProfile.photonWeight);
+  SetUserAction(pcStack);
 
   if (std::getenv("FAST_MODE")) {
   auto* op = G4OpticalParameters::Instance();
@@ -39,24 +90,14 @@ ActionInitialization::ActionInitialization(const G4String& rfile,
 
   // Day-3 budget counters + CSV
   auto* budgetEvt = new PhotonBudgetEventAction();
-  budgetEvt->SetCSVPath("docs/day3/event_budget.csv"); // ensure docs/day3 exists
+  budgetEvt->SetCSVPath(OutputMerge::TagPath("docs/day3/event_budget.csv",
+                                             fProfile.outputTag)); // ensure docs/day3 exists
   SetUserAction(budgetEvt);
   SetUserAction(new PhotonBudgetSteppingAction(budgetEvt, "PMT"));
 
   if (fProfile.enableDigitizer) {
-    std::string digiCfg = fProfile.pmtConfigPath.empty()
-                            ? "detector/config/pmt.yaml"
-                            : fProfile.pmtConfigPath;
-    std::string digiOut = fProfile.pmtOutputPath.empty()
-                            ? "docs/day4/pmt_digi.root"
-                            : fProfile.pmtOutputPath;
-    SetUserAction(new PMTDigitizer(digiCfg, digiOut,
-                                   fProfile.qeFlatOverride,
-                                   fProfile.qeScaleFactor,
-                                   fProfile.thresholdOverride,
-                                   fProfile.enableTTS,
-                                   fProfile.enableJitter,
-                                   fProfile.gateMode,
-                                   fProfile.gateNsOverride));
+    auto* digitizer = MakeDigitizer();
+    SetUserAction(digitizer);
+    runAction->SetDigitizer(digitizer);
   }
 }
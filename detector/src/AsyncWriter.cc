@@ -0,0 +1,63 @@
+#include "AsyncWriter.hh"
+
+#include <optional>
+#include <utility>
+
+AsyncWriter::AsyncWriter(std::size_t depth)
+: fQueue(depth), fThread(&AsyncWriter::Loop, this) {}
+
+AsyncWriter::~AsyncWriter() {
+  {
+    std::lock_guard<std::mutex> lock(fWakeMutex);
+    fStop.store(true);
+  }
+  fWake.notify_one();
+  if (fThread.joinable()) fThread.join();
+}
+
+void AsyncWriter::Submit(Job job) {
+  fSubmitted.fetch_add(1, std::memory_order_relaxed);
+  // TryPush only moves from `job` when it succeeds.
+  if (!fQueue.TryPush(std::move(job))) {
+    // Full: the I/O thread is behind; wait for it to pop rather than grow without bound.
+    std::unique_lock<std::mutex> lock(fWakeMutex);
+    fNotFull.wait(lock, [&] { return fQueue.TryPush(std::move(job)); });
+  }
+  { std::lock_guard<std::mutex> lock(fWakeMutex); }
+  fWake.notify_one();
+}
+
+void AsyncWriter::Flush() {
+  const std::uint64_t target = fSubmitted.load(std::memory_order_relaxed);
+  {
+    std::unique_lock<std::mutex> lock(fWakeMutex);
+    fDrained.wait(lock, [&] { return fDone.load(std::memory_order_acquire) >= target; });
+  }
+  if (fError) {
+    auto err = fError;
+    fError = nullptr;
+    std::rethrow_exception(err);
+  }
+}
+
+void AsyncWriter::Loop() {
+  for (;;) {
+    std::optional<Job> job = fQueue.TryPop();
+    if (!job) {
+      // Stop only once the queue is drained, so a destructor never drops records.
+      std::unique_lock<std::mutex> lock(fWakeMutex);
+      fWake.wait(lock, [&] { return (job = fQueue.TryPop()) || fStop.load(); });
+      if (!job) return;
+    }
+    { std::lock_guard<std::mutex> lock(fWakeMutex); }
+    fNotFull.notify_one();
+    try {
+      (*job)();
+    } catch (...) {
+      if (!fError) fError = std::current_exception();
+    }
+    fDone.fetch_add(1, std::memory_order_release);
+    { std::lock_guard<std::mutex> lock(fWakeMutex); }
+    fDrained.notify_one();
+  }
+}
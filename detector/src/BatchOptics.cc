@@ -0,0 +1,493 @@
+#include "BatchOptics.hh"
+
+#include "GeometryRegistry.hh"
+#include "SurfaceHits.hh"
+
+#include <G4Box.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4OpticalParameters.hh>
+#include <G4OpticalSurface.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4Track.hh>
+#include <G4Tubs.hh>
+#include <G4ios.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+constexpr int kTableBins = 256;
+constexpr int kMaxPasses = 100000; // guards against lossless walls
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// Shared, read-only once Build() returns.
+struct Geometry {
+  bool tubs = false;
+  double hx = 0.0, hy = 0.0, hz = 0.0; // box half lengths; tubs uses r and hz
+  double r = 0.0;
+  G4ThreeVector offset;                 // can origin in the world
+
+  std::vector<int> id;                  // PMT discs (structure of arrays)
+  std::vector<double> px, py, pz, nx, ny, nz;
+  double discR2 = 0.0;
+
+  // Uniform photon-energy grid.
+  double eMin = 0.0, eStep = 1.0;
+  std::vector<double> invAbs, invScat, groupVel, rindex, wallRefl;
+  bool lambertian = true; // ground wall finish
+  bool fresnel = false;   // dielectric_dielectric wall: Fresnel to the world (n = 1)
+};
+
+bool gEnabled = false;
+bool gReady = false;
+Geometry gGeom;
+
+std::atomic<unsigned long long> gPhotons{0};
+std::atomic<unsigned long long> gSteps{0};
+std::atomic<unsigned long long> gHits{0};
+std::atomic<unsigned long long> gTruncated{0};
+std::atomic<long long> gTraceNs{0};
+
+// Queued photons, structure of arrays. Per-photon optical constants are
+// looked up once at enqueue time.
+struct Batch {
+  std::vector<double> x, y, z, dx, dy, dz, t, w;
+  std::vector<double> invAbs, invScat, vg, n, refl, lambda;
+
+  std::size_t Size() const { return x.size(); }
+
+  void Push(const G4ThreeVector& pos, const G4ThreeVector& dir, double time, double weight,
+            double ia, double is, double v, double rin, double rw, double lam) {
+    x.push_back(pos.x()); y.push_back(pos.y()); z.push_back(pos.z());
+    dx.push_back(dir.x()); dy.push_back(dir.y()); dz.push_back(dir.z());
+    t.push_back(time); w.push_back(weight);
+    invAbs.push_back(ia); invScat.push_back(is); vg.push_back(v);
+    n.push_back(rin); refl.push_back(rw); lambda.push_back(lam);
+  }
+
+  void Move(std::size_t from, std::size_t to) {
+    x[to] = x[from]; y[to] = y[from]; z[to] = z[from];
+    dx[to] = dx[from]; dy[to] = dy[from]; dz[to] = dz[from];
+    t[to] = t[from]; w[to] = w[from];
+    invAbs[to] = invAbs[from]; invScat[to] = invScat[from]; vg[to] = vg[from];
+    n[to] = n[from]; refl[to] = refl[from]; lambda[to] = lambda[from];
+  }
+
+  void Resize(std::size_t size) {
+    for (auto* v : {&x, &y, &z, &dx, &dy, &dz, &t, &w, &invAbs, &invScat, &vg, &n, &refl, &lambda}) {
+      v->resize(size);
+    }
+  }
+};
+
+// (photon, candidate disc) pairs of one pass, structure of arrays: the
+// photon's position and direction next to the disc's center and normal.
+struct Pairs {
+  std::vector<double> x, y, z, dx, dy, dz, px, py, pz, nx, ny, nz, dist;
+  std::vector<int> slot;
+
+  std::size_t Size() const { return slot.size(); }
+
+  void Push(const Batch& b, std::size_t i, const Geometry& g, int k) {
+    x.push_back(b.x[i]); y.push_back(b.y[i]); z.push_back(b.z[i]);
+    dx.push_back(b.dx[i]); dy.push_back(b.dy[i]); dz.push_back(b.dz[i]);
+    px.push_back(g.px[k]); py.push_back(g.py[k]); pz.push_back(g.pz[k]);
+    nx.push_back(g.nx[k]); ny.push_back(g.ny[k]); nz.push_back(g.nz[k]);
+    slot.push_back(k);
+  }
+
+  void Clear() {
+    for (auto* v : {&x, &y, &z, &dx, &dy, &dz, &px, &py, &pz, &nx, &ny, &nz, &dist}) v->clear();
+    slot.clear();
+  }
+};
+
+// Per-pass scratch, reused across events on a thread.
+struct Scratch {
+  std::vector<double> u0, u1, sInt, step;
+  std::vector<int> face, slot;
+  std::vector<std::size_t> first; // photon -> its first pair (size n + 1)
+  std::vector<int> candidates;
+  Pairs pairs;
+
+  void Resize(std::size_t size) {
+    u0.resize(size); u1.resize(size); sInt.resize(size); step.resize(size);
+    face.resize(size); slot.resize(size); first.resize(size + 1);
+  }
+};
+
+thread_local Batch tQueue;
+thread_local Scratch tScratch;
+
+double Lookup(const std::vector<double>& table, double energy) {
+  const double f = std::clamp((energy - gGeom.eMin) / gGeom.eStep, 0.0, double(kTableBins - 1));
+  const int i = std::min(static_cast<int>(f), kTableBins - 2);
+  const double frac = f - i;
+  return table[i] + frac * (table[i + 1] - table[i]);
+}
+
+// Unit vector at polar cosine `c` and azimuth `phi` around `axis`.
+G4ThreeVector AroundAxis(const G4ThreeVector& axis, double c, double phi) {
+  const G4ThreeVector a = axis.orthogonal().unit();
+  const G4ThreeVector b = axis.cross(a);
+  const double s = std::sqrt(std::max(0.0, 1.0 - c * c));
+  return (c * axis + s * (std::cos(phi) * a + std::sin(phi) * b)).unit();
+}
+
+// cos(theta) with density (1 + c^2) on [-1, 1], by inverting the CDF.
+double SampleRayleighCos(double u) {
+  const double a = 4.0 * u - 2.0;
+  const double root = std::sqrt(a * a + 1.0);
+  return std::clamp(std::cbrt(a + root) + std::cbrt(a - root), -1.0, 1.0);
+}
+
+// Unpolarized Fresnel reflectance from water (n1) into the world (n = 1);
+// `cosIn` > 0 is the cosine to the surface normal.
+double FresnelReflectance(double n1, double cosIn) {
+  const double sinOut = n1 * std::sqrt(std::max(0.0, 1.0 - cosIn * cosIn));
+  if (sinOut >= 1.0) return 1.0; // total internal reflection
+  const double cosOut = std::sqrt(1.0 - sinOut * sinOut);
+  const double rs = (n1 * cosIn - cosOut) / (n1 * cosIn + cosOut);
+  const double rp = (n1 * cosOut - cosIn) / (n1 * cosOut + cosIn);
+  return 0.5 * (rs * rs + rp * rp);
+}
+
+// Inward wall normal at `pos` for the face index set by the wall-distance loop.
+G4ThreeVector InwardNormal(int face, const G4ThreeVector& pos, const G4ThreeVector& dir) {
+  const auto& g = gGeom;
+  if (g.tubs && face == 0) {
+    const double rho = std::hypot(pos.x(), pos.y());
+    return rho > 0.0 ? G4ThreeVector(-pos.x() / rho, -pos.y() / rho, 0.0) : -dir;
+  }
+  G4ThreeVector normal;
+  normal[face] = dir[face] > 0.0 ? -1.0 : 1.0;
+  return normal;
+}
+
+// SoA kernels. Each takes its arrays as __restrict parameters (restrict
+// locals are not used for alias analysis) and has only selects in its body,
+// so the compiler vectorizes it without runtime alias checks. The guarded
+// divides if-convert because this file is built with -fno-trapping-math.
+
+// Distance to the next bulk interaction; `expo` holds unit exponential deviates.
+void InteractionLengths(std::size_t n, const double* __restrict ia, const double* __restrict is,
+                        const double* __restrict expo, double* __restrict sInt) {
+  for (std::size_t i = 0; i < n; ++i) {
+    const double mu = ia[i] + is[i];
+    sInt[i] = mu > 0.0 ? expo[i] / mu : kInf;
+  }
+}
+
+// Step to the interaction or the box wall, whichever is nearer; `face` is the
+// wall axis (0, 1, 2), or -1 for an interaction.
+void WallStepsBox(std::size_t n, double hx, double hy, double hz,
+                  const double* __restrict x, const double* __restrict y, const double* __restrict z,
+                  const double* __restrict dx, const double* __restrict dy, const double* __restrict dz,
+                  const double* __restrict sInt, double* __restrict step, int* __restrict face) {
+  for (std::size_t i = 0; i < n; ++i) {
+    const double tx = dx[i] != 0.0 ? ((dx[i] > 0.0 ? hx : -hx) - x[i]) / dx[i] : kInf;
+    const double ty = dy[i] != 0.0 ? ((dy[i] > 0.0 ? hy : -hy) - y[i]) / dy[i] : kInf;
+    const double tz = dz[i] != 0.0 ? ((dz[i] > 0.0 ? hz : -hz) - z[i]) / dz[i] : kInf;
+    const double txy = std::min(tx, ty);
+    const double tw = std::max(0.0, std::min(txy, tz));
+    step[i] = std::min(sInt[i], tw);
+    face[i] = sInt[i] < tw ? -1 : tz < txy ? 2 : (ty < tx ? 1 : 0);
+  }
+}
+
+// As WallStepsBox for the tubs can; `face` is 0 for the side, 2 for an endcap.
+void WallStepsTubs(std::size_t n, double r, double hz,
+                   const double* __restrict x, const double* __restrict y, const double* __restrict z,
+                   const double* __restrict dx, const double* __restrict dy, const double* __restrict dz,
+                   const double* __restrict sInt, double* __restrict step, int* __restrict face) {
+  for (std::size_t i = 0; i < n; ++i) {
+    const double a = dx[i] * dx[i] + dy[i] * dy[i];
+    const double bq = x[i] * dx[i] + y[i] * dy[i];
+    const double c = x[i] * x[i] + y[i] * y[i] - r * r;
+    const double disc = std::max(0.0, bq * bq - a * c);
+    const double tr = a > 0.0 ? (-bq + std::sqrt(disc)) / a : kInf;
+    const double tz = dz[i] != 0.0 ? ((dz[i] > 0.0 ? hz : -hz) - z[i]) / dz[i] : kInf;
+    const double tw = std::max(0.0, std::min(tr, tz));
+    step[i] = std::min(sInt[i], tw);
+    face[i] = sInt[i] < tw ? -1 : (tr <= tz ? 0 : 2);
+  }
+}
+
+// Distance along each (photon, disc) pair to the disc crossing, or kInf if
+// the ray misses the disc.
+void DiscDistances(std::size_t m, double discR2,
+                   const double* __restrict x, const double* __restrict y, const double* __restrict z,
+                   const double* __restrict dx, const double* __restrict dy, const double* __restrict dz,
+                   const double* __restrict px, const double* __restrict py, const double* __restrict pz,
+                   const double* __restrict nx, const double* __restrict ny, const double* __restrict nz,
+                   double* __restrict dist) {
+  for (std::size_t j = 0; j < m; ++j) {
+    const double cosIn = dx[j] * nx[j] + dy[j] * ny[j] + dz[j] * nz[j];
+    const double num = (px[j] - x[j]) * nx[j] + (py[j] - y[j]) * ny[j] + (pz[j] - z[j]) * nz[j];
+    const double d = num / cosIn; // inf or nan for a parallel ray, masked below
+    const double qx = x[j] + d * dx[j] - px[j];
+    const double qy = y[j] + d * dy[j] - py[j];
+    const double qz = z[j] + d * dz[j] - pz[j];
+    const bool hit = (cosIn != 0.0) & (d > 0.0) & (qx * qx + qy * qy + qz * qz <= discR2);
+    dist[j] = hit ? d : kInf;
+  }
+}
+
+void Advance(std::size_t n, double* __restrict x, double* __restrict y, double* __restrict z,
+             double* __restrict t, const double* __restrict dx, const double* __restrict dy,
+             const double* __restrict dz, const double* __restrict vg, const double* __restrict step) {
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] += step[i] * dx[i];
+    y[i] += step[i] * dy[i];
+    z[i] += step[i] * dz[i];
+    t[i] += step[i] / vg[i];
+  }
+}
+
+// Trace every photon in `b` to absorption, escape or a photocathode.
+void Trace(Batch& b, std::vector<PMTHit>& out) {
+  const auto& g = gGeom;
+  auto& s = tScratch;
+  unsigned long long steps = 0;
+
+  for (int pass = 0; pass < kMaxPasses && b.Size() > 0; ++pass) {
+    const std::size_t n = b.Size();
+    steps += n;
+    s.Resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      s.u0[i] = -std::log(G4UniformRand()); // unit exponential
+      s.u1[i] = G4UniformRand();
+    }
+
+    // Distance to the next bulk interaction (absorption or scattering), then
+    // to the can wall; `face` remembers which wall for the normal.
+    InteractionLengths(n, b.invAbs.data(), b.invScat.data(), s.u0.data(), s.sInt.data());
+    if (g.tubs) {
+      WallStepsTubs(n, g.r, g.hz, b.x.data(), b.y.data(), b.z.data(), b.dx.data(), b.dy.data(),
+                    b.dz.data(), s.sInt.data(), s.step.data(), s.face.data());
+    } else {
+      WallStepsBox(n, g.hx, g.hy, g.hz, b.x.data(), b.y.data(), b.z.data(), b.dx.data(), b.dy.data(),
+                   b.dz.data(), s.sInt.data(), s.step.data(), s.face.data());
+    }
+
+    // Nearest photocathode disc crossed within the step (either face). The
+    // aperture map lists the candidate discs along each step; all (photon,
+    // disc) pairs of the pass go through one distance kernel, then each
+    // photon takes the minimum over its own pairs.
+    {
+      auto& p = s.pairs;
+      p.Clear();
+      for (std::size_t i = 0; i < n; ++i) {
+        s.first[i] = p.Size();
+        SurfaceHits::Candidates({b.x[i], b.y[i], b.z[i]}, {b.dx[i], b.dy[i], b.dz[i]}, s.step[i],
+                                s.candidates);
+        for (const int k : s.candidates) p.Push(b, i, g, k);
+      }
+      s.first[n] = p.Size();
+      p.dist.resize(p.Size());
+      DiscDistances(p.Size(), g.discR2, p.x.data(), p.y.data(), p.z.data(), p.dx.data(), p.dy.data(),
+                    p.dz.data(), p.px.data(), p.py.data(), p.pz.data(), p.nx.data(), p.ny.data(),
+                    p.nz.data(), p.dist.data());
+
+      for (std::size_t i = 0; i < n; ++i) {
+        double best = s.step[i];
+        int bestSlot = -1;
+        for (std::size_t j = s.first[i]; j < s.first[i + 1]; ++j) {
+          if (p.dist[j] < best) {
+            best = p.dist[j];
+            bestSlot = p.slot[j];
+          }
+        }
+        s.slot[i] = bestSlot;
+        if (bestSlot >= 0) s.step[i] = best;
+      }
+    }
+
+    Advance(n, b.x.data(), b.y.data(), b.z.data(), b.t.data(), b.dx.data(), b.dy.data(), b.dz.data(),
+            b.vg.data(), s.step.data());
+
+    // Resolve the interactions and compact the survivors.
+    std::size_t alive = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      bool keep = true;
+      G4ThreeVector dir(b.dx[i], b.dy[i], b.dz[i]);
+      if (s.slot[i] >= 0) {
+        out.emplace_back(g.id[s.slot[i]], b.t[i], b.w[i], b.lambda[i], /*flags=*/0);
+        keep = false;
+      } else if (s.face[i] < 0) {
+        if (s.u1[i] * (b.invAbs[i] + b.invScat[i]) < b.invAbs[i]) {
+          keep = false; // absorbed
+        } else {
+          dir = AroundAxis(dir, SampleRayleighCos(G4UniformRand()), twopi * G4UniformRand());
+        }
+      } else if (s.u1[i] >= b.refl[i]) {
+        keep = false; // absorbed by the wall
+      } else {
+        const G4ThreeVector normal = InwardNormal(s.face[i], {b.x[i], b.y[i], b.z[i]}, dir);
+        if (g.fresnel && G4UniformRand() >= FresnelReflectance(b.n[i], -dir.dot(normal))) {
+          keep = false; // transmitted out of the can
+        } else if (g.lambertian) {
+          dir = AroundAxis(normal, std::sqrt(G4UniformRand()), twopi * G4UniformRand());
+        } else {
+          dir -= 2.0 * dir.dot(normal) * normal;
+        }
+      }
+      if (!keep) continue;
+      b.dx[i] = dir.x(); b.dy[i] = dir.y(); b.dz[i] = dir.z();
+      if (alive != i) b.Move(i, alive);
+      ++alive;
+    }
+    b.Resize(alive);
+  }
+
+  gSteps.fetch_add(steps, std::memory_order_relaxed);
+  if (b.Size() > 0) gTruncated.fetch_add(b.Size(), std::memory_order_relaxed);
+}
+
+} // namespace
+
+namespace BatchOptics {
+
+void Configure() { gEnabled = true; }
+
+bool Enabled() { return gEnabled; }
+
+bool Ready() { return gReady; }
+
+bool Build(const G4LogicalVolume* canLV, const G4ThreeVector& canOffset,
+           const G4OpticalSurface* wallSurface, double cathodeRadius) {
+  gReady = false;
+  const auto* snap = GeometryRegistry::Instance().Snapshot();
+  const auto* mpt = canLV && canLV->GetMaterial() ? canLV->GetMaterial()->GetMaterialPropertiesTable()
+                                                  : nullptr;
+  auto* rindexVec = mpt ? mpt->GetProperty("RINDEX") : nullptr;
+  if (!snap || !rindexVec || cathodeRadius <= 0.0 || !SurfaceHits::Ready()) {
+    G4cout << "[WARN] BatchOptics: need a frozen PMT table, the aperture map, water RINDEX and photocathode discs"
+           << G4endl;
+    return false;
+  }
+
+  Geometry g;
+  if (auto* box = dynamic_cast<const G4Box*>(canLV->GetSolid())) {
+    g.hx = box->GetXHalfLength();
+    g.hy = box->GetYHalfLength();
+    g.hz = box->GetZHalfLength();
+  } else if (auto* tubs = dynamic_cast<const G4Tubs*>(canLV->GetSolid());
+             tubs && tubs->GetInnerRadius() == 0.0 && tubs->GetDeltaPhiAngle() >= twopi) {
+    g.tubs = true;
+    g.r = tubs->GetOuterRadius();
+    g.hz = tubs->GetZHalfLength();
+  } else {
+    G4cout << "[WARN] BatchOptics: water can must be a G4Box or a full G4Tubs" << G4endl;
+    return false;
+  }
+  g.offset = canOffset;
+
+  g.id = snap->id;
+  g.px = snap->x; g.py = snap->y; g.pz = snap->z;
+  g.nx = snap->nx; g.ny = snap->ny; g.nz = snap->nz;
+  g.discR2 = cathodeRadius * cathodeRadius;
+
+  const auto* params = G4OpticalParameters::Instance();
+  const bool absorption = params->GetProcessActivation("Absorption");
+  const bool rayleigh = params->GetProcessActivation("Rayleigh");
+  const bool boundary = params->GetProcessActivation("Boundary");
+  auto* absVec = absorption ? mpt->GetProperty("ABSLENGTH") : nullptr;
+  auto* rayVec = rayleigh ? mpt->GetProperty("RAYLEIGH") : nullptr;
+  auto* groupVec = mpt->GetProperty("GROUPVEL");
+  const auto* wallMPT = wallSurface ? wallSurface->GetMaterialPropertiesTable() : nullptr;
+  auto* reflVec = wallMPT ? wallMPT->GetProperty("REFLECTIVITY") : nullptr;
+
+  g.eMin = rindexVec->Energy(0);
+  g.eStep = std::max(rindexVec->GetMaxEnergy() - g.eMin, 1e-9 * eV) / (kTableBins - 1);
+  auto inverse = [](G4MaterialPropertyVector* vec, double e) {
+    const double length = vec ? vec->Value(e) : 0.0;
+    return length > 0.0 ? 1.0 / length : 0.0;
+  };
+  for (int i = 0; i < kTableBins; ++i) {
+    const double e = g.eMin + i * g.eStep;
+    const double rin = std::max(1.0, rindexVec->Value(e));
+    const double vg = groupVec ? groupVec->Value(e) : 0.0;
+    g.rindex.push_back(rin);
+    g.groupVel.push_back(vg > 0.0 ? vg : c_light / rin);
+    g.invAbs.push_back(inverse(absVec, e));
+    g.invScat.push_back(inverse(rayVec, e));
+    g.wallRefl.push_back(!boundary ? 0.0 : reflVec ? std::clamp(reflVec->Value(e), 0.0, 1.0) : 1.0);
+  }
+  if (wallSurface) {
+    g.lambertian = wallSurface->GetFinish() != polished;
+    g.fresnel = wallSurface->GetType() == dielectric_dielectric;
+  } else {
+    g.lambertian = false;
+    g.fresnel = true;
+  }
+
+  gGeom = std::move(g);
+  gReady = true;
+  G4cout << "[BatchOptics] can=" << (gGeom.tubs ? "tubs" : "box") << " pmts=" << gGeom.id.size()
+         << " abs=" << (absorption ? "on" : "off") << " rayleigh=" << (rayleigh ? "on" : "off")
+         << " wall=" << (gGeom.lambertian ? "lambertian" : "specular")
+         << (gGeom.fresnel ? "+fresnel" : "") << G4endl;
+  return true;
+}
+
+void Enqueue(const G4Track* track) {
+  if (!gReady || !track) return;
+  const auto& g = gGeom;
+  const G4ThreeVector pos = track->GetPosition() - g.offset;
+  const bool inside = g.tubs ? (std::hypot(pos.x(), pos.y()) < g.r && std::abs(pos.z()) < g.hz)
+                             : (std::abs(pos.x()) < g.hx && std::abs(pos.y()) < g.hy &&
+                                std::abs(pos.z()) < g.hz);
+  if (!inside) return; // not born in the water
+  const double e = track->GetTotalEnergy();
+  const double lambda_nm = e > 0.0 ? (h_Planck * c_light / e) / nm : 0.0;
+  tQueue.Push(pos, track->GetMomentumDirection(), track->GetGlobalTime(), track->GetWeight(),
+              Lookup(g.invAbs, e), Lookup(g.invScat, e), Lookup(g.groupVel, e),
+              Lookup(g.rindex, e), Lookup(g.wallRefl, e), lambda_nm);
+}
+
+std::size_t Flush(PMTHitsCollection* hits) {
+  auto& queue = tQueue;
+  if (queue.Size() == 0) return 0;
+  const auto start = std::chrono::steady_clock::now();
+  gPhotons.fetch_add(queue.Size(), std::memory_order_relaxed);
+  std::vector<PMTHit> out;
+  Trace(queue, out);
+  queue.Resize(0);
+  if (hits) {
+    for (const auto& hit : out) hits->insert(new PMTHit(hit));
+  }
+  gHits.fetch_add(out.size(), std::memory_order_relaxed);
+  gTraceNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start).count(),
+                     std::memory_order_relaxed);
+  return out.size();
+}
+
+void ResetCounters() {
+  gPhotons = 0;
+  gSteps = 0;
+  gHits = 0;
+  gTruncated = 0;
+  gTraceNs = 0;
+}
+
+void Report() {
+  if (!gEnabled) return;
+  const double seconds = gTraceNs.load() * 1e-9;
+  G4cout << "[BatchOptics] photons=" << gPhotons.load() << " steps=" << gSteps.load()
+         << " hits=" << gHits.load() << " truncated=" << gTruncated.load()
+         << " trace_s=" << seconds
+         << " photons_per_s=" << (seconds > 0.0 ? gPhotons.load() / seconds : 0.0) << G4endl;
+}
+
+} // namespace BatchOptics
@@ -1,19 +1,27 @@
 #include "DetectorConstruction.hh"
 #include "globals.hh"
 #include "OpticalProperties.hh"
+#include "PMTLayout.hh"
+#include "NativeGeometry.hh"
 #include "GeometryRegistry.hh"
+#include "BatchOptics.hh"
+#include "DirectLightModel.hh"
+#include "SurfaceHits.hh"
 
 #include <G4Box.hh>
 #include <G4Colour.hh>
 #include <G4GDMLParser.hh>
 #include <G4GeometryManager.hh>
 #include <G4LogicalBorderSurface.hh>
+#include <G4LogicalSkinSurface.hh>
 #include <G4LogicalVolume.hh>
 #include <G4MaterialPropertiesTable.hh>
 #include <G4NistManager.hh>
 #include <G4PVPlacement.hh>
 #include <G4OpticalSurface.hh>
 #include <G4PhysicalVolumeStore.hh>
+#include <G4Region.hh>
+#include <G4RegionStore.hh>
 #include <G4RotationMatrix.hh>
 #include <G4RunManager.hh>
 #include <G4SDManager.hh>
@@ -27,6 +35,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 
 #include <cstdlib>   // getenv
 #include <iomanip>
@@ -105,32 +114,56 @@ DetectorConstruction::DetectorConstruction(const G4String& gdmlPath,
                                            std::string opticsConfigPath,
                                            int checkOverlapsN,
                                            double qeOverride,
-                                           double qeFlat)
+                                           double qeFlat,
+                                           std::string geometryConfigPath)
   : fGdmlPath(gdmlPath),
     fOpticsPath(std::move(opticsConfigPath)),
     fCheckOverlapsN(checkOverlapsN),
     fQeOverride(qeOverride),
-    fQeFlat(qeFlat) {}
+    fQeFlat(qeFlat),
+    fGeometryPath(std::move(geometryConfigPath)) {}
 
 G4VPhysicalVolume* DetectorConstruction::Construct() {
-  if (fGdmlPath.empty()) {
+  if (fGdmlPath.empty() && fGeometryPath.empty()) {
     G4Exception("DetectorConstruction", "NoGDML", FatalException,
                 "G4_GDML path not set (empty).");
   }
 
-  // 1) Parse GDML and get world
-  fParser.Read(fGdmlPath, /*validate=*/false);
-  auto* worldPV = fParser.GetWorldVolume();
+  const char* canName = std::getenv("G4_CAN_LV");
+  G4String targetCan = canName && *canName ? canName : "Detector";
+
+  // 1) Parse GDML (or build the native geometry) and get world
+  const auto geomStart = std::chrono::steady_clock::now();
+  G4VPhysicalVolume* worldPV = nullptr;
+  if (!fGeometryPath.empty()) {
+    try {
+      fNative = std::make_unique<NativeGeometryConfig>(NativeGeometry::LoadFromYaml(fGeometryPath));
+    } catch (const std::exception& ex) {
+      const std::string msg = "Failed to load geometry config '" + fGeometryPath + "': " + ex.what();
+      G4Exception("DetectorConstruction", "GeometryConfig", FatalException, msg.c_str());
+      return nullptr;
+    }
+    worldPV = NativeGeometry::Build(*fNative, targetCan);
+    G4cout << "[GEOM] native " << NativeGeometry::Describe(*fNative) << G4endl;
+  } else {
+    fParser.Read(fGdmlPath, /*validate=*/false);
+    worldPV = fParser.GetWorldVolume();
+  }
   if (!worldPV) {
     G4Exception("DetectorConstruction", "BadGDML", FatalException,
                 "World volume is null after parsing GDML.");
   }
+  const double geomMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - geomStart).count();
+  G4cout << "[GEOM] source=" << (fNative ? "native" : "gdml")
+         << " path=" << (fNative ? fGeometryPath : std::string(fGdmlPath))
+         << " build_ms=" << geomMs << G4endl;
   auto* worldLV = worldPV->GetLogicalVolume();
 
   GeometryRegistry::Instance().ClearPMTs();
 
   // Optionally remap any GDML 'Vacuum' LVs to G4_Galactic (quiet cosmetic warnings)
-  RemapGDMLVacuumToGalactic();
+  if (!fNative) RemapGDMLVacuumToGalactic();
 
   std::string opticsPath = fOpticsPath;
   if (opticsPath.empty()) {
@@ -212,11 +245,9 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
   // 2b) Can LV -> G4_WATER
   // GDML shows: <volume name="Detector"> with Water material.
   // witch to NIST G4_WATER so optics tables are standard.
-  const char* canName = std::getenv("G4_CAN_LV");
-  G4String targetCan = canName && *canName ? canName : "Detector";
-
   auto* lvStore = G4LogicalVolumeStore::GetInstance();
   auto* canLV = lvStore->GetVolume(targetCan, /*verbose=*/false);
+  fCanLV = canLV;
   if (canLV) {
     if (waterMaterial) {
       canLV->SetMaterial(waterMaterial);
@@ -239,16 +270,16 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
         new G4LogicalBorderSurface("WorldToWater", worldPV, canPV,  opticsTables.wallSurface);
       }
 
-      G4OpticalSurface* cathBorderSurface = nullptr;
+      G4OpticalSurface* cathSurface = nullptr;
       if (opticsLoaded && opticsTables.photocathodeSurface) {
-        cathBorderSurface = new G4OpticalSurface("PhotocathodeWaterBoundary");
-        cathBorderSurface->SetType(dielectric_dielectric);
-        cathBorderSurface->SetModel(unified);
-        cathBorderSurface->SetFinish(polished);
+        cathSurface = new G4OpticalSurface("PhotocathodeWaterBoundary");
+        cathSurface->SetType(dielectric_dielectric);
+        cathSurface->SetModel(unified);
+        cathSurface->SetFinish(polished);
 
         if (!opticsTables.energyGrid.empty()) {
           auto* borderMPT = new G4MaterialPropertiesTable();
-          cathBorderSurface->SetMaterialPropertiesTable(borderMPT);
+          cathSurface->SetMaterialPropertiesTable(borderMPT);
         }
       }
 
@@ -256,12 +287,11 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
       if (!cathMat) {
         G4cout << "[WARN] Material 'G4_Al' not found; skipping PMT tiling.\n";
       } else {
-        const G4double kPmtRadius = 0.10 * m;
+        // Native geometry: layout knobs from its YAML; GDML: the defaults.
+        const PMTWallSpec spec = fNative ? fNative->pmts : PMTWallSpec();
         const G4double kPmtThick  = 0.8 * mm;
-        const G4double defaultZPitch = 0.50 * m;
-        const G4int   defaultNPhi   = 48;
 
-        auto* pmtSol = new G4Tubs("PMT_cathode_tubs", 0., kPmtRadius, kPmtThick / 2., 0., 360 * deg);
+        auto* pmtSol = new G4Tubs("PMT_cathode_tubs", 0., spec.pmtRadius, kPmtThick / 2., 0., 360 * deg);
         auto* pmtLog = new G4LogicalVolume(pmtSol,
                                            opticsTables.photocathodeMaterial ? opticsTables.photocathodeMaterial : cathMat,
                                            "PMT_cathode_log");
@@ -274,16 +304,6 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
                  << " with RINDEX(λ) set (N=" << nGrid << ")" << G4endl;
         }
 
-        auto* existingSD = pmtLog->GetSensitiveDetector();
-        PMTSD* pmtSD = dynamic_cast<PMTSD*>(existingSD);
-        if (!pmtSD) {
-          pmtSD = new PMTSD("PMTSD");
-          G4SDManager::GetSDMpointer()->AddNewDetector(pmtSD);
-          pmtLog->SetSensitiveDetector(pmtSD);
-          G4cout << "[PMT] SD attached to PhotocathodeLV thickness="
-                 << (kPmtThick / mm) << " mm" << G4endl;
-        }
-
         const auto read_env_double = [](const char* name, double fallback) {
           if (const char* val = std::getenv(name)) {
             try { return std::stod(val); } catch (...) { return fallback; }
@@ -300,140 +320,93 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
           return fallback;
         };
 
-        G4int pmtPlaced = 0;
-        bool firstPmtMotherChecked = false;
-        G4int overlapsChecked = 0;
-        bool overlapsFound = false;
-
-        auto placePmt = [&](G4RotationMatrix* rot, const G4ThreeVector& pos) -> G4VPhysicalVolume* {
-          const G4int copyNo = pmtPlaced++;
-          const bool shouldCheckOverlap = (fCheckOverlapsN > 0 && copyNo < fCheckOverlapsN);
-          auto* pv = new G4PVPlacement(rot, pos, pmtLog, "PMT", canLV, false, copyNo, false);
-          if (pv && !firstPmtMotherChecked) {
-            auto* mother = pv->GetMotherLogical();
-            const G4String motherName = mother ? mother->GetName() : "<null>";
-            G4cout << "[CHK] pcath mother=" << motherName << G4endl;
-            if (mother != canLV) {
-              G4Exception("DetectorConstruction", "BadMother", FatalException,
-                          "Photocathode must be direct child of water LV");
+        // Layout first: copy numbers and registry records do not depend on
+        // how (or whether) the PMT volumes are placed.
+        std::ostringstream ringLog;
+        bool endcaps = false;
+        if (auto* waterBox = dynamic_cast<G4Box*>(canLV->GetSolid())) {
+          fPMTLayout = BoxWallLayout(waterBox->GetXHalfLength(), waterBox->GetYHalfLength(),
+                                     waterBox->GetZHalfLength(), spec.zPitch,
+                                     spec.xPitch, spec.yPitch, /*inset=*/spec.wallGap, spec.boxFaces);
+          ringLog << " rings=NA perRing=NA";
+          endcaps = (spec.boxFaces & (kBoxFacePosZ | kBoxFaceNegZ)) != 0;
+        } else if (auto* tubs = dynamic_cast<G4Tubs*>(canLV->GetSolid())) {
+          G4double zPitch = read_env_double("FLNDR_PMT_ZPITCH_M", spec.zPitch / m) * m;
+          if (zPitch <= 0.0) zPitch = spec.zPitch;
+          const G4int nPhi = read_env_int("FLNDR_PMT_NPHI", spec.nPhi);
+          fPMTLayout = TubsWallLayout(tubs->GetOuterRadius(), tubs->GetZHalfLength(), spec.pmtRadius, zPitch, nPhi,
+                                      spec.wallGap);
+          ringLog << " rings=" << fPMTLayout->rings << " perRing=" << fPMTLayout->perRing;
+        }
+
+        if (fPMTLayout) {
+          const auto& layout = *fPMTLayout;
+          for (std::size_t copyNo = 0; copyNo < layout.Size(); ++copyNo) {
+            const auto* rot = layout.rotation[copyNo];
+            const auto& pos = layout.position[copyNo];
+            G4ThreeVector outward(0, 0, 1);
+            if (rot) {
+              outward = (*rot)(outward);
+            } else if (pos.mag2() > 0.0) {
+              outward = pos.unit();
             }
-            firstPmtMotherChecked = true;
-          }
-          if (cathBorderSurface && canPV && pv) {
-            G4String surfName = "PhotocathodeSurface_" + std::to_string(copyNo + 1);
-            new G4LogicalBorderSurface(surfName, canPV, pv, cathBorderSurface);
-          }
-          if (shouldCheckOverlap && pv) {
-            ++overlapsChecked;
-            if (pv->CheckOverlaps(0.0, 0.0, false)) {
-              overlapsFound = true;
+            G4ThreeVector normal = -outward;
+            if (normal.mag2() > 0.0) {
+              normal = normal.unit();
+            } else {
+              normal = G4ThreeVector(0, 0, 1);
             }
+            GeometryRegistry::Instance().RegisterPMT(static_cast<G4int>(copyNo), pos, normal);
           }
 
-          G4ThreeVector outward(0, 0, 1);
-          if (rot) {
-            outward = (*rot)(outward);
-          } else if (pos.mag2() > 0.0) {
-            outward = pos.unit();
-          }
-          G4ThreeVector normal = -outward;
-          if (normal.mag2() > 0.0) {
-            normal = normal.unit();
+          // --pmt_mode=surface: register the layout but place no PMT volumes.
+          if (SurfaceHits::Enabled()) {
+            G4cout << "[PMT] surface mode: " << layout.Size() << " PMTs registered, no PMT volumes placed"
+                   << G4endl;
           } else {
-            normal = G4ThreeVector(0, 0, 1);
-          }
-          GeometryRegistry::Instance().RegisterPMT(copyNo, pos, normal);
-          return pv;
-        };
-
-        if (auto* waterBox = dynamic_cast<G4Box*>(canLV->GetSolid())) {
-          const G4double halfX = waterBox->GetXHalfLength();
-          const G4double halfY = waterBox->GetYHalfLength();
-          const G4double halfZ = waterBox->GetZHalfLength();
-
-          const G4double kZPitch = defaultZPitch;
-          const G4double kXPitch = 0.375 * m;
-          const G4double kYPitch = 0.375 * m;
-
-          {
-            G4double x = halfX - 0.5 * cm;
-            for (G4double z = -halfZ + kZPitch; z <= halfZ - kZPitch; z += kZPitch) {
-              for (G4double y = -halfY + kYPitch; y <= halfY - kYPitch; y += kYPitch) {
-                auto rot = new G4RotationMatrix();
-                rot->rotateY(90 * deg);
-                placePmt(rot, {x, y, z});
-              }
+            // A parameterised volume must be the only daughter of its mother.
+            PMTPlacement placement = PMTPlacementFromEnv();
+            if (placement == PMTPlacement::kParameterised && canLV->GetNoDaughters() > 0) {
+              G4cout << "[WARN] PMT: '" << canLV->GetName()
+                     << "' has other daughters; placing PMT copies instead of a parameterised volume"
+                     << G4endl;
+              placement = PMTPlacement::kCopies;
             }
-          }
-          {
-            G4double x = -halfX + 0.5 * cm;
-            for (G4double z = -halfZ + kZPitch; z <= halfZ - kZPitch; z += kZPitch) {
-              for (G4double y = -halfY + kYPitch; y <= halfY - kYPitch; y += kYPitch) {
-                auto rot = new G4RotationMatrix();
-                rot->rotateY(-90 * deg);
-                placePmt(rot, {x, y, z});
+            const auto pvs = PlacePMTs(layout, pmtLog, canLV, placement, fPMTParam);
+            if (!pvs.empty()) {
+              auto* mother = pvs.front()->GetMotherLogical();
+              const G4String motherName = mother ? mother->GetName() : "<null>";
+              G4cout << "[CHK] pcath mother=" << motherName << G4endl;
+              if (mother != canLV) {
+                G4Exception("DetectorConstruction", "BadMother", FatalException,
+                            "Photocathode must be direct child of water LV");
               }
             }
-          }
-          {
-            G4double y = halfY - 0.5 * cm;
-            for (G4double z = -halfZ + kZPitch; z <= halfZ - kZPitch; z += kZPitch) {
-              for (G4double x = -halfX + kXPitch; x <= halfX - kXPitch; x += kXPitch) {
-                auto rot = new G4RotationMatrix();
-                rot->rotateX(-90 * deg);
-                placePmt(rot, {x, y, z});
+
+            G4int overlapsChecked = 0;
+            bool overlapsFound = false;
+            for (auto* pv : pvs) {
+              // The parameterised volume checks all of its copies at once.
+              if (overlapsChecked < fCheckOverlapsN) {
+                overlapsChecked += pv->GetMultiplicity();
+                if (pv->CheckOverlaps(0.0, 0.0, false)) {
+                  overlapsFound = true;
+                }
               }
             }
-          }
-          {
-            G4double y = -halfY + 0.5 * cm;
-            for (G4double z = -halfZ + kZPitch; z <= halfZ - kZPitch; z += kZPitch) {
-              for (G4double x = -halfX + kXPitch; x <= halfX - kXPitch; x += kXPitch) {
-                auto rot = new G4RotationMatrix();
-                rot->rotateX(90 * deg);
-                placePmt(rot, {x, y, z});
-              }
+            const CathodeSurface cathMode = CathodeSurfaceFromEnv();
+            const std::size_t cathSurfaces = AttachCathodeSurface(pvs, pmtLog, canPV, cathSurface, cathMode);
+            G4cout << "[PMT] placement=" << PMTPlacementName(placement)
+                   << " volumes=" << pvs.size()
+                   << " rotations=" << layout.rotations.size()
+                   << " cathode_surface=" << CathodeSurfaceName(cathMode)
+                   << " surfaces=" << cathSurfaces << G4endl;
+            if (fCheckOverlapsN > 0) {
+              G4cout << "[CHK] overlaps_checked=" << overlapsChecked
+                     << " overlaps_found=" << (overlapsFound ? 1 : 0) << G4endl;
             }
           }
-          const int sdAttached = (pmtLog->GetSensitiveDetector() != nullptr) ? 1 : 0;
-          G4cout << "[PMT] placed=" << pmtPlaced << " rings=NA perRing=NA wall=1 endcaps=0" << G4endl;
-          G4cout << "[SENS] SD attached=" << sdAttached << G4endl;
-        } else if (auto* tubs = dynamic_cast<G4Tubs*>(canLV->GetSolid())) {
-          const G4double rOuter   = tubs->GetOuterRadius();
-          const G4double zHalf    = tubs->GetZHalfLength();
-          const G4double wallGap  = 5.0 * mm;
-          const G4double zMargin  = kPmtRadius + 5.0 * cm;
-          G4double zPitch = read_env_double("FLNDR_PMT_ZPITCH_M", defaultZPitch / m) * m;
-          if (zPitch <= 0.0) zPitch = defaultZPitch;
-          const G4int nPhi = read_env_int("FLNDR_PMT_NPHI", defaultNPhi);
-          const G4double innerRadius = std::max(rOuter - wallGap - kPmtRadius, kPmtRadius + wallGap);
-          const G4double radius = innerRadius;
-
-          int ringCount = 0;
-          for (G4double z = -zHalf + zMargin; z <= zHalf - zMargin + 0.5 * zPitch; z += zPitch) {
-            if (z > zHalf - zMargin) break;
-            ++ringCount;
-            for (int k = 0; k < nPhi; ++k) {
-              const G4double phi = (2.0 * CLHEP::pi * k) / nPhi;
-              const G4double x = radius * std::cos(phi);
-              const G4double y = radius * std::sin(phi);
-              auto rot = new G4RotationMatrix();
-              rot->rotateY(90.0 * deg);
-              rot->rotateZ(phi);
-              placePmt(rot, {x, y, z});
-            }
-          }
-          const int sdAttached = (pmtLog->GetSensitiveDetector() != nullptr) ? 1 : 0;
-          G4cout << "[PMT] placed=" << pmtPlaced
-                 << " rings=" << ringCount
-                 << " perRing=" << nPhi
-                 << " wall=1 endcaps=0" << G4endl;
-          G4cout << "[SENS] SD attached=" << sdAttached << G4endl;
-        }
-
-        if (fCheckOverlapsN > 0) {
-          G4cout << "[CHK] overlaps_checked=" << overlapsChecked
-                 << " overlaps_found=" << (overlapsFound ? 1 : 0) << G4endl;
+          G4cout << "[PMT] placed=" << layout.Size() << ringLog.str() << " wall=1 endcaps=" << (endcaps ? 1 : 0) << G4endl;
         }
       }
     }
@@ -503,6 +476,97 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
     G4Exception("DetectorConstruction", "SurfaceTableEmpty", FatalException,
                 "Expected at least one logical border surface.");
   }
+  if (auto* cathLV = G4LogicalVolumeStore::GetInstance()->GetVolume("PMT_cathode_log", false)) {
+    if (auto* skin = G4LogicalSkinSurface::GetSurface(cathLV)) {
+      G4cout << "[SURF_TAB] " << skin->GetName() << " skin=" << cathLV->GetName() << G4endl;
+    }
+  }
+
+  // day2fast: the direct-light fast simulation model lives on the water can.
+  if (canLV && DirectLight::Enabled() &&
+      !G4RegionStore::GetInstance()->GetRegion(DirectLight::kRegionName, /*verbose=*/false)) {
+    auto* region = new G4Region(DirectLight::kRegionName);
+    region->AddRootLogicalVolume(canLV);
+  }
+
+  // Placement done: publish the PMT table for lock-free lookups from workers.
+  GeometryRegistry::Instance().Freeze();
+  if (const auto* snap = GeometryRegistry::Instance().Snapshot()) {
+    G4cout << "[GEOM] PMT registry frozen: " << snap->Size() << " PMTs"
+           << (snap->slotOfId.empty() ? " (sparse ids)" : "") << G4endl;
+  }
+
+  // The batch tracer and the surface-hit map work in can coordinates. The
+  // map also culls the discs for the batch tracer and direct light.
+  const bool apertureMap = SurfaceHits::Enabled() || BatchOptics::Enabled() || DirectLight::Enabled();
+  G4ThreeVector canOffset;
+  if (apertureMap) {
+    for (auto* pv : *G4PhysicalVolumeStore::GetInstance()) {
+      if (pv && canLV && pv->GetLogicalVolume() == canLV) {
+        if (pv->GetRotation()) {
+          G4cout << "[WARN] BatchOptics/SurfaceHits: rotation of the water can is ignored" << G4endl;
+        }
+        canOffset = pv->GetTranslation();
+        break;
+      }
+    }
+  }
+  auto* cathode = G4LogicalVolumeStore::GetInstance()->GetVolume("PMT_cathode_log", /*verbose=*/false);
+  auto* cathodeTubs = cathode ? dynamic_cast<G4Tubs*>(cathode->GetSolid()) : nullptr;
+  const bool mapReady = apertureMap && canLV && cathodeTubs &&
+                        SurfaceHits::Build(canLV, canOffset, cathodeTubs->GetOuterRadius());
+
+  // --pmt_mode=surface: wall crossings are mapped to PMT discs analytically.
+  if (SurfaceHits::Enabled() && !mapReady) {
+    G4Exception("DetectorConstruction", "SurfaceHits", FatalException,
+                "--pmt_mode=surface needs a G4Box/G4Tubs water can with PMTs.");
+  }
+
+  // --optical_backend=batch: hand the can, wall optics and PMT discs to the tracer.
+  if (BatchOptics::Enabled()) {
+    if (!mapReady ||
+        !BatchOptics::Build(canLV, canOffset, opticsLoaded ? opticsTables.wallSurface : nullptr,
+                            cathodeTubs->GetOuterRadius())) {
+      G4Exception("DetectorConstruction", "BatchOptics", FatalException,
+                  "--optical_backend=batch needs a G4Box/G4Tubs water can with PMTs.");
+    }
+  }
+
+  if (DirectLight::Enabled() && !mapReady) {
+    G4cout << "[WARN] DirectLight: no aperture map; every photon is tested against every PMT" << G4endl;
+  }
 
   return worldPV;
 }
+
+// Sensitive detectors are thread-local: called once on the master (serial) or
+// once per worker thread, after Construct() has built the shared geometry.
+void DetectorConstruction::ConstructSDandField() {
+  auto* pmtLog = G4LogicalVolumeStore::GetInstance()->GetVolume("PMT_cathode_log", /*verbose=*/false);
+  if (!pmtLog) {
+    G4cout << "[SENS] SD attached=0 (no PMT_cathode_log)" << G4endl;
+    return;
+  }
+  auto* pmtSD = new PMTSD("PMTSD");
+  G4SDManager::GetSDMpointer()->AddNewDetector(pmtSD);
+  if (SurfaceHits::Enabled() && fCanLV) {
+    // No photocathode volumes: PMTSD resolves wall crossings in the water.
+    SetSensitiveDetector(fCanLV, pmtSD);
+    G4cout << "[SENS] SD attached to " << fCanLV->GetName() << " (surface PMT mode)" << G4endl;
+    return;
+  }
+  SetSensitiveDetector(pmtLog, pmtSD);
+  if (auto* tubs = dynamic_cast<G4Tubs*>(pmtLog->GetSolid())) {
+    G4cout << "[PMT] SD attached to PhotocathodeLV thickness="
+           << (2.0 * tubs->GetZHalfLength() / mm) << " mm" << G4endl;
+  }
+  G4cout << "[SENS] SD attached=" << (pmtLog->GetSensitiveDetector() ? 1 : 0) << G4endl;
+
+  if (DirectLight::Enabled()) {
+    if (auto* region = G4RegionStore::GetInstance()->GetRegion(DirectLight::kRegionName, false)) {
+      new DirectLightModel("DirectLightModel", region); // registers itself with the region
+    } else {
+      G4cout << "[WARN] DirectLight: no water can region; photons are tracked" << G4endl;
+    }
+  }
+}
@@ -1,5 +1,6 @@
 #include "Digitizer.hh"
-#include "PhotonBudget.hh"          // for PrimaryInfo::T0ns() and X0()
+#include "OutputMerge.hh"
+#include "PrimaryVertexInfo.hh"
 #include "RunManifest.hh"
 #include "G4RunManager.hh"
 #include "G4Step.hh"
@@ -73,6 +74,8 @@ const char* BoundaryStatusName(G4OpBoundaryProcessStatus status) {
   }
 }
 
+} // namespace
+
 G4OpBoundaryProcess* FindBoundaryProcess(const G4Track* track) {
   static thread_local G4OpBoundaryProcess* cached = nullptr;
   if (cached) return cached;
@@ -90,8 +93,6 @@ G4OpBoundaryProcess* FindBoundaryProcess(const G4Track* track) {
   return cached;
 }
 
-} // namespace
-
 // ---------------- HitWriter (ROOT) ----------------
 struct HitWriter::Impl {
   TFile* f{};
@@ -104,7 +105,7 @@ struct HitWriter::Impl {
 };
 HitWriter::HitWriter(const std::string& outroot) : p_(new Impl) {
   std::filesystem::create_directories(std::filesystem::path(outroot).parent_path());
-  p_->f = TFile::Open(outroot.c_str(),"RECREATE");
+  p_->f = TFile::Open(OutputMerge::ShardPath(outroot).c_str(),"RECREATE");
   p_->t = new TTree("hits","Digitized PMT hits");
   p_->t->Branch("event",&p_->b_event);
   p_->t->Branch("pmt",&p_->b_pmt);
@@ -145,14 +146,12 @@ double Digitizer::gauss(double sigma_ns) const {
   return sigma_ns > 0.0 ? G4RandGauss::shoot(0.0, sigma_ns) : 0.0;
 }
 
-void Digitizer::Digitize(int event_id, const std::vector<HitCandidate>& candidates,
+void Digitizer::Digitize(int event_id, double t0_ns, const std::vector<HitCandidate>& candidates,
                          std::vector<DigiHit>& out_hits) const {
   last_event_pmts_.clear();
   std::unordered_set<int> seen;
   seen.reserve(candidates.size());
 
-  const double t0_ns = PrimaryInfo::T0ns();
-
   for (const auto& cand : candidates) {
     if (seen.insert(cand.pmt).second) {
       last_event_pmts_.push_back(cand.pmt);
@@ -217,8 +216,8 @@ void DigitizerEventAction::ConfigureFromEnv(){
 }
 
 void DigitizerEventAction::BeginOfEventAction(const G4Event* event){
-  evtid_ = event ? event->GetEventID() : -1;
-  t0_ns_  = PrimaryInfo::T0ns();
+  evtid_ = static_cast<int>(PrimaryVertexInfo::KeyOf(event));
+  t0_ns_  = PrimaryVertexInfo::T0nsOf(event);
   hits_ev_.clear();
   if (!writer_) {
     writer_ = std::make_unique<HitWriter>(out_path_);
@@ -356,7 +355,7 @@ void DigitizerSteppingAction::UserSteppingAction(const G4Step* step){
     double t_digi = t_ns + evt_->gauss(evt_->params_.TTS_ns) + evt_->gauss(evt_->params_.JITTER_ns);
     double dt = t_digi - evt_->t0_ns_;
     if (dt >= evt_->params_.TWIN_LO_ns && dt <= evt_->params_.TWIN_HI_ns && 1.0 >= evt_->params_.THRESH_PE) {
-      evt_->hits_ev_.push_back({G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID(),
+      evt_->hits_ev_.push_back({evt_->evtid_,
                                 pid, t_digi, 1.0});
     }
   }
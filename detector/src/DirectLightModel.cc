@@ -0,0 +1,218 @@
+#include "DirectLightModel.hh"
+
+#include "GeometryRegistry.hh"
+#include "OpticalSubEvent.hh"
+#include "PMTHit.hh"
+#include "PhotonRecords.hh"
+#include "PrimaryVertexInfo.hh"
+#include "SurfaceHits.hh"
+
+#include <G4Event.hh>
+#include <G4EventManager.hh>
+#include <G4FastStep.hh>
+#include <G4FastTrack.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4OpticalParameters.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4SDManager.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4Track.hh>
+#include <G4Tubs.hh>
+#include <G4ios.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+bool gEnabled = false;
+double gIndirectFraction = 0.0;
+
+// Kept photons counted analytically, for the current event on this thread
+// (track ids are per event).
+struct CountedState {
+  const G4Event* event = nullptr;
+  int eventId = -1;
+  std::unordered_map<int, int> pmts; // track id -> PMT id of its ray
+};
+thread_local CountedState tCounted;
+
+// Discs listed along the current ray by the aperture map.
+thread_local std::vector<int> tCandidates;
+
+// Clear the marks when the thread has moved on to another event.
+CountedState& Counted() {
+  const auto* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  const int eventId = event ? event->GetEventID() : -1;
+  if (event != tCounted.event || eventId != tCounted.eventId) {
+    tCounted.event = event;
+    tCounted.eventId = eventId;
+    tCounted.pmts.clear();
+  }
+  return tCounted;
+}
+
+double PropertyValue(const G4MaterialPropertiesTable* mpt, const char* key, double energy) {
+  auto* vec = mpt ? mpt->GetProperty(key) : nullptr;
+  return vec ? vec->Value(energy) : 0.0;
+}
+
+} // namespace
+
+namespace DirectLight {
+
+void Configure(double indirectFraction) {
+  gEnabled = true;
+  gIndirectFraction = std::clamp(indirectFraction, 0.0, 1.0);
+}
+
+bool Enabled() { return gEnabled; }
+
+double IndirectFraction() { return gIndirectFraction; }
+
+void MarkCounted(const G4Track& track, int pmtId) { Counted().pmts[track.GetTrackID()] = pmtId; }
+
+bool IsDirectArrival(const G4Track& track, int pmtId, const G4ThreeVector& entry) {
+  auto& counted = Counted();
+  const auto it = counted.pmts.find(track.GetTrackID());
+  if (it == counted.pmts.end() || it->second != pmtId) return false;
+  counted.pmts.erase(it); // the photon ends at the photocathode
+  // Rayleigh/Mie and every reflection turn the photon off its emission ray;
+  // a scattered photon landing back on that line has measure zero.
+  const auto offset = entry - track.GetVertexPosition();
+  const auto& dir = track.GetVertexMomentumDirection();
+  return offset.dot(dir) > 0.0 && offset.cross(dir).mag2() < 1e-6 * mm2;
+}
+
+} // namespace DirectLight
+
+DirectLightModel::DirectLightModel(const G4String& name, G4Region* region)
+  : G4VFastSimulationModel(name, region) {
+  fPMTs = GeometryRegistry::Instance().Snapshot();
+  auto* cathode = G4LogicalVolumeStore::GetInstance()->GetVolume("PMT_cathode_log", /*verbose=*/false);
+  if (auto* tubs = cathode ? dynamic_cast<G4Tubs*>(cathode->GetSolid()) : nullptr) {
+    fCathodeRadius2 = tubs->GetOuterRadius() * tubs->GetOuterRadius();
+  }
+  auto* params = G4OpticalParameters::Instance();
+  fRayleigh = params->GetProcessActivation("Rayleigh");
+  fMie = params->GetProcessActivation("MieHG");
+  if (!fPMTs || fCathodeRadius2 <= 0.0) {
+    G4cout << "[WARN] DirectLight: no PMT table or photocathode disc; direct light disabled" << G4endl;
+    fPMTs = nullptr;
+    return;
+  }
+  // Without the aperture map every disc is a candidate.
+  if (!SurfaceHits::Ready()) {
+    fAllSlots.resize(fPMTs->Size());
+    std::iota(fAllSlots.begin(), fAllSlots.end(), 0);
+  }
+}
+
+G4bool DirectLightModel::IsApplicable(const G4ParticleDefinition& particle) {
+  return &particle == G4OpticalPhoton::Definition();
+}
+
+G4bool DirectLightModel::ModelTrigger(const G4FastTrack& fastTrack) {
+  // Once per photon, before its first step; tracked indirect photons are left alone.
+  return fPMTs && fastTrack.GetPrimaryTrack()->GetCurrentStepNumber() == 1;
+}
+
+int DirectLightModel::Intersect(const G4ThreeVector& pos, const G4ThreeVector& dir,
+                                double& distance) const {
+  int best = -1;
+  distance = std::numeric_limits<double>::infinity();
+  const auto& t = *fPMTs;
+  const std::vector<int>* slots = &fAllSlots;
+  if (SurfaceHits::Ready()) {
+    SurfaceHits::Candidates(pos, dir, SurfaceHits::ExitDistance(pos, dir), tCandidates);
+    slots = &tCandidates;
+  }
+  for (const int s : *slots) {
+    // Only the water-facing side: the ray must run against the normal.
+    const double cosIn = dir.x() * t.nx[s] + dir.y() * t.ny[s] + dir.z() * t.nz[s];
+    if (cosIn >= 0.0) continue;
+    const double wx = t.x[s] - pos.x(), wy = t.y[s] - pos.y(), wz = t.z[s] - pos.z();
+    const double d = (wx * t.nx[s] + wy * t.ny[s] + wz * t.nz[s]) / cosIn;
+    if (d <= 0.0 || d >= distance) continue;
+    const double px = pos.x() + d * dir.x() - t.x[s];
+    const double py = pos.y() + d * dir.y() - t.y[s];
+    const double pz = pos.z() + d * dir.z() - t.z[s];
+    if (px * px + py * py + pz * pz > fCathodeRadius2) continue;
+    best = s;
+    distance = d;
+  }
+  return best;
+}
+
+double DirectLightModel::InverseAttenuationLength(const G4MaterialPropertiesTable* mpt,
+                                                  double energy) const {
+  auto inverse = [&](const char* key) {
+    const double length = PropertyValue(mpt, key, energy);
+    return length > 0.0 ? 1.0 / length : 0.0;
+  };
+  double inv = inverse("ABSLENGTH");
+  if (fRayleigh) inv += inverse("RAYLEIGH");
+  if (fMie) inv += inverse("MIEHG");
+  return inv;
+}
+
+void DirectLightModel::Deposit(const G4Track& track, int pmtId, double time, double weight,
+                               double path) {
+  const G4double energy = track.GetTotalEnergy();
+  const G4double wavelength_nm = energy > 0.0 ? (h_Planck * c_light / energy) / nm : 0.0;
+  PMTHit hit(pmtId, time, weight, wavelength_nm, /*flags=*/0);
+  hit.path_length = path; // unscattered by construction
+  if (const auto* tag = dynamic_cast<const OpticalSubEvent::PhotonTag*>(track.GetUserInformation())) {
+    OpticalSubEvent::AddHit(*tag, hit);
+    PhotonRecords::Add(tag->Key(), tag->T0ns(), hit);
+    return;
+  }
+  const auto* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  PhotonRecords::Add(PrimaryVertexInfo::KeyOf(event), PrimaryVertexInfo::T0nsOf(event), hit);
+  auto* hce = event ? event->GetHCofThisEvent() : nullptr;
+  if (!hce) return;
+  if (fHCId < 0) fHCId = G4SDManager::GetSDMpointer()->GetCollectionID("PMTSD/OpticalHits");
+  if (auto* hits = fHCId >= 0 ? static_cast<PMTHitsCollection*>(hce->GetHC(fHCId)) : nullptr) {
+    hits->insert(new PMTHit(hit));
+  }
+}
+
+void DirectLightModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) {
+  const G4Track& track = *fastTrack.GetPrimaryTrack();
+  const G4double energy = track.GetTotalEnergy();
+  // PMT table coordinates are local to the water can (the envelope).
+  const auto pos = fastTrack.GetPrimaryTrackLocalPosition();
+  const auto dir = fastTrack.GetPrimaryTrackLocalDirection();
+
+  double d = 0.0;
+  const int slot = Intersect(pos, dir, d);
+  if (slot >= 0) {
+    const auto* mpt = track.GetMaterial()->GetMaterialPropertiesTable();
+    if (G4UniformRand() < std::exp(-d * InverseAttenuationLength(mpt, energy))) {
+      double vg = PropertyValue(mpt, "GROUPVEL", energy);
+      if (vg <= 0.0) {
+        const double n = PropertyValue(mpt, "RINDEX", energy);
+        vg = c_light / (n > 0.0 ? n : 1.0);
+      }
+      Deposit(track, fPMTs->id[slot], track.GetGlobalTime() + d / vg, track.GetWeight(),
+              track.GetTrackLength() + d);
+    }
+  }
+
+  // Scattered and reflected light: track a thinned subsample at weight w/f.
+  const double f = DirectLight::IndirectFraction();
+  if (f > 0.0 && G4UniformRand() < f) {
+    fastStep.ProposePrimaryTrackFinalEventBiasingWeight(track.GetWeight() / f);
+    if (slot >= 0) DirectLight::MarkCounted(track, fPMTs->id[slot]);
+    return;
+  }
+  fastStep.KillPrimaryTrack();
+}
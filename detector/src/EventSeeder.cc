@@ -0,0 +1,117 @@
+#include "EventSeeder.hh"
+
+#include <Randomize.hh>
+
+#include <atomic>
+#include <cmath>
+
+namespace {
+
+constexpr std::uint32_t kPhiloxM0 = 0xD2511F53u;
+constexpr std::uint32_t kPhiloxM1 = 0xCD9E8D57u;
+constexpr std::uint32_t kPhiloxW0 = 0x9E3779B9u;
+constexpr std::uint32_t kPhiloxW1 = 0xBB67AE85u;
+
+std::atomic<std::uint64_t> gRunSeed{0};
+std::atomic<bool> gPerEvent{false};
+
+inline void MulHiLo(std::uint32_t a, std::uint32_t b, std::uint32_t& hi, std::uint32_t& lo) {
+  const std::uint64_t p = static_cast<std::uint64_t>(a) * b;
+  hi = static_cast<std::uint32_t>(p >> 32);
+  lo = static_cast<std::uint32_t>(p);
+}
+
+} // namespace
+
+namespace EventSeeder {
+
+std::array<std::uint32_t, 4> Philox4x32(std::array<std::uint32_t, 4> ctr,
+                                        std::array<std::uint32_t, 2> key) {
+  for (int round = 0; round < 10; ++round) {
+    if (round > 0) {
+      key[0] += kPhiloxW0;
+      key[1] += kPhiloxW1;
+    }
+    std::uint32_t hi0, lo0, hi1, lo1;
+    MulHiLo(kPhiloxM0, ctr[0], hi0, lo0);
+    MulHiLo(kPhiloxM1, ctr[2], hi1, lo1);
+    ctr = {hi1 ^ ctr[1] ^ key[0], lo1, hi0 ^ ctr[3] ^ key[1], lo0};
+  }
+  return ctr;
+}
+
+void Configure(std::uint64_t runSeed, bool perEvent) {
+  gRunSeed.store(runSeed, std::memory_order_relaxed);
+  gPerEvent.store(perEvent, std::memory_order_relaxed);
+}
+
+bool Enabled() { return gPerEvent.load(std::memory_order_relaxed); }
+
+std::uint64_t RunSeed() { return gRunSeed.load(std::memory_order_relaxed); }
+
+void SeedEvent(long long key, std::uint32_t stream) {
+  if (!Enabled()) return;
+  const std::uint64_t seed = RunSeed();
+  const std::uint64_t k = static_cast<std::uint64_t>(key);
+  const auto words = Philox4x32({static_cast<std::uint32_t>(k), static_cast<std::uint32_t>(k >> 32), stream, 0u},
+                                {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)});
+  // Engines accept positive 31-bit seeds (Ranecu needs them non-zero); the
+  // list is zero-terminated for engines that scan until 0 (MixMax, Ranlux).
+  long seeds[5] = {0, 0, 0, 0, 0};
+  for (int i = 0; i < 4; ++i) {
+    const long s = static_cast<long>(words[i] & 0x7fffffffu);
+    seeds[i] = s ? s : 1;
+  }
+  G4Random::setTheSeeds(seeds, 4);
+}
+
+PhiloxStream::PhiloxStream(std::uint64_t key, std::uint32_t id)
+: fKey{static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)}, fId(id) {}
+
+std::uint32_t PhiloxStream::Next() {
+  if (fUsed == 4) {
+    fWords = Philox4x32({fBlock++, fId, 0u, 0u}, fKey);
+    fUsed = 0;
+  }
+  return fWords[fUsed++];
+}
+
+double PhiloxStream::Flat() {
+  // 53 random bits, offset by half a step so 0 and 1 never come out.
+  const std::uint64_t hi = Next() >> 5;
+  const std::uint64_t lo = Next() >> 6;
+  return ((hi << 26 | lo) + 0.5) * 0x1p-53;
+}
+
+double PhiloxStream::Gauss(double mean, double sigma) {
+  if (fHasSpare) {
+    fHasSpare = false;
+    return mean + sigma * fSpare;
+  }
+  // Box-Muller; keep the second variate for the next call.
+  const double r = std::sqrt(-2.0 * std::log(Flat()));
+  const double phi = 2.0 * M_PI * Flat();
+  fSpare = r * std::sin(phi);
+  fHasSpare = true;
+  return mean + sigma * r * std::cos(phi);
+}
+
+long PhiloxStream::Poisson(double mean) {
+  if (mean <= 0.0) return 0;
+  // As G4Poisson: direct inversion up to mean 16, Gaussian approximation above.
+  if (mean <= 16.0) {
+    const double limit = std::exp(-mean);
+    double prod = Flat();
+    long k = 0;
+    while (prod > limit) {
+      prod *= Flat();
+      ++k;
+    }
+    return k;
+  }
+  const double value = mean + Gauss(0.0, 1.0) * std::sqrt(mean) + 0.5;
+  if (value <= 0.0) return 0;
+  return value >= 2.0e9 ? 2000000000L : static_cast<long>(value);
+}
+
+} // namespace EventSeeder
@@ -1,6 +1,16 @@
 #include "GeometryRegistry.hh"
 
 #include <algorithm>
+#include <numeric>
+
+int PMTSnapshot::Slot(int pmtId) const {
+  if (!slotOfId.empty()) {
+    const auto off = static_cast<std::size_t>(static_cast<long long>(pmtId) - minId);
+    return off < slotOfId.size() ? slotOfId[off] : -1;
+  }
+  auto it = std::lower_bound(id.begin(), id.end(), pmtId);
+  return (it != id.end() && *it == pmtId) ? static_cast<int>(it - id.begin()) : -1;
+}
 
 GeometryRegistry& GeometryRegistry::Instance() {
   static GeometryRegistry instance;
@@ -10,26 +20,75 @@ GeometryRegistry& GeometryRegistry::Instance() {
 void GeometryRegistry::ClearPMTs() {
   std::lock_guard<std::mutex> lock(fMutex);
   fPMTs.clear();
+  fIndex.clear();
 }
 
 void GeometryRegistry::RegisterPMT(int id, const G4ThreeVector& position, const G4ThreeVector& normal) {
   std::lock_guard<std::mutex> lock(fMutex);
-  auto it = std::find_if(fPMTs.begin(), fPMTs.end(), [id](const PMTRecord& rec) { return rec.id == id; });
   PMTRecord rec;
   rec.id = id;
   rec.position = position;
   rec.normal = normal;
-  if (it != fPMTs.end()) {
-    *it = rec;
-  } else {
+  auto [it, inserted] = fIndex.emplace(id, fPMTs.size());
+  if (inserted) {
     fPMTs.push_back(rec);
+  } else {
+    fPMTs[it->second] = rec;
   }
 }
 
+void GeometryRegistry::Freeze() {
+  std::lock_guard<std::mutex> lock(fMutex);
+  auto snap = std::make_unique<PMTSnapshot>();
+  const std::size_t n = fPMTs.size();
+
+  std::vector<std::size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&](std::size_t a, std::size_t b) { return fPMTs[a].id < fPMTs[b].id; });
+
+  snap->id.reserve(n);
+  for (auto* v : {&snap->x, &snap->y, &snap->z, &snap->nx, &snap->ny, &snap->nz}) v->reserve(n);
+  for (std::size_t i : order) {
+    const auto& rec = fPMTs[i];
+    snap->id.push_back(rec.id);
+    snap->x.push_back(rec.position.x());
+    snap->y.push_back(rec.position.y());
+    snap->z.push_back(rec.position.z());
+    snap->nx.push_back(rec.normal.x());
+    snap->ny.push_back(rec.normal.y());
+    snap->nz.push_back(rec.normal.z());
+  }
+
+  // Copy numbers are normally 0..N-1; keep a direct table unless they are sparse.
+  if (n > 0) {
+    const long long span = static_cast<long long>(snap->id.back()) - snap->id.front() + 1;
+    if (span <= static_cast<long long>(4 * n + 1024)) {
+      snap->minId = snap->id.front();
+      snap->slotOfId.assign(static_cast<std::size_t>(span), -1);
+      for (std::size_t s = 0; s < n; ++s) {
+        snap->slotOfId[static_cast<std::size_t>(snap->id[s] - snap->minId)] = static_cast<int>(s);
+      }
+    }
+  }
+
+  fSnapshot.store(snap.get(), std::memory_order_release);
+  fSnapshots.push_back(std::move(snap));
+}
+
 bool GeometryRegistry::GetPMT(int id, PMTRecord& out) const {
+  if (const auto* snap = Snapshot()) {
+    const int slot = snap->Slot(id);
+    if (slot < 0) return false;
+    out.id = id;
+    out.position = snap->Position(slot);
+    out.normal = snap->Normal(slot);
+    return true;
+  }
+  // Not frozen yet (construction in progress).
   std::lock_guard<std::mutex> lock(fMutex);
-  auto it = std::find_if(fPMTs.begin(), fPMTs.end(), [id](const PMTRecord& rec) { return rec.id == id; });
-  if (it == fPMTs.end()) return false;
-  out = *it;
+  auto it = fIndex.find(id);
+  if (it == fIndex.end()) return false;
+  out = fPMTs[it->second];
   return true;
 }
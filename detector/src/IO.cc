@@ -1,5 +1,6 @@
 // src/IO.cc
 #include "IO.hh"
+#include "OutputMerge.hh"
 #include "RunManifest.hh"
 #include <TNamed.h>
 
@@ -7,7 +8,8 @@ IORunAction::IORunAction(const std::string& path, const DigitizerParams& P)
 : G4UserRunAction(), dig(P), outpath_(path) {}
 
 void IORunAction::BeginOfRunAction(const G4Run*) {
-  f = TFile::Open(outpath_.c_str(), "RECREATE");
+  // One file per worker thread; TTree::Fill is never shared across threads.
+  f = TFile::Open(OutputMerge::ShardPath(outpath_).c_str(), "RECREATE");
   thits = new TTree("hits","digitized hits");
   thits->Branch("event",&b_event,"event/I");
   thits->Branch("pmt",&b_pmt,"pmt/S");
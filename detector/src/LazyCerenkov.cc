@@ -0,0 +1,443 @@
+#include "LazyCerenkov.hh"
+
+#include "PrimaryVertexInfo.hh"
+
+#include <G4DynamicParticle.hh>
+#include <G4Event.hh>
+#include <G4EventManager.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4Poisson.hh>
+#include <G4StackManager.hh>
+#include <G4Step.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4Track.hh>
+#include <G4ios.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+int gChunk = 0;
+
+std::atomic<unsigned long long> gSegments{0};
+std::atomic<unsigned long long> gPhotons{0};
+std::atomic<unsigned long long> gPeakSegments{0};
+std::atomic<unsigned long long> gEventsWritten{0};
+std::atomic<unsigned long long> gEventsRead{0};
+std::atomic<unsigned long long> gDropped{0};
+
+// Same constant as G4Cerenkov: photons per (eV * cm) at unit charge.
+const double kRfact = 369.81 / (eV * cm);
+// Deferred photons get ids above anything the event manager hands out.
+constexpr int kFirstTrackId = 1000000000;
+
+// RINDEX of one material; shared by all segments in it.
+struct RindexTable {
+  std::string material;
+  std::vector<double> energy, rindex;
+  double nMax = 0.0;
+
+  double N(double e) const {
+    const auto it = std::upper_bound(energy.begin(), energy.end(), e);
+    if (it == energy.begin()) return rindex.front();
+    if (it == energy.end()) return rindex.back();
+    const std::size_t i = static_cast<std::size_t>(it - energy.begin());
+    const double f = (e - energy[i - 1]) / (energy[i] - energy[i - 1]);
+    return rindex[i - 1] + f * (rindex[i] - rindex[i - 1]);
+  }
+
+  // Integral over energy of (1 - 1/(beta n)^2) where it is positive.
+  double YieldIntegral(double betaInv) const {
+    double sum = 0.0;
+    for (std::size_t i = 1; i < energy.size(); ++i) {
+      const double f0 = std::max(0.0, 1.0 - betaInv * betaInv / (rindex[i - 1] * rindex[i - 1]));
+      const double f1 = std::max(0.0, 1.0 - betaInv * betaInv / (rindex[i] * rindex[i]));
+      sum += 0.5 * (f0 + f1) * (energy[i] - energy[i - 1]);
+    }
+    return sum;
+  }
+};
+
+struct Segment {
+  G4ThreeVector x0, x1, dir;
+  double t0 = 0.0, t1 = 0.0;
+  double betaInv = 1.0;
+  double mean = 0.0;       // expected photon count
+  double length = 0.0;     // true path length
+  double charge = 0.0;     // [eplus]
+  const RindexTable* table = nullptr;
+  int trackId = 0;
+  int remaining = -1;      // photons left to emit; sampled on first use
+};
+
+struct State {
+  std::vector<Segment> segments;
+  std::vector<Segment> loaded;  // stage 2: next event, taken over by BeginEvent
+  std::size_t next = 0;
+  int nextTrackId = kFirstTrackId;
+  std::unordered_map<const G4Material*, RindexTable> tables;
+};
+thread_local State tState;
+
+const RindexTable* TableFor(const G4Material* material) {
+  auto& tables = tState.tables;
+  const auto it = tables.find(material);
+  if (it != tables.end()) return it->second.energy.empty() ? nullptr : &it->second;
+  RindexTable& table = tables[material];
+  table.material = material->GetName();
+  const auto* mpt = material->GetMaterialPropertiesTable();
+  auto* vec = mpt ? mpt->GetProperty("RINDEX") : nullptr;
+  if (!vec || vec->GetVectorLength() < 2) return nullptr;
+  for (std::size_t i = 0; i < vec->GetVectorLength(); ++i) {
+    table.energy.push_back(vec->Energy(i));
+    table.rindex.push_back((*vec)[i]);
+    table.nMax = std::max(table.nMax, (*vec)[i]);
+  }
+  return &table;
+}
+
+double MeanPhotons(const RindexTable& table, double betaInv, double charge, double length) {
+  return kRfact * charge * charge * table.YieldIntegral(betaInv) * length;
+}
+
+// Segment file: a FileHeader, then per event an EventHeader, the names of
+// the materials its segments refer to (u32 length + bytes each) and the
+// segment records. Times are relative to the event t0 so floats keep ps
+// resolution however late the event starts.
+constexpr char kMagic[8] = {'F', 'L', 'N', 'D', 'R', 'S', 'G', '1'};
+constexpr std::uint32_t kVersion = 1;
+
+struct FileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t recordSize;
+};
+struct EventHeader {
+  std::int64_t key;
+  double t0ns;
+  double x0[3];           // [mm]
+  std::uint32_t nMaterials;
+  std::uint32_t nSegments;
+};
+struct SegmentRecord {
+  float x0[3], x1[3];     // [mm]
+  float dir[3];
+  float t0, t1;           // [ns] after the event t0
+  float betaInv;
+  float length;           // [mm]
+  float charge;           // [eplus]
+  std::int32_t trackId;
+  std::int32_t material;  // index into the event's material names
+};
+static_assert(sizeof(SegmentRecord) == 64, "segment records are written as raw bytes");
+
+std::mutex gFileMutex;
+std::ofstream gOut;
+std::ifstream gIn;
+std::string gOutPath, gInPath;
+
+void WriteEvent(const State& st) {
+  const auto* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  EventHeader header{};
+  header.key = PrimaryVertexInfo::KeyOf(event);
+  header.t0ns = PrimaryVertexInfo::T0nsOf(event);
+  const G4ThreeVector x0 = PrimaryVertexInfo::X0Of(event);
+  header.x0[0] = x0.x() / mm;
+  header.x0[1] = x0.y() / mm;
+  header.x0[2] = x0.z() / mm;
+
+  std::vector<const RindexTable*> materials;
+  std::vector<SegmentRecord> records;
+  records.reserve(st.segments.size() - st.next);
+  for (std::size_t i = st.next; i < st.segments.size(); ++i) {
+    const Segment& seg = st.segments[i];
+    auto it = std::find(materials.begin(), materials.end(), seg.table);
+    if (it == materials.end()) it = materials.insert(materials.end(), seg.table);
+    SegmentRecord rec{};
+    for (int a = 0; a < 3; ++a) {
+      rec.x0[a] = static_cast<float>(seg.x0[a] / mm);
+      rec.x1[a] = static_cast<float>(seg.x1[a] / mm);
+      rec.dir[a] = static_cast<float>(seg.dir[a]);
+    }
+    rec.t0 = static_cast<float>(seg.t0 / ns - header.t0ns);
+    rec.t1 = static_cast<float>(seg.t1 / ns - header.t0ns);
+    rec.betaInv = static_cast<float>(seg.betaInv);
+    rec.length = static_cast<float>(seg.length / mm);
+    rec.charge = static_cast<float>(seg.charge);
+    rec.trackId = seg.trackId;
+    rec.material = static_cast<std::int32_t>(it - materials.begin());
+    records.push_back(rec);
+  }
+  header.nMaterials = static_cast<std::uint32_t>(materials.size());
+  header.nSegments = static_cast<std::uint32_t>(records.size());
+
+  // One locked write per event, so workers never interleave records.
+  std::lock_guard<std::mutex> lock(gFileMutex);
+  gOut.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const auto* table : materials) {
+    const auto n = static_cast<std::uint32_t>(table->material.size());
+    gOut.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    gOut.write(table->material.data(), n);
+  }
+  gOut.write(reinterpret_cast<const char*>(records.data()),
+             static_cast<std::streamsize>(records.size() * sizeof(SegmentRecord)));
+  if (!gOut) {
+    G4Exception("LazyCerenkov::WriteEvent", "SegmentWrite", FatalException,
+                ("write to '" + gOutPath + "' failed").c_str());
+  }
+  gEventsWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+// One photon from `seg`, sampled as in G4Cerenkov::PostStepDoIt.
+G4Track* MakePhoton(const Segment& seg) {
+  const auto& table = *seg.table;
+  const double eMin = table.energy.front();
+  const double eMax = table.energy.back();
+  const double cosMax = seg.betaInv / table.nMax;
+  const double maxSin2 = (1.0 - cosMax) * (1.0 + cosMax);
+  double energy = 0.0, cosTheta = 0.0, sin2Theta = 0.0;
+  do {
+    energy = eMin + G4UniformRand() * (eMax - eMin);
+    cosTheta = seg.betaInv / table.N(energy);
+    sin2Theta = (1.0 - cosTheta) * (1.0 + cosTheta);
+  } while (G4UniformRand() * maxSin2 > sin2Theta);
+
+  const double sinTheta = std::sqrt(std::max(0.0, sin2Theta));
+  const double phi = twopi * G4UniformRand();
+  G4ThreeVector dir(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+  dir.rotateUz(seg.dir);
+  G4ThreeVector pol(cosTheta * std::cos(phi), cosTheta * std::sin(phi), -sinTheta);
+  pol.rotateUz(seg.dir);
+
+  const double frac = G4UniformRand();
+  auto* particle = new G4DynamicParticle(G4OpticalPhoton::Definition(), dir, energy);
+  particle->SetPolarization(pol);
+  auto* track = new G4Track(particle, seg.t0 + frac * (seg.t1 - seg.t0),
+                            seg.x0 + frac * (seg.x1 - seg.x0));
+  track->SetParentID(seg.trackId);
+  track->SetTrackID(++tState.nextTrackId);
+  return track;
+}
+
+} // namespace
+
+namespace LazyCerenkov {
+
+void Configure(int chunk) { gChunk = std::max(0, chunk); }
+
+bool Enabled() { return gChunk > 0; }
+
+int ChunkSize() { return gChunk; }
+
+void WriteTo(const std::string& path) {
+  const auto dir = std::filesystem::path(path).parent_path();
+  if (!dir.empty()) std::filesystem::create_directories(dir);
+  gOut.open(path, std::ios::binary | std::ios::trunc);
+  if (!gOut) throw std::runtime_error("LazyCerenkov: cannot create segment file '" + path + "'");
+  FileHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.recordSize = sizeof(SegmentRecord);
+  gOut.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  gOutPath = path;
+}
+
+void ReadFrom(const std::string& path) {
+  gIn.open(path, std::ios::binary);
+  if (!gIn) throw std::runtime_error("LazyCerenkov: cannot open segment file '" + path + "'");
+  FileHeader header{};
+  gIn.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!gIn || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion || header.recordSize != sizeof(SegmentRecord)) {
+    throw std::runtime_error("LazyCerenkov: '" + path + "' is not a version-" +
+                             std::to_string(kVersion) + " segment file");
+  }
+  gInPath = path;
+}
+
+bool Writing() { return !gOutPath.empty(); }
+
+bool Replaying() { return !gInPath.empty(); }
+
+bool LoadNextEvent(long long& key, double& t0ns, G4ThreeVector& x0) {
+  if (!Replaying()) return false;
+  EventHeader header{};
+  std::vector<std::string> names;
+  std::vector<SegmentRecord> records;
+  {
+    std::lock_guard<std::mutex> lock(gFileMutex);
+    gIn.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (gIn.gcount() == 0 && gIn.eof()) return false;
+    for (std::uint32_t m = 0; gIn && m < header.nMaterials; ++m) {
+      std::uint32_t n = 0;
+      gIn.read(reinterpret_cast<char*>(&n), sizeof(n));
+      std::string name(n, '\0');
+      gIn.read(name.data(), n);
+      names.push_back(std::move(name));
+    }
+    records.resize(header.nSegments);
+    gIn.read(reinterpret_cast<char*>(records.data()),
+             static_cast<std::streamsize>(records.size() * sizeof(SegmentRecord)));
+    if (!gIn) {
+      G4Exception("LazyCerenkov::LoadNextEvent", "SegmentRead", JustWarning,
+                  ("'" + gInPath + "' ends inside an event; treating it as the end of file").c_str());
+      return false;
+    }
+  }
+  gEventsRead.fetch_add(1, std::memory_order_relaxed);
+
+  // Stage-2 RINDEX: the material names resolve to this run's optics.
+  std::vector<const RindexTable*> tables;
+  for (const auto& name : names) {
+    const auto* material = G4Material::GetMaterial(name, /*warning=*/false);
+    tables.push_back(material ? TableFor(material) : nullptr);
+  }
+  auto& loaded = tState.loaded;
+  loaded.clear();
+  for (const auto& rec : records) {
+    const auto* table = rec.material >= 0 && static_cast<std::size_t>(rec.material) < tables.size()
+                          ? tables[rec.material] : nullptr;
+    const double mean = table && rec.betaInv < table->nMax
+                          ? MeanPhotons(*table, rec.betaInv, rec.charge, rec.length * mm) : 0.0;
+    if (mean <= 0.0) {
+      gDropped.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    Segment seg;
+    seg.x0.set(rec.x0[0] * mm, rec.x0[1] * mm, rec.x0[2] * mm);
+    seg.x1.set(rec.x1[0] * mm, rec.x1[1] * mm, rec.x1[2] * mm);
+    seg.dir.set(rec.dir[0], rec.dir[1], rec.dir[2]);
+    seg.t0 = (header.t0ns + rec.t0) * ns;
+    seg.t1 = (header.t0ns + rec.t1) * ns;
+    seg.betaInv = rec.betaInv;
+    seg.mean = mean;
+    seg.length = rec.length * mm;
+    seg.charge = rec.charge;
+    seg.table = table;
+    seg.trackId = rec.trackId;
+    loaded.push_back(seg);
+  }
+  gSegments.fetch_add(loaded.size(), std::memory_order_relaxed);
+  key = header.key;
+  t0ns = header.t0ns;
+  x0.set(header.x0[0] * mm, header.x0[1] * mm, header.x0[2] * mm);
+  return true;
+}
+
+void Record(const G4Step* step) {
+  if (!Enabled()) return;
+  const auto* pre = step->GetPreStepPoint();
+  const auto* post = step->GetPostStepPoint();
+  const double charge = pre->GetCharge();
+  if (charge == 0.0 || step->GetStepLength() <= 0.0) return;
+  const auto* table = TableFor(pre->GetMaterial());
+  if (!table) return;
+
+  // Mean velocity over the step, as G4Cerenkov does.
+  const double beta = 0.5 * (pre->GetBeta() + post->GetBeta());
+  if (beta <= 0.0) return;
+  const double betaInv = 1.0 / beta;
+  if (betaInv >= table->nMax) return; // below threshold
+  const double mean = MeanPhotons(*table, betaInv, charge / eplus, step->GetStepLength());
+  if (mean <= 0.0) return;
+
+  Segment seg;
+  seg.x0 = pre->GetPosition();
+  seg.x1 = post->GetPosition();
+  seg.dir = pre->GetMomentumDirection();
+  seg.t0 = pre->GetGlobalTime();
+  seg.t1 = post->GetGlobalTime();
+  seg.betaInv = betaInv;
+  seg.mean = mean;
+  seg.length = step->GetStepLength();
+  seg.charge = charge / eplus;
+  seg.table = table;
+  seg.trackId = step->GetTrack()->GetTrackID();
+  auto& segments = tState.segments;
+  segments.push_back(seg);
+  gSegments.fetch_add(1, std::memory_order_relaxed);
+
+  const unsigned long long pending = segments.size() - tState.next;
+  unsigned long long peak = gPeakSegments.load(std::memory_order_relaxed);
+  while (pending > peak && !gPeakSegments.compare_exchange_weak(peak, pending)) {}
+}
+
+void BeginEvent() {
+  auto& st = tState;
+  st.segments.clear();
+  st.next = 0;
+  st.nextTrackId = kFirstTrackId;
+  // The generator runs before the event's stacks are prepared.
+  if (Replaying()) st.segments.swap(st.loaded);
+}
+
+int Emit(G4StackManager* stack) {
+  if (!Enabled() || !stack) return 0;
+  auto& st = tState;
+  if (Writing()) {
+    // Stage 1: nothing is emitted, so an empty urgent stack ends the event.
+    if (stack->GetNUrgentTrack() == 0) {
+      WriteEvent(st);
+      st.segments.clear();
+      st.next = 0;
+    }
+    return 0;
+  }
+  int pushed = 0;
+  while (pushed < gChunk && st.next < st.segments.size()) {
+    auto& seg = st.segments[st.next];
+    if (seg.remaining < 0) seg.remaining = static_cast<int>(G4Poisson(seg.mean));
+    for (; seg.remaining > 0 && pushed < gChunk; --seg.remaining, ++pushed) {
+      stack->PushOneTrack(MakePhoton(seg));
+    }
+    if (seg.remaining == 0) ++st.next;
+  }
+  if (st.next == st.segments.size()) {
+    st.segments.clear(); // every emitter drained; keep the capacity
+    st.next = 0;
+  }
+  gPhotons.fetch_add(static_cast<unsigned long long>(pushed), std::memory_order_relaxed);
+  return pushed;
+}
+
+void ResetCounters() {
+  gSegments = 0;
+  gPhotons = 0;
+  gPeakSegments = 0;
+  gEventsWritten = 0;
+  gEventsRead = 0;
+  gDropped = 0;
+}
+
+void Report() {
+  if (!Enabled()) return;
+  G4cout << "[LazyCerenkov] chunk=" << gChunk << " segments=" << gSegments.load()
+         << " photons=" << gPhotons.load() << " peak_pending_segments=" << gPeakSegments.load()
+         << " (" << (gPeakSegments.load() * sizeof(Segment)) / 1024 << " KiB)" << G4endl;
+  if (Writing()) {
+    std::lock_guard<std::mutex> lock(gFileMutex);
+    gOut.flush();
+    G4cout << "[LazyCerenkov] segments_out=" << gOutPath << " events=" << gEventsWritten.load()
+           << G4endl;
+  }
+  if (Replaying()) {
+    G4cout << "[LazyCerenkov] segments_in=" << gInPath << " events=" << gEventsRead.load()
+           << " dropped_below_threshold=" << gDropped.load() << G4endl;
+  }
+}
+
+} // namespace LazyCerenkov
@@ -0,0 +1,171 @@
+#include "NativeGeometry.hh"
+
+#include <G4Box.hh>
+#include <G4LogicalVolume.hh>
+#include <G4NistManager.hh>
+#include <G4PVPlacement.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4Tubs.hh>
+#include <G4ios.hh>
+
+#include <yaml-cpp/yaml.h>
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::runtime_error ConfigError(const std::string& path, const std::string& what) {
+  return std::runtime_error("Geometry YAML '" + path + "': " + what);
+}
+
+// `key` under `section` scaled by `unit`, or `def` (already in G4 units) if
+// absent. Must be > 0.
+double GetLength(const YAML::Node& section, const char* key, double unit, double def,
+                 const std::string& path, const char* sectionName) {
+  const auto node = section ? section[key] : YAML::Node();
+  if (!node || node.IsNull()) {
+    if (def > 0.0) return def;
+    throw ConfigError(path, std::string("missing '") + sectionName + "." + key + "'");
+  }
+  double value = 0.0;
+  try {
+    value = node.as<double>() * unit;
+  } catch (const YAML::BadConversion&) {
+    throw ConfigError(path, std::string("'") + sectionName + "." + key + "' is not a number");
+  }
+  if (!(value > 0.0)) {
+    throw ConfigError(path, std::string("'") + sectionName + "." + key + "' must be > 0");
+  }
+  return value;
+}
+
+unsigned ParseFaces(const YAML::Node& node, const std::string& path) {
+  if (!node.IsSequence()) throw ConfigError(path, "'pmt.faces' must be a list such as [+x, -x, +y, -y]");
+  unsigned faces = 0;
+  for (const auto& item : node) {
+    const std::string name = item.as<std::string>();
+    if (name == "+x") faces |= kBoxFacePosX;
+    else if (name == "-x") faces |= kBoxFaceNegX;
+    else if (name == "+y") faces |= kBoxFacePosY;
+    else if (name == "-y") faces |= kBoxFaceNegY;
+    else if (name == "+z") faces |= kBoxFacePosZ;
+    else if (name == "-z") faces |= kBoxFaceNegZ;
+    else throw ConfigError(path, "unknown face '" + name + "' in 'pmt.faces' (+x -x +y -y +z -z)");
+  }
+  return faces;
+}
+
+} // namespace
+
+namespace NativeGeometry {
+
+NativeGeometryConfig LoadFromYaml(const std::string& path) {
+  YAML::Node root = YAML::LoadFile(path);
+  if (!root || !root.IsMap()) {
+    throw ConfigError(path, "empty or not a map");
+  }
+  NativeGeometryConfig cfg;
+  cfg.path = path;
+
+  const auto can = root["can"];
+  if (!can || !can.IsMap()) throw ConfigError(path, "missing 'can' section");
+  if (const auto shape = can["shape"]) cfg.shape = shape.as<std::string>();
+  if (cfg.shape == "tubs") {
+    cfg.canRadius = GetLength(can, "radius_m", m, 0.0, path, "can");
+    cfg.canHalfZ = GetLength(can, "half_length_m", m, 0.0, path, "can");
+  } else if (cfg.shape == "box") {
+    cfg.canHalfX = GetLength(can, "half_x_m", m, 0.0, path, "can");
+    cfg.canHalfY = GetLength(can, "half_y_m", m, 0.0, path, "can");
+    cfg.canHalfZ = GetLength(can, "half_z_m", m, 0.0, path, "can");
+  } else {
+    throw ConfigError(path, "'can.shape' must be tubs or box, got '" + cfg.shape + "'");
+  }
+  const double canHalfX = cfg.shape == "tubs" ? cfg.canRadius : cfg.canHalfX;
+  const double canHalfY = cfg.shape == "tubs" ? cfg.canRadius : cfg.canHalfY;
+
+  // World defaults to the can plus 1 m of vacuum on every side.
+  const auto world = root["world"];
+  cfg.worldHalfX = GetLength(world, "half_x_m", m, canHalfX + 1.0 * m, path, "world");
+  cfg.worldHalfY = GetLength(world, "half_y_m", m, canHalfY + 1.0 * m, path, "world");
+  cfg.worldHalfZ = GetLength(world, "half_z_m", m, cfg.canHalfZ + 1.0 * m, path, "world");
+  if (cfg.worldHalfX < canHalfX || cfg.worldHalfY < canHalfY || cfg.worldHalfZ < cfg.canHalfZ) {
+    throw ConfigError(path, "the world does not enclose the can");
+  }
+
+  const auto pmt = root["pmt"];
+  auto& spec = cfg.pmts;
+  spec.pmtRadius = GetLength(pmt, "radius_m", m, spec.pmtRadius, path, "pmt");
+  spec.wallGap = GetLength(pmt, "wall_gap_mm", mm, spec.wallGap, path, "pmt");
+  spec.zPitch = GetLength(pmt, "z_pitch_m", m, spec.zPitch, path, "pmt");
+  spec.xPitch = GetLength(pmt, "x_pitch_m", m, spec.xPitch, path, "pmt");
+  spec.yPitch = GetLength(pmt, "y_pitch_m", m, spec.yPitch, path, "pmt");
+  if (pmt && pmt["n_phi"]) spec.nPhi = pmt["n_phi"].as<int>();
+  if (pmt && pmt["faces"]) spec.boxFaces = ParseFaces(pmt["faces"], path);
+
+  // Neighbouring discs must not overlap.
+  const double diameter = 2.0 * spec.pmtRadius;
+  if (spec.zPitch < diameter || (cfg.shape == "box" && (spec.xPitch < diameter || spec.yPitch < diameter))) {
+    throw ConfigError(path, "PMT pitch is smaller than the disc diameter");
+  }
+  if (cfg.shape == "tubs") {
+    if (spec.nPhi < 1) throw ConfigError(path, "'pmt.n_phi' must be >= 1");
+    const double ringRadius = cfg.canRadius - spec.wallGap - spec.pmtRadius;
+    if (ringRadius < spec.pmtRadius + spec.wallGap) {
+      throw ConfigError(path, "the can radius leaves no room for the PMT ring");
+    }
+    // Warn only: the GDML default (r = 1.5 m, 48 per ring) is already this tight.
+    if (spec.nPhi > 1 && 2.0 * ringRadius * std::sin(pi / spec.nPhi) < diameter) {
+      G4cout << "[WARN] Geometry YAML '" << path << "': " << spec.nPhi
+             << " discs per ring are closer than a disc diameter; check with --check_overlaps_n" << G4endl;
+    }
+  } else if (spec.boxFaces == 0) {
+    throw ConfigError(path, "'pmt.faces' is empty");
+  }
+  return cfg;
+}
+
+G4VPhysicalVolume* Build(const NativeGeometryConfig& cfg, const std::string& canName) {
+  auto* nist = G4NistManager::Instance();
+  auto* vacuum = nist->FindOrBuildMaterial("G4_Galactic");
+  auto* water = nist->FindOrBuildMaterial("G4_WATER");
+
+  auto* worldSolid = new G4Box("TopVolume", cfg.worldHalfX, cfg.worldHalfY, cfg.worldHalfZ);
+  auto* worldLV = new G4LogicalVolume(worldSolid, vacuum, "TopVolume");
+  auto* worldPV = new G4PVPlacement(nullptr, {}, worldLV, "TopVolume", nullptr, false, 0, false);
+
+  G4VSolid* canSolid = nullptr;
+  if (cfg.shape == "tubs") {
+    canSolid = new G4Tubs(canName, 0.0, cfg.canRadius, cfg.canHalfZ, 0.0, twopi);
+  } else {
+    canSolid = new G4Box(canName, cfg.canHalfX, cfg.canHalfY, cfg.canHalfZ);
+  }
+  auto* canLV = new G4LogicalVolume(canSolid, water, canName);
+  new G4PVPlacement(nullptr, {}, canLV, canName, worldLV, false, 0, false);
+  return worldPV;
+}
+
+std::string Describe(const NativeGeometryConfig& cfg) {
+  const auto& spec = cfg.pmts;
+  std::ostringstream os;
+  os.setf(std::ios::fixed);
+  os << std::setprecision(3) << cfg.shape;
+  if (cfg.shape == "tubs") {
+    os << " r=" << cfg.canRadius / m << "m halfz=" << cfg.canHalfZ / m << "m";
+  } else {
+    os << " half=" << cfg.canHalfX / m << "x" << cfg.canHalfY / m << "x" << cfg.canHalfZ / m << "m";
+  }
+  os << " world_half=" << cfg.worldHalfX / m << "x" << cfg.worldHalfY / m << "x" << cfg.worldHalfZ / m << "m"
+     << " pmt_r=" << spec.pmtRadius / m << "m gap=" << spec.wallGap / mm << "mm z_pitch=" << spec.zPitch / m << "m";
+  if (cfg.shape == "tubs") {
+    os << " n_phi=" << spec.nPhi;
+  } else {
+    os << " xy_pitch=" << spec.xPitch / m << "/" << spec.yPitch / m << "m faces=0x" << std::hex << spec.boxFaces;
+  }
+  return os.str();
+}
+
+} // namespace NativeGeometry
@@ -0,0 +1,148 @@
+#include "OpticalRoulette.hh"
+
+#include "Digitizer.hh" // FindBoundaryProcess
+
+#include <G4Event.hh>
+#include <G4EventManager.hh>
+#include <G4OpBoundaryProcess.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4Step.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4Track.hh>
+#include <G4ios.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+
+bool gEnabled = false;
+int gReflections = 0;
+double gDistance = 0.0;
+double gSurvival = 1.0;
+
+std::atomic<unsigned long long> gPlayed{0};  // roulette rounds
+std::atomic<unsigned long long> gKilled{0};
+std::atomic<unsigned long long> gHits{0};
+std::atomic<double> gSumW{0.0};
+std::atomic<double> gSumW2{0.0};
+
+void AtomicAdd(std::atomic<double>& target, double value) {
+  double current = target.load(std::memory_order_relaxed);
+  while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {}
+}
+
+struct TrackState {
+  int reflections = 0;
+  int rounds = 0;     // rounds already played
+};
+
+// Per-track tallies of the current event on this thread (track ids are per event).
+struct RouletteState {
+  int eventId = -1;
+  std::unordered_map<int, TrackState> tracks;
+};
+thread_local RouletteState tState;
+
+bool IsReflection(G4OpBoundaryProcessStatus status) {
+  switch (status) {
+    case FresnelReflection:
+    case TotalInternalReflection:
+    case LambertianReflection:
+    case LobeReflection:
+    case SpikeReflection:
+    case BackScattering:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+namespace OpticalRoulette {
+
+void Configure(int reflections, double distanceMm, double survival) {
+  gReflections = std::max(0, reflections);
+  gDistance = std::max(0.0, distanceMm) * mm;
+  gSurvival = std::clamp(survival, 0.0, 1.0);
+  gEnabled = (gReflections > 0 || gDistance > 0.0) && gSurvival > 0.0 && gSurvival < 1.0;
+}
+
+bool Enabled() { return gEnabled; }
+
+bool Apply(const G4Step* step) {
+  if (!gEnabled) return false;
+  auto* track = step->GetTrack();
+  if (track->GetDefinition() != G4OpticalPhoton::Definition()) return false;
+  if (track->GetTrackStatus() == fStopAndKill) return false; // detected or absorbed this step
+
+  const auto* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  const int eventId = event ? event->GetEventID() : -1;
+  if (eventId != tState.eventId) {
+    tState.eventId = eventId;
+    tState.tracks.clear();
+  }
+
+  bool reflected = false;
+  if (gReflections > 0 && step->GetPostStepPoint()->GetStepStatus() == fGeomBoundary) {
+    const auto* boundary = FindBoundaryProcess(track);
+    reflected = boundary && IsReflection(boundary->GetStatus());
+  }
+  const int distanceRounds =
+      gDistance > 0.0 ? static_cast<int>(track->GetTrackLength() / gDistance) : 0;
+  if (!reflected && distanceRounds == 0) return false;
+
+  auto& st = tState.tracks[track->GetTrackID()];
+  if (reflected) ++st.reflections;
+  const int due = (gReflections > 0 ? st.reflections / gReflections : 0) + distanceRounds;
+  if (due <= st.rounds) return false;
+
+  double weight = track->GetWeight();
+  for (; st.rounds < due; ++st.rounds) {
+    gPlayed.fetch_add(1, std::memory_order_relaxed);
+    if (G4UniformRand() >= gSurvival) {
+      track->SetTrackStatus(fStopAndKill);
+      gKilled.fetch_add(1, std::memory_order_relaxed);
+      tState.tracks.erase(track->GetTrackID());
+      return true;
+    }
+    weight /= gSurvival;
+  }
+  track->SetWeight(weight);
+  return false;
+}
+
+void RecordHit(double weight) {
+  if (!gEnabled) return;
+  gHits.fetch_add(1, std::memory_order_relaxed);
+  AtomicAdd(gSumW, weight);
+  AtomicAdd(gSumW2, weight * weight);
+}
+
+void ResetCounters() {
+  gPlayed = 0;
+  gKilled = 0;
+  gHits = 0;
+  gSumW = 0.0;
+  gSumW2 = 0.0;
+}
+
+void Report() {
+  if (!gEnabled) return;
+  const auto played = gPlayed.load();
+  const auto killed = gKilled.load();
+  const double sumW = gSumW.load();
+  const double sumW2 = gSumW2.load();
+  const double ess = sumW2 > 0.0 ? sumW * sumW / sumW2 : 0.0;
+  G4cout << "[Roulette] reflections=" << gReflections << " distance_m=" << gDistance / m
+         << " survival=" << gSurvival << " rounds=" << played << " killed=" << killed
+         << " killed_fraction=" << (played ? static_cast<double>(killed) / played : 0.0)
+         << " hits=" << gHits.load() << " weighted_pe=" << sumW << " ess=" << ess
+         << " ess_fraction=" << (gHits.load() ? ess / gHits.load() : 0.0) << G4endl;
+}
+
+} // namespace OpticalRoulette
@@ -0,0 +1,145 @@
+#include "OpticalSubEvent.hh"
+
+#include "PrimaryVertexInfo.hh"
+
+#include <G4Event.hh>
+#include <G4Track.hh>
+#include <G4Version.hh>
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+std::atomic<int> gBatch{0};
+
+// An event in flight. `open` is the number of routed photons not yet posted
+// by a finished sub-event; it dips below zero when sub-events finish before
+// the parent has posted its count, so completion also needs `closed`.
+struct Pending {
+  OpticalSubEvent::EventHits rec;
+  long long open = 0;
+  bool closed = false;
+};
+std::mutex gSinkMutex;
+std::map<long long, Pending> gSink;
+
+// Parent thread: photons routed per event, posted by CloseEvent.
+thread_local std::map<long long, long long> tRouted;
+
+// Sub-event thread: what the current sub-event collected per parent event.
+struct Batch {
+  long long photons = 0;
+  OpticalSubEvent::EventHits rec;
+};
+thread_local std::map<long long, Batch> tBatch;
+
+// Caller holds gSinkMutex.
+void TakeIfComplete(long long key, std::map<long long, OpticalSubEvent::EventHits>& done) {
+  const auto it = gSink.find(key);
+  if (it == gSink.end() || !it->second.closed || it->second.open != 0) return;
+  done.emplace(key, std::move(it->second.rec));
+  gSink.erase(it);
+}
+
+} // namespace
+
+namespace OpticalSubEvent {
+
+bool Supported() {
+#if G4VERSION_NUMBER >= 1120
+  return true;
+#else
+  return false;
+#endif
+}
+
+void Configure(int batch) { gBatch.store(batch > 0 && Supported() ? batch : 0); }
+
+bool Enabled() { return gBatch.load() > 0; }
+
+int BatchSize() { return gBatch.load(); }
+
+G4ClassificationOfNewTrack Route(const G4Track* track, const G4Event* event) {
+#if G4VERSION_NUMBER >= 1120
+  if (!track->GetUserInformation()) {
+    // ClassifyNewTrack only sees a const track; the tag must travel with it.
+    const long long key = PrimaryVertexInfo::KeyOf(event);
+    const_cast<G4Track*>(track)->SetUserInformation(new PhotonTag(key, PrimaryVertexInfo::T0nsOf(event)));
+    ++tRouted[key];
+  }
+  return static_cast<G4ClassificationOfNewTrack>(fSubEvent + kType);
+#else
+  (void)track;
+  (void)event;
+  return fUrgent;
+#endif
+}
+
+bool IsSubEvent(const G4Event* event) {
+  return Enabled() && event && event->GetNumberOfPrimaryVertex() == 0;
+}
+
+void Arrive(const G4Track* track) {
+  if (const auto* tag = dynamic_cast<const PhotonTag*>(track->GetUserInformation())) {
+    auto& batch = tBatch[tag->Key()];
+    batch.rec.t0_ns = tag->T0ns();
+    ++batch.photons;
+  }
+}
+
+void AddHit(const PhotonTag& tag, const PMTHit& hit) {
+  tBatch[tag.Key()].rec.hits.push_back(hit);
+}
+
+Budget* BudgetOf(const G4Track* track) {
+  if (!Enabled()) return nullptr;
+  const auto* tag = dynamic_cast<const PhotonTag*>(track->GetUserInformation());
+  return tag ? &tBatch[tag->Key()].rec.budget : nullptr;
+}
+
+std::map<long long, EventHits> CloseSubEvent() {
+  std::map<long long, EventHits> done;
+  if (tBatch.empty()) return done;
+  std::lock_guard<std::mutex> lock(gSinkMutex);
+  for (auto& [key, batch] : tBatch) {
+    auto& pending = gSink[key];
+    pending.open -= batch.photons;
+    pending.rec.t0_ns = batch.rec.t0_ns;
+    auto& hits = pending.rec.hits;
+    hits.insert(hits.end(), batch.rec.hits.begin(), batch.rec.hits.end());
+    pending.rec.budget.nProduced += batch.rec.budget.nProduced;
+    pending.rec.budget.nAtWall += batch.rec.budget.nAtWall;
+    pending.rec.budget.nAtPMT += batch.rec.budget.nAtPMT;
+    TakeIfComplete(key, done);
+  }
+  tBatch.clear();
+  return done;
+}
+
+std::map<long long, EventHits> CloseEvent(long long key, double t0_ns) {
+  long long routed = 0;
+  if (const auto it = tRouted.find(key); it != tRouted.end()) {
+    routed = it->second;
+    tRouted.erase(it);
+  }
+  std::map<long long, EventHits> done;
+  std::lock_guard<std::mutex> lock(gSinkMutex);
+  auto& pending = gSink[key];
+  pending.rec.t0_ns = t0_ns;
+  pending.open += routed;
+  pending.closed = true;
+  TakeIfComplete(key, done);
+  return done;
+}
+
+std::map<long long, EventHits> Drain() {
+  std::lock_guard<std::mutex> lock(gSinkMutex);
+  std::map<long long, EventHits> out;
+  for (auto& [key, pending] : gSink) out.emplace(key, std::move(pending.rec));
+  gSink.clear();
+  return out;
+}
+
+} // namespace OpticalSubEvent
@@ -0,0 +1,104 @@
+#include "OpticalTimeCut.hh"
+
+#include "OpticalSubEvent.hh"
+#include "PrimaryVertexInfo.hh"
+
+#include <G4EventManager.hh>
+#include <G4Event.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4Step.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4Track.hh>
+#include <G4ios.hh>
+
+#include <atomic>
+#include <unordered_set>
+
+namespace {
+
+bool gEnabled = false;
+double gCutNs = 0.0;
+
+std::atomic<unsigned long long> gKilled{0};      // photons stopped by the cut
+std::atomic<unsigned long long> gProbes{0};      // photons let through to measure
+std::atomic<unsigned long long> gProbeSteps{0};  // steps taken by probes past the cut
+
+// Probes of the current event on this thread (track ids are per event).
+struct ProbeState {
+  int eventId = -1;
+  unsigned reached = 0; // photons that reached the cut on this thread
+  std::unordered_set<int> tracks;
+};
+thread_local ProbeState tProbes;
+
+} // namespace
+
+namespace OpticalTimeCut {
+
+void Configure(double gateEndNs, double marginNs) {
+  gEnabled = true;
+  gCutNs = gateEndNs + marginNs;
+}
+
+bool Enabled() { return gEnabled; }
+
+double CutNs() { return gCutNs; }
+
+bool Apply(const G4Step* step) {
+  if (!gEnabled) return false;
+  auto* track = step->GetTrack();
+  if (track->GetDefinition() != G4OpticalPhoton::Definition()) return false;
+
+  const auto* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  const int eventId = event ? event->GetEventID() : -1;
+  if (eventId != tProbes.eventId) {
+    tProbes.eventId = eventId;
+    tProbes.tracks.clear();
+  }
+  if (!tProbes.tracks.empty() && tProbes.tracks.count(track->GetTrackID())) {
+    gProbeSteps.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Same t0 as the digitizer gate (the budget event action, which also
+  // tracks t0, is not installed when the digitizer is).
+  double t0_ns = PrimaryVertexInfo::T0nsOf(event);
+  if (const auto* tag = dynamic_cast<const OpticalSubEvent::PhotonTag*>(track->GetUserInformation())) {
+    t0_ns = tag->T0ns();
+  }
+  if (track->GetGlobalTime() / ns - t0_ns <= gCutNs) return false;
+
+  if (++tProbes.reached % kProbeEvery == 0) {
+    tProbes.tracks.insert(track->GetTrackID());
+    gProbes.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  track->SetTrackStatus(fStopAndKill);
+  gKilled.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void ResetCounters() {
+  gKilled.store(0, std::memory_order_relaxed);
+  gProbes.store(0, std::memory_order_relaxed);
+  gProbeSteps.store(0, std::memory_order_relaxed);
+}
+
+void Report() {
+  if (!gEnabled) return;
+  const auto killed = gKilled.load(std::memory_order_relaxed);
+  const auto probes = gProbes.load(std::memory_order_relaxed);
+  const auto probeSteps = gProbeSteps.load(std::memory_order_relaxed);
+  G4cout << "[TimeCut] cut=t0+" << gCutNs << " ns photons_killed=" << killed
+         << " probes=" << probes;
+  if (probes > 0) {
+    const double stepsPerPhoton = static_cast<double>(probeSteps) / static_cast<double>(probes);
+    G4cout << " steps_per_late_photon=" << stepsPerPhoton
+           << " steps_saved~" << static_cast<unsigned long long>(stepsPerPhoton * static_cast<double>(killed));
+  } else {
+    G4cout << " steps_saved=n/a (no probes)";
+  }
+  G4cout << G4endl;
+}
+
+} // namespace OpticalTimeCut
@@ -0,0 +1,248 @@
+#include "OutputMerge.hh"
+
+#include "RunManifest.hh"
+
+#include <G4Threading.hh>
+#include <G4ios.hh>
+
+#include <TFile.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+std::mutex gShardMutex;
+std::map<std::string, std::vector<std::string>> gPendingShards; // merged path -> shard paths
+std::set<std::string> gMergedOnce;                              // merged paths written this process
+
+bool KeepShards() {
+  const char* env = std::getenv("FLNDR_KEEP_SHARDS");
+  return env && *env && std::string(env) != "0";
+}
+
+// Same schema as PMTDigitizer::Writer.
+struct HitsBuffer {
+  int    event = 0;
+  int    pmt = 0;
+  double t_ns = 0.0;
+  double npe = 0.0;
+  int    flags = 0;
+
+  void bind(TTree* tree) {
+    tree->SetBranchAddress("event", &event);
+    tree->SetBranchAddress("pmt",   &pmt);
+    tree->SetBranchAddress("t_ns",  &t_ns);
+    tree->SetBranchAddress("npe",   &npe);
+    tree->SetBranchAddress("flags", &flags);
+  }
+
+  void create(TTree* tree) {
+    tree->Branch("event", &event);
+    tree->Branch("pmt",   &pmt);
+    tree->Branch("t_ns",  &t_ns);
+    tree->Branch("npe",   &npe);
+    tree->Branch("flags", &flags);
+  }
+};
+
+struct ShardCursor {
+  std::unique_ptr<TFile> file;
+  TTree* tree = nullptr;
+  HitsBuffer buf;
+  std::vector<std::pair<int, Long64_t>> order; // (event, entry), sorted by event
+  std::size_t pos = 0;
+};
+
+} // namespace
+
+namespace OutputMerge {
+
+std::string TagPath(const std::string& path, const std::string& tag) {
+  if (path.empty() || tag.empty()) return path;
+  std::filesystem::path p(path);
+  return (p.parent_path() / (p.stem().string() + tag + p.extension().string())).string();
+}
+
+std::string ShardPath(const std::string& path) {
+  if (path.empty() || !G4Threading::IsWorkerThread()) return path;
+  return TagPath(path, ".w" + std::to_string(G4Threading::G4GetThreadId()));
+}
+
+void RegisterShard(const std::string& mergedPath, const std::string& shardPath) {
+  std::lock_guard<std::mutex> lock(gShardMutex);
+  gPendingShards[mergedPath].push_back(shardPath);
+}
+
+std::size_t MergeHitsTrees(const std::vector<std::string>& shards,
+                           const std::string& outPath,
+                           bool append) {
+  std::vector<ShardCursor> cursors;
+  cursors.reserve(shards.size());
+  for (const auto& path : shards) {
+    ShardCursor cur;
+    cur.file.reset(TFile::Open(path.c_str(), "READ"));
+    if (!cur.file || cur.file->IsZombie()) {
+      throw std::runtime_error("OutputMerge: cannot open shard '" + path + "'");
+    }
+    cur.tree = dynamic_cast<TTree*>(cur.file->Get("hits"));
+    if (!cur.tree) {
+      throw std::runtime_error("OutputMerge: shard '" + path + "' has no 'hits' tree");
+    }
+    // Pass 1: event column only, to build the per-shard order.
+    cur.tree->SetBranchStatus("*", 0);
+    cur.tree->SetBranchStatus("event", 1);
+    cur.tree->SetBranchAddress("event", &cur.buf.event);
+    const Long64_t n = cur.tree->GetEntries();
+    cur.order.reserve(static_cast<std::size_t>(n));
+    for (Long64_t i = 0; i < n; ++i) {
+      cur.tree->GetEntry(i);
+      cur.order.emplace_back(cur.buf.event, i);
+    }
+    std::stable_sort(cur.order.begin(), cur.order.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    cur.tree->SetBranchStatus("*", 1);
+    cur.buf.bind(cur.tree);
+    cursors.push_back(std::move(cur));
+  }
+
+  if (auto dir = std::filesystem::path(outPath).parent_path(); !dir.empty()) {
+    std::filesystem::create_directories(dir);
+  }
+  const bool update = append && std::filesystem::exists(outPath);
+  std::unique_ptr<TFile> out(TFile::Open(outPath.c_str(), update ? "UPDATE" : "RECREATE"));
+  if (!out || out->IsZombie()) {
+    throw std::runtime_error("OutputMerge: cannot open merged output '" + outPath + "'");
+  }
+  out->cd();
+  HitsBuffer outBuf;
+  TTree* outTree = update ? dynamic_cast<TTree*>(out->Get("hits")) : nullptr;
+  if (outTree) {
+    outBuf.bind(outTree);
+  } else {
+    outTree = new TTree("hits", "Digitized PMT hits");
+    outBuf.create(outTree);
+  }
+  outTree->SetDirectory(out.get());
+
+  // k-way merge on event id; ties resolved by shard order so output is stable.
+  using Head = std::pair<int, std::size_t>; // (event, shard index)
+  std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+  for (std::size_t s = 0; s < cursors.size(); ++s) {
+    if (!cursors[s].order.empty()) heap.emplace(cursors[s].order.front().first, s);
+  }
+
+  std::size_t written = 0;
+  std::size_t splitEvents = 0;
+  int lastEvent = 0;
+  std::size_t lastShard = 0;
+  bool haveLast = false;
+  while (!heap.empty()) {
+    const auto [event, s] = heap.top();
+    heap.pop();
+    auto& cur = cursors[s];
+    if (haveLast && event == lastEvent && s != lastShard) ++splitEvents;
+    // Drain this shard's block for `event` in one go.
+    while (cur.pos < cur.order.size() && cur.order[cur.pos].first == event) {
+      cur.tree->GetEntry(cur.order[cur.pos].second);
+      outBuf.event = cur.buf.event;
+      outBuf.pmt   = cur.buf.pmt;
+      outBuf.t_ns  = cur.buf.t_ns;
+      outBuf.npe   = cur.buf.npe;
+      outBuf.flags = cur.buf.flags;
+      outTree->Fill();
+      ++written;
+      ++cur.pos;
+    }
+    lastEvent = event;
+    lastShard = s;
+    haveLast = true;
+    if (cur.pos < cur.order.size()) heap.emplace(cur.order[cur.pos].first, s);
+  }
+  if (splitEvents > 0) {
+    G4cout << "[Merge] WARNING: " << splitEvents
+           << " event ids appear in more than one shard of " << outPath << G4endl;
+  }
+
+  // Per-event index (PMTDigitizer digi_events): concatenated in event order.
+  std::vector<std::pair<int, int>> index; // (event, n_hits)
+  bool haveIndex = false;
+  for (auto& cur : cursors) {
+    auto* events = dynamic_cast<TTree*>(cur.file->Get("digi_events"));
+    if (!events) continue;
+    haveIndex = true;
+    int event = 0;
+    int nHits = 0;
+    events->SetBranchAddress("event", &event);
+    events->SetBranchAddress("n_hits", &nHits);
+    for (Long64_t i = 0; i < events->GetEntries(); ++i) {
+      events->GetEntry(i);
+      index.emplace_back(event, nHits);
+    }
+  }
+  TTree* outEvents = update ? dynamic_cast<TTree*>(out->Get("digi_events")) : nullptr;
+  if (haveIndex || outEvents) {
+    std::stable_sort(index.begin(), index.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    int event = 0;
+    int nHits = 0;
+    if (outEvents) {
+      outEvents->SetBranchAddress("event", &event);
+      outEvents->SetBranchAddress("n_hits", &nHits);
+    } else {
+      outEvents = new TTree("digi_events", "Digitized events");
+      outEvents->Branch("event", &event);
+      outEvents->Branch("n_hits", &nHits);
+    }
+    outEvents->SetDirectory(out.get());
+    for (const auto& [e, n] : index) {
+      event = e;
+      nHits = n;
+      outEvents->Fill();
+    }
+  }
+
+  out->cd();
+  outTree->Write("", TObject::kOverwrite);
+  if (outEvents) outEvents->Write("", TObject::kOverwrite);
+  WriteManifestToFile(out.get());
+  out->Close();
+  return written;
+}
+
+void MergePendingShards() {
+  std::map<std::string, std::vector<std::string>> pending;
+  {
+    std::lock_guard<std::mutex> lock(gShardMutex);
+    pending.swap(gPendingShards);
+  }
+  for (auto& [merged, shards] : pending) {
+    std::sort(shards.begin(), shards.end());
+    const bool append = !gMergedOnce.insert(merged).second;
+    try {
+      const std::size_t n = MergeHitsTrees(shards, merged, append);
+      G4cout << "[Merge] " << shards.size() << " shards -> " << merged
+             << " records=" << n << (append ? " (appended)" : "") << G4endl;
+    } catch (const std::exception& ex) {
+      G4cout << "[Merge] ERROR: " << ex.what() << "; shards left in place." << G4endl;
+      continue;
+    }
+    if (!KeepShards()) {
+      for (const auto& shard : shards) {
+        std::error_code ec;
+        std::filesystem::remove(shard, ec);
+      }
+    }
+  }
+}
+
+} // namespace OutputMerge
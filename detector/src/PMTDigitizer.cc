@@ -1,8 +1,14 @@
 #include "PMTDigitizer.hh"
 
+#include "AsyncWriter.hh"
+#include "EventSeeder.hh"
+#include "GeometryRegistry.hh"
+#include "OpticalSubEvent.hh"
+#include "OutputMerge.hh"
 #include "PMTSD.hh"
-#include "PhotonBudget.hh"
+#include "PrimaryVertexInfo.hh"
 #include "RunManifest.hh"
+#include "TaskPool.hh"
 
 #include <yaml-cpp/yaml.h>
 
@@ -10,7 +16,6 @@
 #include <G4HCofThisEvent.hh>
 #include <G4HCtable.hh>
 #include <G4PhysicalVolumeStore.hh>
-#include <G4Poisson.hh>
 #include <G4RunManager.hh>
 #include <G4SDManager.hh>
 #include <G4SystemOfUnits.hh>
@@ -22,12 +27,14 @@
 #include "TTree.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdlib>
 #include <cctype>
 #include <numeric>
 #include <filesystem>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 #include <unordered_map>
@@ -142,8 +149,13 @@ std::string scalar_to_string(const YAML::Node& node, const char* name) {
 struct Sample {
   double time_ns = 0.0;
   int flags = 0;
+  double weight = 1.0; // photon weight (--photon_weight); dark samples are 1
 };
 
+// Below this many hits the per-PMT loop runs inline; fanning out costs more
+// than it saves.
+constexpr std::size_t kParallelMinHits = 20000;
+
 } // namespace
 
 struct PMTDigitizer::Writer {
@@ -154,18 +166,24 @@ struct PMTDigitizer::Writer {
   double b_time = 0.0;
   double b_npe = 0.0;
   int    b_flags = 0;
+  // One row per digitized event, with or without hits: flndr_merge checks
+  // shard coverage against it.
+  TTree* events = nullptr;
+  int    e_event = 0;
+  int    e_hits = 0;
 
   ~Writer() {
     if (file) {
       file->cd();
       tree->Write();
+      events->Write();
       file->Write();
       file->Close();
       delete file;
     }
   }
 
-  void open(const std::string& path) {
+  void open(const std::string& path, bool shard) {
     if (file) return;
     auto dir = std::filesystem::path(path).parent_path();
     if (!dir.empty()) {
@@ -182,7 +200,14 @@ struct PMTDigitizer::Writer {
     tree->Branch("npe",   &b_npe);
     tree->Branch("flags", &b_flags);
     tree->SetDirectory(file);
-    RegisterOutputFile(file);
+    events = new TTree("digi_events", "Digitized events");
+    events->Branch("event",  &e_event);
+    events->Branch("n_hits", &e_hits);
+    events->SetDirectory(file);
+    // Shards get the manifest through the merged file instead.
+    if (!shard) {
+      RegisterOutputFile(file);
+    }
   }
 
   void fill(const PMTDigiRecord& rec) {
@@ -193,6 +218,12 @@ struct PMTDigitizer::Writer {
     b_flags = rec.flags;
     tree->Fill();
   }
+
+  void fillEvent(int event, int nHits) {
+    e_event = event;
+    e_hits  = nHits;
+    events->Fill();
+  }
 };
 
 PMTDigitizerConfig PMTDigitizer::LoadConfig(const std::string& path) {
@@ -255,6 +286,29 @@ PMTDigitizerConfig PMTDigitizer::LoadConfig(const std::string& path) {
   }
 }
 
+double PMTDigitizer::PeakEfficiency(const std::string& configPath,
+                                    std::optional<double> qeFlatOverride,
+                                    std::optional<double> qeScaleFactor) {
+  // Same clamping as ensureInitialized().
+  const PMTDigitizerConfig cfg = LoadConfig(configPath);
+  double peak = 0.0;
+  if (qeFlatOverride) {
+    peak = cfg.qe_curve.empty() ? 0.0 : std::clamp(*qeFlatOverride, 0.0, 1.0);
+  } else {
+    for (double qe : cfg.qe_curve) peak = std::max(peak, std::clamp(qe, 0.0, 1.0));
+  }
+  double scale = std::clamp(cfg.qe_scale, 0.0, 1.0);
+  scale = std::clamp(scale * qeScaleFactor.value_or(1.0), 0.0, 1.0);
+  return std::clamp(scale * peak, 0.0, 1.0);
+}
+
+double PMTDigitizer::GateEndNs(const std::string& configPath,
+                               std::optional<double> gateNsOverride) {
+  const PMTDigitizerConfig cfg = LoadConfig(configPath);
+  const double width = gateNsOverride ? std::max(0.0, *gateNsOverride) : std::max(0.0, cfg.gate_ns);
+  return cfg.gate_offset_ns + width;
+}
+
 PMTDigitizer::PMTDigitizer(std::string configPath,
                            std::string outputPath,
                            std::optional<double> qeFlatOverride,
@@ -286,9 +340,14 @@ PMTDigitizer::PMTDigitizer(std::string configPath,
 
 PMTDigitizer::~PMTDigitizer() {
   emitFinalSummary();
+  io_.reset(); // drain pending fills before the tree is written
   delete writer_;
 }
 
+void PMTDigitizer::SetPhotonKeepProbability(double keepProbability) {
+  photonKeep_ = std::clamp(keepProbability, 0.0, 1.0);
+}
+
 void PMTDigitizer::emitFinalSummary() const {
   G4cout << "[PMTDigi] summary events=" << eventsProcessed_
          << " total_pe=" << totalPEs_
@@ -296,7 +355,7 @@ void PMTDigitizer::emitFinalSummary() const {
          << G4endl;
 }
 
-void PMTDigitizer::ensureInitialized() {
+void PMTDigitizer::ensureInitialized(bool needHitsCollection) {
   if (!cfgLoaded_) {
     cfg_ = LoadConfig(configPath_);
     cfg_.qe_scale = std::clamp(cfg_.qe_scale, 0.0, 1.0);
@@ -442,12 +501,22 @@ void PMTDigitizer::ensureInitialized() {
              << " mean_400-450nm=" << meanStr.str()
              << " ; threshold_pe=" << threshStr.str()
              << G4endl;
+      if (photonKeep_ < 1.0) {
+        std::ostringstream keepStr;
+        keepStr << std::fixed << std::setprecision(3) << photonKeep_;
+        G4cout << "[PMT.QE] pre-thinned at birth: keep=" << keepStr.str()
+               << " ; applying QE/keep per hit" << G4endl;
+        if (effPeak > photonKeep_ * (1.0 + 1e-9)) {
+          G4cout << "[PMTDigi] WARNING: peak QE " << effPeak << " exceeds the pre-thinning keep probability "
+                 << photonKeep_ << "; detection is under-counted." << G4endl;
+        }
+      }
       loggedEffectiveQE_ = true;
     }
     cfgLoaded_ = true;
   }
 
-  if (hitsCollectionId_ < 0) {
+  if (needHitsCollection && hitsCollectionId_ < 0) {
     auto* sdm = G4SDManager::GetSDMpointer();
     const char* candidates[] = {"PMTSD/OpticalHits", "PMTSD/PMTHits"};
     for (const char* name : candidates) {
@@ -486,10 +555,36 @@ void PMTDigitizer::ensureInitialized() {
 void PMTDigitizer::ensureOutput() {
   if (outputOpen_) return;
   if (!writer_) writer_ = new Writer();
-  writer_->open(outputPath_);
+  shardPath_ = OutputMerge::ShardPath(outputPath_);
+  if (OpticalSubEvent::Enabled() && shardPath_ == outputPath_) {
+    // Sub-event mode: the workers' shards hold the events; master leftovers
+    // join them through the same merge.
+    shardPath_ = OutputMerge::TagPath(outputPath_, ".subevt");
+  }
+  if (shardPath_ != outputPath_ && !loggedShardPath_) {
+    G4cout << "[PMTDigi] shard output -> " << shardPath_ << G4endl;
+    loggedShardPath_ = true;
+  }
+  writer_->open(shardPath_, /*shard=*/shardPath_ != outputPath_);
+  if (!io_) io_ = std::make_unique<AsyncWriter>();
   outputOpen_ = true;
 }
 
+void PMTDigitizer::FlushOutput() {
+  if (io_) io_->Flush();
+}
+
+void PMTDigitizer::CloseOutput() {
+  if (!outputOpen_) return;
+  io_.reset();
+  delete writer_;
+  writer_ = nullptr;
+  outputOpen_ = false;
+  if (shardPath_ != outputPath_) {
+    OutputMerge::RegisterShard(outputPath_, shardPath_);
+  }
+}
+
 void PMTDigitizer::cachePMTs() {
   if (geometryCached_) return;
   geometryCached_ = true;
@@ -499,10 +594,20 @@ void PMTDigitizer::cachePMTs() {
     for (auto* pv : *store) {
       if (!pv) continue;
       if (pv->GetName() == "PMT") {
-        unique.insert(pv->GetCopyNo());
+        if (pv->IsParameterised()) {
+          for (G4int i = 0; i < pv->GetMultiplicity(); ++i) unique.insert(i);
+        } else {
+          unique.insert(pv->GetCopyNo());
+        }
       }
     }
   }
+  if (unique.empty()) {
+    // --pmt_mode=surface places no PMT volumes; the registry has the layout.
+    if (const auto* snap = GeometryRegistry::Instance().Snapshot()) {
+      unique.insert(snap->id.begin(), snap->id.end());
+    }
+  }
   allPmts_.assign(unique.begin(), unique.end());
   std::sort(allPmts_.begin(), allPmts_.end());
   G4cout << "[PMTDigi] Cached " << allPmts_.size()
@@ -519,6 +624,16 @@ void PMTDigitizer::BeginOfEventAction(const G4Event* event) {
 }
 
 void PMTDigitizer::EndOfEventAction(const G4Event* event) {
+  if (OpticalSubEvent::Enabled()) {
+    // Hits arrive from other workers' sub-events: whichever thread posts an
+    // event's last outstanding part digitizes it.
+    auto done = OpticalSubEvent::IsSubEvent(event)
+                  ? OpticalSubEvent::CloseSubEvent()
+                  : OpticalSubEvent::CloseEvent(PrimaryVertexInfo::KeyOf(event),
+                                                PrimaryVertexInfo::T0nsOf(event));
+    digitizeSubEvents(done);
+    return;
+  }
   try {
     digitizeEvent(event);
   } catch (const std::exception& ex) {
@@ -559,75 +674,124 @@ void PMTDigitizer::digitizeEvent(const G4Event* event) {
     return;
   }
 
-  auto* hits = static_cast<PMTHitsCollection*>(raw);
-  const size_t nHits = hits->entries();
+  auto* hitsCollection = static_cast<PMTHitsCollection*>(raw);
+  std::vector<const PMTHit*> hits;
+  hits.reserve(hitsCollection->entries());
+  for (size_t i = 0; i < hitsCollection->entries(); ++i) {
+    hits.push_back((*hitsCollection)[i]);
+  }
+  digitizeHits(PrimaryVertexInfo::KeyOf(event), PrimaryVertexInfo::T0nsOf(event), hits);
+}
 
-  std::unordered_map<int, std::vector<Sample>> perPMT;
-  perPMT.reserve(nHits + allPmts_.size());
+void PMTDigitizer::digitizeHits(long long eventKey, double t0_ns,
+                                const std::vector<const PMTHit*>& hits) {
+  ensureOutput();
+  const auto& manifest = GetRunManifest();
 
-  std::unordered_set<int> pmtsSeen;
+  // Partition by PMT, keeping collection order within each PMT. Every PMT is
+  // digitized from its own counter-based stream under one per-event key, so
+  // the output is the same whether the PMTs run inline or on any number of
+  // TaskPool lanes.
+  std::vector<const PMTHit*> byPMT;
+  byPMT.reserve(hits.size());
+  for (const PMTHit* hit : hits) {
+    if (hit) byPMT.push_back(hit);
+  }
+  std::stable_sort(byPMT.begin(), byPMT.end(), [](const PMTHit* a, const PMTHit* b) {
+    return a->pmt_id < b->pmt_id;
+  });
+  const std::size_t rawCount = byPMT.size();
+
+  const bool darkActive = cfg_.dark_rate_hz > 0.0 && gateWindowNs_ > 0.0;
+  struct PMTWork {
+    int pmt = -1;
+    std::size_t begin = 0;
+    std::size_t end = 0;    // hits [begin, end) of byPMT
+    bool darkTarget = false; // listed in allPmts_
+  };
+  std::vector<PMTWork> work;
+  {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    const bool listed = darkActive && !allPmts_.empty();
+    while (i < byPMT.size() || (listed && j < allPmts_.size())) {
+      PMTWork w;
+      const int hitPmt = i < byPMT.size() ? byPMT[i]->pmt_id : std::numeric_limits<int>::max();
+      const int listPmt = listed && j < allPmts_.size() ? allPmts_[j] : std::numeric_limits<int>::max();
+      w.pmt = std::min(hitPmt, listPmt);
+      w.begin = i;
+      while (i < byPMT.size() && byPMT[i]->pmt_id == w.pmt) ++i;
+      w.end = i;
+      if (listPmt == w.pmt) {
+        w.darkTarget = true;
+        while (j < allPmts_.size() && allPmts_[j] == w.pmt) ++j;
+      }
+      work.push_back(w);
+    }
+  }
 
-  const double t0_ns = PrimaryInfo::T0ns();
   const double gateStart = t0_ns + cfg_.gate_offset_ns;
   const double gateEnd   = gateStart + gateWindowNs_;
   const bool gateStandardActive = gateModeStandard_ && gateWindowNs_ > 0.0;
-
-  std::size_t rawCount = 0;
-  std::size_t keptCount = 0;
-  std::size_t darkCount = 0;
-
-  for (size_t i = 0; i < nHits; ++i) {
-    const PMTHit* hit = (*hits)[i];
-    if (!hit) continue;
-    ++rawCount;
-
-    double lambda_nm = hit->wavelength_nm;
-    double prob = cfg_.qe_scale * sampleQE(lambda_nm);
-    prob = std::clamp(prob, 0.0, 1.0);
-    if (prob <= 0.0) continue;
-    if (G4UniformRand() > prob) continue;
-    ++keptCount;
-
-    double t_ns = hit->time / ns;
-    if (sigma_ns_ > 0.0) {
-      t_ns += G4RandGauss::shoot(0.0, sigma_ns_);
-    }
-    if (gateStandardActive) {
-      if (t_ns < gateStart || t_ns > gateEnd) continue;
-    }
-
-    auto& vec = perPMT[hit->pmt_id];
-    vec.push_back({t_ns, hit->flags});
-    pmtsSeen.insert(hit->pmt_id);
-  }
-
-  if (cfg_.dark_rate_hz > 0.0 && gateWindowNs_ > 0.0) {
-    const double gateWidth_s = gateWindowNs_ * 1e-9;
-    const double mean = cfg_.dark_rate_hz * gateWidth_s;
-    std::vector<int> dynamicTargets;
-    const std::vector<int>* targets = &allPmts_;
-    if (allPmts_.empty()) {
-      dynamicTargets.assign(pmtsSeen.begin(), pmtsSeen.end());
-      targets = &dynamicTargets;
-    }
-    for (int pmt : *targets) {
-      const int k = G4Poisson(mean);
-      if (k <= 0) continue;
-      auto& vec = perPMT[pmt];
-      vec.reserve(vec.size() + static_cast<size_t>(k));
-      for (int i = 0; i < k; ++i) {
-        const double t = gateStart + G4UniformRand() * gateWindowNs_;
-        vec.push_back({t, 0x1}); // flag bit 0x1 => dark
-        ++darkCount;
+  const double darkMean = darkActive ? cfg_.dark_rate_hz * gateWindowNs_ * 1e-9 : 0.0;
+  const int eventId = static_cast<int>(eventKey);
+
+  // One engine draw pair per event keys every PMT stream; with per-event
+  // seeding the engine was reseeded from the event key beforehand.
+  const std::uint64_t streamKey =
+      static_cast<std::uint64_t>(G4UniformRand() * 4294967296.0) << 32 |
+      static_cast<std::uint64_t>(G4UniformRand() * 4294967296.0);
+
+  struct PMTResult {
+    std::vector<PMTDigiRecord> records;
+    std::size_t kept = 0;
+    std::size_t dark = 0;
+  };
+  std::vector<PMTResult> results(work.size());
+
+  auto digitizePMT = [&](std::size_t index) {
+    const PMTWork& w = work[index];
+    PMTResult& out = results[index];
+    EventSeeder::PhiloxStream rng(streamKey, static_cast<std::uint32_t>(w.pmt));
+
+    std::vector<Sample> samples;
+    samples.reserve(w.end - w.begin);
+    for (std::size_t i = w.begin; i < w.end; ++i) {
+      const PMTHit* hit = byPMT[i];
+      double lambda_nm = hit->wavelength_nm;
+      double prob = cfg_.qe_scale * sampleQE(lambda_nm);
+      if (photonKeep_ < 1.0) {
+        prob = photonKeep_ > 0.0 ? prob / photonKeep_ : 0.0;
+      }
+      prob = std::clamp(prob, 0.0, 1.0);
+      if (prob <= 0.0) continue;
+      if (rng.Flat() > prob) continue;
+      ++out.kept;
+
+      double t_ns = hit->time / ns;
+      if (sigma_ns_ > 0.0) {
+        t_ns += rng.Gauss(0.0, sigma_ns_);
+      }
+      if (gateStandardActive) {
+        if (t_ns < gateStart || t_ns > gateEnd) continue;
+      }
+      // PMTSD stores the photon's track weight in `pe`.
+      samples.push_back({t_ns, hit->flags, hit->pe > 0.0 ? hit->pe : 1.0});
+    }
+
+    // Without a PMT list, dark noise goes on the PMTs that registered light.
+    const bool darkTarget = allPmts_.empty() ? !samples.empty() : w.darkTarget;
+    if (darkActive && darkTarget) {
+      const long k = rng.Poisson(darkMean);
+      for (long i = 0; i < k; ++i) {
+        const double t = gateStart + rng.Flat() * gateWindowNs_;
+        samples.push_back({t, 0x1}); // flag bit 0x1 => dark
+        ++out.dark;
       }
     }
-  }
 
-  if (gateModeCentered_ && gateWindowNs_ > 0.0) {
-    const double halfWindow = gateWindowNs_ * 0.5;
-    for (auto& kv : perPMT) {
-      auto& samples = kv.second;
-      if (samples.empty()) continue;
+    if (gateModeCentered_ && gateWindowNs_ > 0.0 && !samples.empty()) {
+      const double halfWindow = gateWindowNs_ * 0.5;
       double sum = 0.0;
       for (const auto& s : samples) {
         sum += s.time_ns;
@@ -639,39 +803,31 @@ void PMTDigitizer::digitizeEvent(const G4Event* event) {
                                });
       samples.erase(it, samples.end());
     }
-  }
-
-  std::vector<PMTDigiRecord> records;
-  if (storeAllSamples_) {
-    std::size_t totalSamples = 0;
-    for (const auto& kv : perPMT) {
-      totalSamples += kv.second.size();
-    }
-    records.reserve(totalSamples);
-  } else {
-    records.reserve(perPMT.size());
-  }
-  const int eventId = event->GetEventID();
-
-  for (auto& kv : perPMT) {
-    auto& samples = kv.second;
-    if (samples.empty()) continue;
+    if (samples.empty()) return;
 
     if (storeAllSamples_) {
-      if (cfg_.threshold_npe > 1.0) continue;
-      const bool saturated = samples.size() >= 10.0;
+      if (cfg_.threshold_npe > 1.0) return;
+      double sumWeight = 0.0;
+      for (const auto& s : samples) {
+        sumWeight += s.weight;
+      }
+      const bool saturated = sumWeight >= 10.0;
+      out.records.reserve(samples.size());
       for (const auto& s : samples) {
         int flags = s.flags;
         if (saturated) {
           flags |= 0x4;
         }
-        records.push_back({eventId, kv.first, s.time_ns, 1.0, flags});
+        out.records.push_back({eventId, w.pmt, s.time_ns, s.weight, flags});
       }
-      continue;
+      return;
     }
 
-    const double npe = static_cast<double>(samples.size());
-    if (npe < cfg_.threshold_npe) continue;
+    double npe = 0.0;
+    for (const auto& s : samples) {
+      npe += s.weight;
+    }
+    if (npe < cfg_.threshold_npe) return;
 
     const auto minIt = std::min_element(
         samples.begin(), samples.end(),
@@ -685,22 +841,52 @@ void PMTDigitizer::digitizeEvent(const G4Event* event) {
       flagMask |= 0x4; // saturated
     }
 
-    records.push_back({eventId, kv.first, minIt->time_ns, npe, flagMask});
+    out.records.push_back({eventId, w.pmt, minIt->time_ns, npe, flagMask});
+  };
+
+  if (TaskPool::Lanes() > 1 && rawCount >= kParallelMinHits) {
+    // A few chunks per lane: PMTs differ a lot in hit count.
+    const std::size_t chunks = std::min(work.size(), static_cast<std::size_t>(TaskPool::Lanes()) * 8);
+    TaskPool::ParallelFor(chunks, [&](std::size_t c) {
+      const std::size_t first = work.size() * c / chunks;
+      const std::size_t last = work.size() * (c + 1) / chunks;
+      for (std::size_t i = first; i < last; ++i) digitizePMT(i);
+    });
+  } else {
+    for (std::size_t i = 0; i < work.size(); ++i) digitizePMT(i);
   }
 
-  static bool printedSample = false;
-  if (!manifest.quiet && manifest.opticalVerboseLevel > 0 && !printedSample) {
+  std::size_t keptCount = 0;
+  std::size_t darkCount = 0;
+  std::size_t totalRecords = 0;
+  for (const auto& r : results) {
+    keptCount += r.kept;
+    darkCount += r.dark;
+    totalRecords += r.records.size();
+  }
+  std::vector<PMTDigiRecord> records;
+  records.reserve(totalRecords);
+  for (auto& r : results) {
+    records.insert(records.end(), r.records.begin(), r.records.end());
+  }
+
+  static std::atomic<bool> printedSample{false};
+  if (!manifest.quiet && manifest.opticalVerboseLevel > 0 && !printedSample.exchange(true)) {
     G4cout << "[PMTDigi] sample evt0 -> raw=" << rawCount
            << " kept=" << keptCount
            << " dark=" << darkCount << G4endl;
-    printedSample = true;
   }
 
   double eventTotalPE = 0.0;
   for (const auto& rec : records) {
     eventTotalPE += rec.npe;
-    writer_->fill(rec);
   }
+  const std::size_t nRecords = records.size();
+  // TTree::Fill (and basket compression) runs on this digitizer's I/O thread.
+  io_->Submit([writer = writer_, batch = std::move(records), eventId]() {
+    for (const auto& rec : batch) writer->fill(rec);
+    writer->fillEvent(eventId, static_cast<int>(batch.size()));
+  });
 
   ++eventsProcessed_;
   totalPEs_ += eventTotalPE;
@@ -710,7 +896,7 @@ void PMTDigitizer::digitizeEvent(const G4Event* event) {
            << " raw=" << rawCount
            << " kept=" << keptCount
            << " dark=" << darkCount
-           << " out=" << records.size()
+           << " out=" << nRecords
            << " pe_evt=" << eventTotalPE
            << G4endl;
   }
@@ -728,6 +914,34 @@ void PMTDigitizer::digitizeEvent(const G4Event* event) {
   }
 }
 
+void PMTDigitizer::DigitizeSubEventHits() {
+  auto events = OpticalSubEvent::Drain();
+  if (events.empty()) return;
+  G4cout << "[WARN] Sub-event mode: " << events.size()
+         << " events still waiting for sub-events at end of run; digitizing what arrived" << G4endl;
+  digitizeSubEvents(events);
+}
+
+void PMTDigitizer::digitizeSubEvents(std::map<long long, OpticalSubEvent::EventHits>& events) {
+  if (events.empty()) return;
+  try {
+    ensureInitialized(/*needHitsCollection=*/false);
+    for (auto& [key, rec] : events) {
+      // Sub-events finish in any order; fix the hit order before drawing.
+      std::sort(rec.hits.begin(), rec.hits.end(), [](const PMTHit& a, const PMTHit& b) {
+        return a.pmt_id != b.pmt_id ? a.pmt_id < b.pmt_id : a.time < b.time;
+      });
+      std::vector<const PMTHit*> hits;
+      hits.reserve(rec.hits.size());
+      for (const auto& h : rec.hits) hits.push_back(&h);
+      EventSeeder::SeedEvent(key, /*stream=*/1);
+      digitizeHits(key, rec.t0_ns, hits);
+    }
+  } catch (const std::exception& ex) {
+    G4Exception("PMTDigitizer", "DigitizeFail", FatalException, ex.what());
+  }
+}
+
 double PMTDigitizer::sampleQE(double wavelength_nm) const {
   if (cfg_.wavelengths_nm.empty()) return 0.0;
   if (wavelength_nm <= 0.0) return cfg_.qe_curve.front();
@@ -0,0 +1,203 @@
+#include "PMTLayout.hh"
+
+#include <G4LogicalBorderSurface.hh>
+#include <G4LogicalSkinSurface.hh>
+#include <G4LogicalVolume.hh>
+#include <G4PVParameterised.hh>
+#include <G4PVPlacement.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4VPhysicalVolume.hh>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+const G4RotationMatrix* AddRotation(PMTLayout& layout, std::unique_ptr<G4RotationMatrix> rot) {
+  layout.rotations.push_back(std::move(rot));
+  return layout.rotations.back().get();
+}
+
+} // namespace
+
+std::unique_ptr<PMTLayout> BoxWallLayout(double halfX, double halfY, double halfZ,
+                                         double zPitch, double xPitch, double yPitch, double inset,
+                                         unsigned faces) {
+  auto layout = std::make_unique<PMTLayout>();
+  auto add = [&](const G4RotationMatrix* rot, const G4ThreeVector& pos) {
+    layout->position.push_back(pos);
+    layout->rotation.push_back(rot);
+  };
+  auto rotated = [&](double aboutX, double aboutY) {
+    auto rot = std::make_unique<G4RotationMatrix>();
+    if (aboutY != 0.0) rot->rotateY(aboutY);
+    if (aboutX != 0.0) rot->rotateX(aboutX);
+    return AddRotation(*layout, std::move(rot));
+  };
+
+  if (faces & kBoxFacePosX) {
+    const auto* rot = rotated(0.0, 90 * deg);
+    G4double x = halfX - inset;
+    for (G4double z = -halfZ + zPitch; z <= halfZ - zPitch; z += zPitch) {
+      for (G4double y = -halfY + yPitch; y <= halfY - yPitch; y += yPitch) {
+        add(rot, {x, y, z});
+      }
+    }
+  }
+  if (faces & kBoxFaceNegX) {
+    const auto* rot = rotated(0.0, -90 * deg);
+    G4double x = -halfX + inset;
+    for (G4double z = -halfZ + zPitch; z <= halfZ - zPitch; z += zPitch) {
+      for (G4double y = -halfY + yPitch; y <= halfY - yPitch; y += yPitch) {
+        add(rot, {x, y, z});
+      }
+    }
+  }
+  if (faces & kBoxFacePosY) {
+    const auto* rot = rotated(-90 * deg, 0.0);
+    G4double y = halfY - inset;
+    for (G4double z = -halfZ + zPitch; z <= halfZ - zPitch; z += zPitch) {
+      for (G4double x = -halfX + xPitch; x <= halfX - xPitch; x += xPitch) {
+        add(rot, {x, y, z});
+      }
+    }
+  }
+  if (faces & kBoxFaceNegY) {
+    const auto* rot = rotated(90 * deg, 0.0);
+    G4double y = -halfY + inset;
+    for (G4double z = -halfZ + zPitch; z <= halfZ - zPitch; z += zPitch) {
+      for (G4double x = -halfX + xPitch; x <= halfX - xPitch; x += xPitch) {
+        add(rot, {x, y, z});
+      }
+    }
+  }
+  // The disc axis is already z: identity for +z, flipped for -z.
+  if (faces & kBoxFacePosZ) {
+    const auto* rot = AddRotation(*layout, std::make_unique<G4RotationMatrix>());
+    G4double z = halfZ - inset;
+    for (G4double y = -halfY + yPitch; y <= halfY - yPitch; y += yPitch) {
+      for (G4double x = -halfX + xPitch; x <= halfX - xPitch; x += xPitch) {
+        add(rot, {x, y, z});
+      }
+    }
+  }
+  if (faces & kBoxFaceNegZ) {
+    const auto* rot = rotated(180 * deg, 0.0);
+    G4double z = -halfZ + inset;
+    for (G4double y = -halfY + yPitch; y <= halfY - yPitch; y += yPitch) {
+      for (G4double x = -halfX + xPitch; x <= halfX - xPitch; x += xPitch) {
+        add(rot, {x, y, z});
+      }
+    }
+  }
+  return layout;
+}
+
+std::unique_ptr<PMTLayout> TubsWallLayout(double rOuter, double zHalf, double pmtRadius,
+                                          double zPitch, int nPhi, double wallGap) {
+  auto layout = std::make_unique<PMTLayout>();
+  const G4double zMargin = pmtRadius + 5.0 * cm;
+  const G4double radius = std::max(rOuter - wallGap - pmtRadius, pmtRadius + wallGap);
+
+  // One rotation per phi column, shared by every ring.
+  std::vector<const G4RotationMatrix*> columns;
+  for (int k = 0; k < nPhi; ++k) {
+    const G4double phi = (2.0 * CLHEP::pi * k) / nPhi;
+    auto rot = std::make_unique<G4RotationMatrix>();
+    rot->rotateY(90.0 * deg);
+    rot->rotateZ(phi);
+    columns.push_back(AddRotation(*layout, std::move(rot)));
+  }
+
+  for (G4double z = -zHalf + zMargin; z <= zHalf - zMargin + 0.5 * zPitch; z += zPitch) {
+    if (z > zHalf - zMargin) break;
+    ++layout->rings;
+    for (int k = 0; k < nPhi; ++k) {
+      const G4double phi = (2.0 * CLHEP::pi * k) / nPhi;
+      layout->position.emplace_back(radius * std::cos(phi), radius * std::sin(phi), z);
+      layout->rotation.push_back(columns[k]);
+    }
+  }
+  layout->perRing = nPhi;
+  return layout;
+}
+
+void PMTWallParameterisation::ComputeTransformation(const G4int copyNo, G4VPhysicalVolume* pv) const {
+  pv->SetTranslation(fLayout.position[copyNo]);
+  // G4VPhysicalVolume takes a non-const frame rotation but does not modify it.
+  pv->SetRotation(const_cast<G4RotationMatrix*>(fLayout.rotation[copyNo]));
+}
+
+PMTPlacement PMTPlacementFromEnv() {
+  if (const char* val = std::getenv("FLNDR_PMT_PLACEMENT")) {
+    std::string mode(val);
+    std::transform(mode.begin(), mode.end(), mode.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (mode == "copies" || mode == "placement") return PMTPlacement::kCopies;
+  }
+  return PMTPlacement::kParameterised;
+}
+
+const char* PMTPlacementName(PMTPlacement placement) {
+  return placement == PMTPlacement::kParameterised ? "param" : "copies";
+}
+
+std::vector<G4VPhysicalVolume*> PlacePMTs(const PMTLayout& layout, G4LogicalVolume* pmtLV,
+                                          G4LogicalVolume* mother, PMTPlacement placement,
+                                          std::unique_ptr<G4VPVParameterisation>& param) {
+  std::vector<G4VPhysicalVolume*> placed;
+  if (layout.Size() == 0) return placed;
+  if (placement == PMTPlacement::kParameterised) {
+    param = std::make_unique<PMTWallParameterisation>(layout);
+    // kUndefined: the navigator voxelizes the copies in 3D from their extents.
+    placed.push_back(new G4PVParameterised("PMT", pmtLV, mother, kUndefined,
+                                           static_cast<G4int>(layout.Size()), param.get(), false));
+    return placed;
+  }
+  placed.reserve(layout.Size());
+  for (std::size_t i = 0; i < layout.Size(); ++i) {
+    placed.push_back(new G4PVPlacement(const_cast<G4RotationMatrix*>(layout.rotation[i]), layout.position[i],
+                                       pmtLV, "PMT", mother, false, static_cast<G4int>(i), false));
+  }
+  return placed;
+}
+
+CathodeSurface CathodeSurfaceFromEnv() {
+  if (const char* val = std::getenv("FLNDR_CATHODE_SURFACE")) {
+    std::string mode(val);
+    std::transform(mode.begin(), mode.end(), mode.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (mode == "border") return CathodeSurface::kBorder;
+  }
+  return CathodeSurface::kSkin;
+}
+
+const char* CathodeSurfaceName(CathodeSurface mode) {
+  return mode == CathodeSurface::kSkin ? "skin" : "border";
+}
+
+std::size_t AttachCathodeSurface(const std::vector<G4VPhysicalVolume*>& pmts, G4LogicalVolume* pmtLV,
+                                 G4VPhysicalVolume* waterPV, G4OpticalSurface* surface,
+                                 CathodeSurface mode) {
+  if (!surface || !pmtLV || pmts.empty()) return 0;
+  if (mode == CathodeSurface::kSkin) {
+    // G4OpBoundaryProcess falls back to the skin surface of the volume being
+    // entered when no border surface matches, so water -> PMT resolves to
+    // this one surface. The reverse direction also sees it, but PMTSD kills
+    // the photon on its first step inside the disc.
+    new G4LogicalSkinSurface("PhotocathodeSkin", pmtLV, surface);
+    return 1;
+  }
+  if (!waterPV) return 0;
+  for (auto* pv : pmts) {
+    const G4String name = pv->IsParameterised()
+        ? G4String("PhotocathodeSurface")
+        : G4String("PhotocathodeSurface_" + std::to_string(pv->GetCopyNo() + 1));
+    new G4LogicalBorderSurface(name, waterPV, pv, surface);
+  }
+  return pmts.size();
+}
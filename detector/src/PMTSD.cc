@@ -11,7 +11,14 @@
 #include "G4Event.hh"
 #include "G4LogicalVolumeStore.hh"
 #include "G4PhysicalVolumeStore.hh"
+#include "BatchOptics.hh"
+#include "DirectLightModel.hh"
+#include "OpticalRoulette.hh"
+#include "OpticalSubEvent.hh"
+#include "PhotonRecords.hh"
+#include "PrimaryVertexInfo.hh"
 #include "RunManifest.hh"
+#include "SurfaceHits.hh"
 
 #include <algorithm>
 #include <atomic>
@@ -28,7 +35,10 @@ void PMTSD::Initialize(G4HCofThisEvent* hce) {
   hce->AddHitsCollection(hc_id_, hits_);
   hitsThisEvent_ = 0;
   auto* rm = G4RunManager::GetRunManager();
-  currentEventId_ = (rm && rm->GetCurrentEvent()) ? rm->GetCurrentEvent()->GetEventID() : -1;
+  const auto* event = rm ? rm->GetCurrentEvent() : nullptr;
+  currentEventId_ = event ? event->GetEventID() : -1;
+  currentEventKey_ = PrimaryVertexInfo::KeyOf(event);
+  currentT0ns_ = PrimaryVertexInfo::T0nsOf(event);
   LogAttachmentsOnce();
 }
 
@@ -42,30 +52,70 @@ G4bool PMTSD::ProcessHits(G4Step* step, G4TouchableHistory*) {
   const auto* pre  = step->GetPreStepPoint();
   if (!post || !pre) return false;
 
-  auto postTouchable = post->GetTouchableHandle();
-  auto preTouchable  = pre->GetTouchableHandle();
-  if (!postTouchable || !preTouchable) return false;
-  auto* postPV = postTouchable->GetVolume();
-  auto* prePV  = preTouchable->GetVolume();
-  if (!postPV || !prePV) return false;
-
-  auto* postLV = postPV ? postPV->GetLogicalVolume() : nullptr;
-  auto* preLV  = prePV ? prePV->GetLogicalVolume() : nullptr;
-  if ((!postLV || postLV->GetName() != "PMT_cathode_log") &&
-      (!preLV || preLV->GetName() != "PMT_cathode_log")) {
-    return false;
-  }
+  int copy = -1;
+  G4double time = post->GetGlobalTime();
+  G4ThreeVector entry = pre->GetPosition();
+  const G4VPhysicalVolume* targetPV = nullptr;
+  if (SurfaceHits::Enabled()) {
+    // No PMT volumes: only a step starting or ending on the can border can
+    // cross a photocathode disc.
+    if (post->GetStepStatus() != fGeomBoundary && pre->GetStepStatus() != fGeomBoundary) {
+      return false;
+    }
+    double fraction = 0.0;
+    copy = SurfaceHits::Find(pre->GetPosition(), post->GetPosition(), fraction);
+    if (copy < 0) return false;
+    time = pre->GetGlobalTime() + fraction * (post->GetGlobalTime() - pre->GetGlobalTime());
+    entry = pre->GetPosition() + fraction * (post->GetPosition() - pre->GetPosition());
+  } else {
+    auto postTouchable = post->GetTouchableHandle();
+    auto preTouchable  = pre->GetTouchableHandle();
+    if (!postTouchable || !preTouchable) return false;
+    auto* postPV = postTouchable->GetVolume();
+    auto* prePV  = preTouchable->GetVolume();
+    if (!postPV || !prePV) return false;
+
+    auto* postLV = postPV ? postPV->GetLogicalVolume() : nullptr;
+    auto* preLV  = prePV ? prePV->GetLogicalVolume() : nullptr;
+    if ((!postLV || postLV->GetName() != "PMT_cathode_log") &&
+        (!preLV || preLV->GetName() != "PMT_cathode_log")) {
+      return false;
+    }
 
-  const auto* targetPV = (postLV && postLV->GetName() == "PMT_cathode_log") ? postPV : prePV;
-  const int copy = targetPV ? targetPV->GetCopyNo() : -1;
-  const G4double time = post->GetGlobalTime();
+    const bool postIsCathode = postLV && postLV->GetName() == "PMT_cathode_log";
+    targetPV = postIsCathode ? postPV : prePV;
+    // Touchable copy number: also right for the parameterised PMT volume.
+    copy = postIsCathode ? postTouchable->GetCopyNumber() : preTouchable->GetCopyNumber();
+    if (postIsCathode) entry = post->GetPosition();
+  }
   const G4double energy = pre->GetKineticEnergy();
   G4double wavelength_nm = 0.0;
   if (energy > 0.0) {
     wavelength_nm = (h_Planck * c_light / energy) / nm;
   }
 
-  hits_->insert(new PMTHit(copy, time, 0.0, wavelength_nm, /*flags=*/0));
+  if (DirectLight::Enabled() && DirectLight::IsDirectArrival(*track, copy, entry)) {
+    // Indirect subsample only: this light was already counted analytically.
+    track->SetTrackStatus(fStopAndKill);
+    return false;
+  }
+
+  // `pe` carries the photon's statistical weight (1 unless --photon_weight).
+  const G4double weight = track->GetWeight();
+  PMTHit hit(copy, time, weight, wavelength_nm, /*flags=*/0);
+  if (PhotonRecords::Enabled()) {
+    hit.path_length = track->GetTrackLength();
+    PhotonRecords::FillScatters(track->GetTrackID(), hit);
+  }
+  if (const auto* tag = dynamic_cast<const OpticalSubEvent::PhotonTag*>(track->GetUserInformation())) {
+    // Sub-event photon: the parent event lives elsewhere, post to its sink.
+    OpticalSubEvent::AddHit(*tag, hit);
+    PhotonRecords::Add(tag->Key(), tag->T0ns(), hit);
+  } else {
+    hits_->insert(new PMTHit(hit));
+    PhotonRecords::Add(currentEventKey_, currentT0ns_, hit);
+  }
+  OpticalRoulette::RecordHit(weight);
   ++totalHits_;
   ++hitsThisEvent_;
 
@@ -75,7 +125,7 @@ G4bool PMTSD::ProcessHits(G4Step* step, G4TouchableHistory*) {
     if (debugCount.fetch_add(1) < 20) {
       const auto* hitPV = targetPV;
       G4cout << "[PMTSD:PhotonStep] event=" << currentEventId_
-             << " volume=" << (hitPV ? hitPV->GetName() : "<null>")
+             << " volume=" << (hitPV ? hitPV->GetName() : SurfaceHits::Enabled() ? "<surface>" : "<null>")
              << " copy=" << copy
              << G4endl;
     }
@@ -86,6 +136,14 @@ G4bool PMTSD::ProcessHits(G4Step* step, G4TouchableHistory*) {
 }
 
 void PMTSD::EndOfEvent(G4HCofThisEvent*) {
+  if (BatchOptics::Enabled()) {
+    // Photons queued by the stacking action are traced now, before digitization.
+    const auto added = BatchOptics::Flush(hits_);
+    totalHits_ += static_cast<G4int>(added);
+    hitsThisEvent_ += static_cast<G4int>(added);
+  }
+  PhotonRecords::Flush();
+
   auto* runManager = G4RunManager::GetRunManager();
   if (!runManager) return;
   auto* event = runManager->GetCurrentEvent();
@@ -129,7 +187,11 @@ void PMTSD::LogAttachmentsOnce() {
     if (pvStore) {
       for (auto* pv : *pvStore) {
         if (pv && pv->GetLogicalVolume() == lv) {
-          copies.push_back(pv->GetCopyNo());
+          if (pv->IsParameterised()) {
+            for (G4int i = 0; i < pv->GetMultiplicity(); ++i) copies.push_back(i);
+          } else {
+            copies.push_back(pv->GetCopyNo());
+          }
         }
       }
     }
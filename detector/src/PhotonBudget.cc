@@ -1,6 +1,12 @@
 #include "PhotonBudget.hh"
 #include "Digitizer.hh"
 #include "IO.hh" 
+#include "LazyCerenkov.hh"
+#include "PrimaryVertexInfo.hh"
+#include "OpticalSubEvent.hh"
+#include "OpticalRoulette.hh"
+#include "OpticalTimeCut.hh"
+#include "PhotonRecords.hh"
 #include "RunManifest.hh"
 #include "G4Event.hh"
 #include "G4OpticalPhoton.hh"
@@ -14,28 +20,59 @@
 #include "G4TouchableHandle.hh"
 
 #include <unordered_set>
+#include <cmath>
 #include <fstream>
 #include <iomanip>
+#include <map>
+#include <mutex>
 #include <regex>
+#include <sstream>
 #include <limits>
 
-static G4ThreeVector g_x0(0,0,0);
-static double g_t0_ns = 0.0;
+static std::mutex g_csv_mutex;          // CSV is shared by all worker threads
 static IORunAction* gIO = nullptr;      // NEW: I/O owner (set from ActionInitialization)
 
-void PrimaryInfo::Set(const G4ThreeVector& x0, double t0_ns){ g_x0=x0; g_t0_ns=t0_ns; }
-const G4ThreeVector& PrimaryInfo::X0(){ return g_x0; }
-double PrimaryInfo::T0ns(){ return g_t0_ns; }
+namespace {
+// One event_budget.csv row.
+struct BudgetRow {
+  int event = -1;
+  int eventId = -1;
+  double nProduced = 0.0;
+  double nAtWall = 0.0;
+  double nAtPMT = 0.0;
+  double t0_ns = 0.0;
+  double t_first_ns = 0.0;
+  double d_first_mm = 0.0;
+  double tof_geom_ns = 0.0;
+  double firstResidualNs = 0.0;
+  std::string first_kind;
+};
+} // namespace
+
+// Sub-event mode: rows of events whose sub-events are still running (g_csv_mutex).
+static std::map<long long, BudgetRow> g_pending_rows;
 
 std::string PhotonBudgetEventAction::s_csv_path = "docs/day4/event_budget.csv"; // NEW default
 bool PhotonBudgetEventAction::s_csv_header_written = false;
 void PhotonBudgetEventAction::SetIORun(IORunAction* io){ gIO = io; }            // NEW
 
-void PhotonBudgetEventAction::BeginOfEventAction(const G4Event*) {
-  nProduced = nAtWall = nAtPMT = 0;
+// Weighted counters stay integer-looking in the CSV when every weight is 1.
+static std::string FormatCount(double n) {
+  std::ostringstream os;
+  if (n == std::floor(n) && n < 1e15) {
+    os << static_cast<long long>(n);
+  } else {
+    os << std::setprecision(10) << n;
+  }
+  return os.str();
+}
+
+void PhotonBudgetEventAction::BeginOfEventAction(const G4Event* ev) {
+  nProduced = nAtWall = nAtPMT = 0.0;
   firstResidualNs = std::numeric_limits<double>::quiet_NaN();
   // --- Day-4 enriched timing/geometry
-  t0_ns       = PrimaryInfo::T0ns();
+  x0          = PrimaryVertexInfo::X0Of(ev);
+  t0_ns       = PrimaryVertexInfo::T0nsOf(ev);
   t_first_ns  = std::numeric_limits<double>::quiet_NaN();
   d_first_mm  = std::numeric_limits<double>::quiet_NaN();
   tof_geom_ns = std::numeric_limits<double>::quiet_NaN();
@@ -43,41 +80,96 @@ void PhotonBudgetEventAction::BeginOfEventAction(const G4Event*) {
   candidates.clear();
 }
 
-void PhotonBudgetEventAction::EndOfEventAction(const G4Event* ev) {
-  // --- (A) CSV: lazy-create & append
-  std::ofstream out(s_csv_path, std::ios::app);
-  if (!s_csv_header_written) {
+// Caller holds g_csv_mutex.
+static void WriteRow(const std::string& path, bool& headerWritten, const BudgetRow& row) {
+  std::ofstream out(path, std::ios::app);
+  if (!headerWritten) {
     out << "event,n_produced,n_wall,n_pmt"
         << ",t0_ns,t_first_ns,d_first_mm,tof_geom_ns,first_residual_ns,first_kind\n";
-    s_csv_header_written = true;
+    headerWritten = true;
   }
-  out << ev->GetEventID() << ","
-      << nProduced << ","
-      << nAtWall   << ","
-      << nAtPMT    << ","
-      << (std::isfinite(t0_ns)       ? t0_ns       : 0.0) << ","
-      << (std::isfinite(t_first_ns)  ? t_first_ns  : 0.0) << ","
-      << (std::isfinite(d_first_mm)  ? d_first_mm  : 0.0) << ","
-      << (std::isfinite(tof_geom_ns) ? tof_geom_ns : 0.0) << ","
-      << (std::isfinite(firstResidualNs) ? firstResidualNs : 0.0) << ","
-      << (first_kind.empty() ? "NA" : first_kind)
+  out << row.event << ","
+      << FormatCount(row.nProduced) << ","
+      << FormatCount(row.nAtWall)   << ","
+      << FormatCount(row.nAtPMT)    << ","
+      << (std::isfinite(row.t0_ns)       ? row.t0_ns       : 0.0) << ","
+      << (std::isfinite(row.t_first_ns)  ? row.t_first_ns  : 0.0) << ","
+      << (std::isfinite(row.d_first_mm)  ? row.d_first_mm  : 0.0) << ","
+      << (std::isfinite(row.tof_geom_ns) ? row.tof_geom_ns : 0.0) << ","
+      << (std::isfinite(row.firstResidualNs) ? row.firstResidualNs : 0.0) << ","
+      << (row.first_kind.empty() ? "NA" : row.first_kind)
       << "\n";
+  out.close();
   // also print a compact line for the log
   const auto& cfg = GetRunManifest();
   if (!cfg.quiet && cfg.opticalVerboseLevel > 0) {
-    G4cout << "[Budget] evt=" << ev->GetEventID()
-           << " Nprod=" << nProduced
-           << " Nwall=" << nAtWall
-           << " Npmt="  << nAtPMT
-           << " firstΔt(ns)=" << (std::isfinite(firstResidualNs)? firstResidualNs : -1.0)
+    G4cout << "[Budget] evt=" << row.eventId
+           << " Nprod=" << row.nProduced
+           << " Nwall=" << row.nAtWall
+           << " Npmt="  << row.nAtPMT
+           << " firstΔt(ns)=" << (std::isfinite(row.firstResidualNs)? row.firstResidualNs : -1.0)
            << G4endl;
   }
+}
+
+// Write the rows of completed sub-event-mode events, with their sub-event counts added.
+static void WriteCompletedRows(const std::string& path, bool& headerWritten,
+                               const std::map<long long, OpticalSubEvent::EventHits>& done) {
+  if (done.empty()) return;
+  std::lock_guard<std::mutex> csvLock(g_csv_mutex);
+  for (const auto& [key, rec] : done) {
+    const auto it = g_pending_rows.find(key);
+    if (it == g_pending_rows.end()) continue;
+    auto& row = it->second;
+    row.nProduced += rec.budget.nProduced;
+    row.nAtWall   += rec.budget.nAtWall;
+    row.nAtPMT    += rec.budget.nAtPMT;
+    WriteRow(path, headerWritten, row);
+    g_pending_rows.erase(it);
+  }
+}
+
+void PhotonBudgetEventAction::EndOfEventAction(const G4Event* ev) {
+  const long long key = PrimaryVertexInfo::KeyOf(ev);
+  const int eventKey = static_cast<int>(key);
+  if (OpticalSubEvent::IsSubEvent(ev)) {
+    // Sub-event batches are bookkeeping units, not events: they post their
+    // counts to the parent, whose row may complete here.
+    WriteCompletedRows(s_csv_path, s_csv_header_written, OpticalSubEvent::CloseSubEvent());
+    return;
+  }
+  BudgetRow row;
+  row.event = eventKey;
+  row.eventId = ev->GetEventID();
+  row.nProduced = nProduced;
+  row.nAtWall = nAtWall;
+  row.nAtPMT = nAtPMT;
+  row.t0_ns = t0_ns;
+  row.t_first_ns = t_first_ns;
+  row.d_first_mm = d_first_mm;
+  row.tof_geom_ns = tof_geom_ns;
+  row.firstResidualNs = firstResidualNs;
+  row.first_kind = first_kind;
+  if (OpticalSubEvent::Enabled()) {
+    // --- (A) CSV: the row waits for the event's sub-events; the thread that
+    // posts the last outstanding part writes it.
+    {
+      std::lock_guard<std::mutex> csvLock(g_csv_mutex);
+      g_pending_rows[key] = row;
+    }
+    WriteCompletedRows(s_csv_path, s_csv_header_written,
+                       OpticalSubEvent::CloseEvent(key, t0_ns));
+  } else {
+    // --- (A) CSV: lazy-create & append (serialized across workers)
+    std::lock_guard<std::mutex> csvLock(g_csv_mutex);
+    WriteRow(s_csv_path, s_csv_header_written, row);
+  }
 
     // --- (B) Digitize & write ROOT (optional; only if run action provided)
   if (gIO) {
     std::vector<DigiHit> dh;
-    gIO->dig.Digitize(ev->GetEventID(), candidates, dh);
-    gIO->dig.AddDarkNoise(ev->GetEventID(), t0_ns, dh);
+    gIO->dig.Digitize(eventKey, t0_ns, candidates, dh);
+    gIO->dig.AddDarkNoise(eventKey, t0_ns, dh);
     // hits tree
     for (const auto& h : dh) {
       gIO->b_event = h.event;
@@ -87,10 +179,10 @@ void PhotonBudgetEventAction::EndOfEventAction(const G4Event* ev) {
       gIO->thits->Fill();
     }
     // events tree (carry Day-3 summary + enriched timing)
-    gIO->e_event    = ev->GetEventID();
-    gIO->e_nprod    = nProduced;
-    gIO->e_nwall    = nAtWall;
-    gIO->e_npmt     = nAtPMT;
+    gIO->e_event    = eventKey;
+    gIO->e_nprod    = static_cast<int>(std::lround(nProduced));
+    gIO->e_nwall    = static_cast<int>(std::lround(nAtWall));
+    gIO->e_npmt     = static_cast<int>(std::lround(nAtPMT));
     gIO->e_t0_ns    = t0_ns;
     gIO->e_tfirst_ns= t_first_ns;
     gIO->e_dfirst_mm= d_first_mm;
@@ -100,7 +192,21 @@ void PhotonBudgetEventAction::EndOfEventAction(const G4Event* ev) {
   }
 }
 
-void PhotonBudgetEventAction::SetCSVPath(const std::string& path) { s_csv_path = path; }
+void PhotonBudgetEventAction::SetCSVPath(const std::string& path) {
+  std::lock_guard<std::mutex> lock(g_csv_mutex);
+  s_csv_path = path;
+}
+
+void PhotonBudgetEventAction::WritePendingRows() {
+  {
+    std::lock_guard<std::mutex> lock(g_csv_mutex);
+    if (g_pending_rows.empty()) return;
+  }
+  auto events = OpticalSubEvent::Drain();
+  G4cout << "[WARN] Sub-event mode: " << events.size()
+         << " events still waiting for sub-events at end of run; writing their budget rows as is" << G4endl;
+  WriteCompletedRows(s_csv_path, s_csv_header_written, events);
+}
 
 PhotonBudgetSteppingAction::PhotonBudgetSteppingAction(PhotonBudgetEventAction* evt,
                                                        std::string patt)
@@ -121,11 +227,20 @@ void PhotonBudgetSteppingAction::UserSteppingAction(const G4Step* step) {
   }
 
   auto* trk = step->GetTrack();
-  if (trk->GetDefinition() != G4OpticalPhoton::Definition()) return;
+  if (trk->GetDefinition() != G4OpticalPhoton::Definition()) {
+    LazyCerenkov::Record(step);
+    return;
+  }
+
+  // Late photons and roulette losers are stopped here; this step is still counted below.
+  if (!OpticalTimeCut::Apply(step)) OpticalRoulette::Apply(step);
+  PhotonRecords::CountScatter(step);
 
   // Count produced photons at their first step
+  // Sub-event photons count toward their parent event's row.
   if (trk->GetCurrentStepNumber() == 1) {
-    ++(evt_->nProduced);
+    if (auto* parent = OpticalSubEvent::BudgetOf(trk)) parent->nProduced += trk->GetWeight();
+    else evt_->nProduced += trk->GetWeight();
   }
 
   // Boundary / volume transitions
@@ -138,7 +253,7 @@ void PhotonBudgetSteppingAction::UserSteppingAction(const G4Step* step) {
     const double n_eff = 1.33;
     const double t_ns  = trk->GetGlobalTime()/ns;
     const auto   x     = step->GetPostStepPoint()->GetPosition();
-    const auto   dx    = (x - PrimaryInfo::X0());
+    const auto   dx    = (x - evt_->x0);
     const double dmm   = dx.mag()/mm;
     const double tof   = dx.mag() / (CLHEP::c_light/n_eff) / ns;
     evt_->t_first_ns   = t_ns;
@@ -153,7 +268,8 @@ void PhotonBudgetSteppingAction::UserSteppingAction(const G4Step* step) {
   if (prePV != postPV && postPV->GetMotherLogical() == nullptr) {
     // count each photon at the wall at most once
     if (seen_wall.insert(trk->GetTrackID()).second) {
-      ++(evt_->nAtWall);
+      if (auto* parent = OpticalSubEvent::BudgetOf(trk)) parent->nAtWall += trk->GetWeight();
+      else evt_->nAtWall += trk->GetWeight();
     }
     // record first time residual if not yet set (use this if no PMT later)
     if (!firstRecorded_) {
@@ -167,7 +283,8 @@ void PhotonBudgetSteppingAction::UserSteppingAction(const G4Step* step) {
     if (name.find(patt_) != std::string::npos) {
       // count each photon at the PMT at most once
       if (seen_pmt.insert(trk->GetTrackID()).second) {
-        ++(evt_->nAtPMT);
+        if (auto* parent = OpticalSubEvent::BudgetOf(trk)) parent->nAtPMT += trk->GetWeight();
+        else evt_->nAtPMT += trk->GetWeight();
         // collect candidate for digitizer
         const auto& touch = step->GetPostStepPoint()->GetTouchableHandle();
         const int pmt_id  = touch->GetCopyNumber(); // adjust depth if needed
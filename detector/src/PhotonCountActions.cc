@@ -1,13 +1,25 @@
 #include "PhotonCountActions.hh"
+#include "BatchOptics.hh"
+#include "LazyCerenkov.hh"
+#include "OpticalSubEvent.hh"
+#include "PhotonLibrary.hh"
+#include "PMTHit.hh"
 #include "RunManifest.hh"
+#include "G4EventManager.hh"
 #include "G4Event.hh"
 #include "G4OpticalPhoton.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SDManager.hh"
+#include "G4SystemOfUnits.hh"
 #include "G4Track.hh"
+#include "Randomize.hh"
 #include <G4ios.hh>
 
-unsigned long long PhotonCountEventAction::total_ = 0;
+std::atomic<unsigned long long> PhotonCountEventAction::total_{0};
 
-void PhotonCountEventAction::EndOfEventAction(const G4Event*) {
+void PhotonCountEventAction::EndOfEventAction(const G4Event* event) {
+  if (OpticalSubEvent::IsSubEvent(event)) return;
   const auto& cfg = GetRunManifest();
   if (!cfg.quiet && cfg.opticalVerboseLevel > 0) {
     G4cout << "[Optics] Event optical photons created: " << count_ << G4endl;
@@ -16,21 +28,99 @@ void PhotonCountEventAction::EndOfEventAction(const G4Event*) {
 
 void PhotonCountEventAction::Inc() {
   ++count_;
-  ++total_;
+  total_.fetch_add(1, std::memory_order_relaxed);
 }
 
 void PhotonCountEventAction::ResetTotal() {
-  total_ = 0;
+  total_.store(0, std::memory_order_relaxed);
 }
 
 unsigned long long PhotonCountEventAction::GetTotal() {
-  return total_;
+  return total_.load(std::memory_order_relaxed);
+}
+
+bool PhotonCountStackingAction::Survives(const G4Track* track) const {
+  const double keep = keep_ / weight_;
+  if (keep < 1.0 && G4UniformRand() >= keep) return false;
+  if (weight_ > 1.0) {
+    // Tracks arrive const; the weight must be set before the photon is stacked.
+    const_cast<G4Track*>(track)->SetWeight(track->GetWeight() * weight_);
+  }
+  return true;
+}
+
+void PhotonCountStackingAction::DepositFromLibrary(const PhotonLibrary& library,
+                                                   const G4Track* track,
+                                                   const G4Event* event) {
+  const G4double energy = track->GetTotalEnergy();
+  if (energy <= 0.0 || !event) return;
+  const G4double lambda_nm = (h_Planck * c_light / energy) / nm;
+  const auto& pos = track->GetPosition();
+  const auto& dir = track->GetMomentumDirection();
+  const auto cell = library.Cell(pos.x() / mm, pos.y() / mm, pos.z() / mm,
+                                 dir.x(), dir.y(), dir.z(), lambda_nm);
+  if (cell < 0) return; // outside the water grid
+
+  // At most one PMT per photon: walk the cumulative hit probabilities.
+  const double u = G4UniformRand();
+  double sum = 0.0;
+  const PhotonLibrary::Entry* hitEntry = nullptr;
+  for (const auto* e = library.Begin(cell); e != library.End(cell); ++e) {
+    sum += e->prob;
+    if (u < sum) {
+      hitEntry = e;
+      break;
+    }
+  }
+  if (!hitEntry) return;
+
+  auto* hce = event->GetHCofThisEvent();
+  if (!hce) return;
+  if (hcId_ < 0) hcId_ = G4SDManager::GetSDMpointer()->GetCollectionID("PMTSD/OpticalHits");
+  auto* hits = hcId_ >= 0 ? static_cast<PMTHitsCollection*>(hce->GetHC(hcId_)) : nullptr;
+  if (!hits) return;
+  const G4double t_ns = track->GetGlobalTime() / ns + hitEntry->tMeanNs +
+                        (hitEntry->tRmsNs > 0.0f ? G4RandGauss::shoot(0.0, hitEntry->tRmsNs) : 0.0);
+  hits->insert(new PMTHit(hitEntry->pmt, t_ns * ns, track->GetWeight(), lambda_nm, /*flags=*/0));
+}
+
+void PhotonCountStackingAction::PrepareNewEvent() {
+  LazyCerenkov::BeginEvent();
+}
+
+void PhotonCountStackingAction::NewStage() {
+  LazyCerenkov::Emit(stackManager);
 }
 
 G4ClassificationOfNewTrack
 PhotonCountStackingAction::ClassifyNewTrack(const G4Track* track) {
+  // Segment replay: the primary only carries the stored vertex.
+  if (LazyCerenkov::Replaying() && track->GetParentID() == 0) return fKill;
   if (track->GetDefinition() == G4OpticalPhoton::Definition()) {
+    const auto* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+    if (const auto* library = PhotonLibrary::Shared()) {
+      // Fast optical mode: the library stands in for tracking.
+      if (evt_) evt_->Inc();
+      if (Survives(track)) DepositFromLibrary(*library, track, event);
+      return fKill;
+    }
+    if (BatchOptics::Enabled()) {
+      // Batch backend: queue for the end-of-event tracer instead of tracking.
+      if (evt_) evt_->Inc();
+      if (Survives(track)) BatchOptics::Enqueue(track);
+      return fKill;
+    }
+    if (OpticalSubEvent::Enabled() && !OpticalSubEvent::IsSubEvent(event)) {
+      if (evt_) evt_->Inc();
+      if (!Survives(track)) return fKill;
+      return OpticalSubEvent::Route(track, event);
+    }
+    if (OpticalSubEvent::IsSubEvent(event)) {
+      OpticalSubEvent::Arrive(track); // thinned before routing
+      return fUrgent;
+    }
     if (evt_) evt_->Inc();
+    if (!Survives(track)) return fKill;
   }
   return fUrgent;
 }
@@ -0,0 +1,123 @@
+#include "PhotonLibrary.hh"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'L', 'N', 'D', 'R', 'P', 'L', '1'};
+
+std::unique_ptr<PhotonLibrary> gShared;
+
+int Bin(double value, double lo, double hi, int n) {
+  const int b = static_cast<int>(std::floor((value - lo) / (hi - lo) * n));
+  return std::clamp(b, 0, n - 1);
+}
+
+} // namespace
+
+PhotonLibrary::~PhotonLibrary() {
+  if (fMap) munmap(fMap, fMapSize);
+}
+
+std::unique_ptr<PhotonLibrary> PhotonLibrary::Open(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("PhotonLibrary: cannot open '" + path + "': " + std::strerror(errno));
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Header)) {
+    ::close(fd);
+    throw std::runtime_error("PhotonLibrary: '" + path + "' is too short for a header");
+  }
+  void* map = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd); // the mapping keeps the file open
+  if (map == MAP_FAILED) {
+    throw std::runtime_error("PhotonLibrary: mmap of '" + path + "' failed: " + std::strerror(errno));
+  }
+
+  std::unique_ptr<PhotonLibrary> lib(new PhotonLibrary());
+  lib->fPath = path;
+  lib->fMap = map;
+  lib->fMapSize = static_cast<std::size_t>(st.st_size);
+  lib->fHeader = static_cast<const Header*>(map);
+
+  const Header& h = *lib->fHeader;
+  if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) {
+    throw std::runtime_error("PhotonLibrary: '" + path + "' is not a version-" +
+                             std::to_string(kVersion) + " photon library");
+  }
+  const std::uint64_t cells = static_cast<std::uint64_t>(h.nVoxel[0]) * h.nVoxel[1] * h.nVoxel[2] *
+                              h.nCosTheta * h.nPhi * h.nLambda;
+  const std::size_t expected = sizeof(Header) + (h.nCells + 1) * sizeof(std::uint64_t) +
+                               h.nEntries * sizeof(Entry);
+  if (cells == 0 || cells != h.nCells || lib->fMapSize != expected) {
+    throw std::runtime_error("PhotonLibrary: '" + path + "' has an inconsistent size or binning");
+  }
+  const auto* base = static_cast<const unsigned char*>(map);
+  lib->fOffsets = reinterpret_cast<const std::uint64_t*>(base + sizeof(Header));
+  lib->fEntries = reinterpret_cast<const Entry*>(base + sizeof(Header) +
+                                                 (h.nCells + 1) * sizeof(std::uint64_t));
+  if (lib->fOffsets[h.nCells] != h.nEntries) {
+    throw std::runtime_error("PhotonLibrary: '" + path + "' has corrupt cell offsets");
+  }
+  return lib;
+}
+
+void PhotonLibrary::Write(const std::string& path, Header header,
+                          const std::vector<std::uint64_t>& offsets,
+                          const std::vector<Entry>& entries) {
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.nEntries = entries.size();
+  if (offsets.size() != header.nCells + 1 || offsets.back() != entries.size()) {
+    throw std::runtime_error("PhotonLibrary::Write: offsets do not match the cell count");
+  }
+  const auto dir = std::filesystem::path(path).parent_path();
+  if (!dir.empty()) std::filesystem::create_directories(dir);
+  // Write next to the target and rename, so jobs never map a half-written file.
+  const std::string tmp = path + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("PhotonLibrary::Write: cannot create '" + tmp + "'");
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(offsets.data()),
+              static_cast<std::streamsize>(offsets.size() * sizeof(std::uint64_t)));
+    out.write(reinterpret_cast<const char*>(entries.data()),
+              static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+    if (!out) throw std::runtime_error("PhotonLibrary::Write: write to '" + tmp + "' failed");
+  }
+  std::filesystem::rename(tmp, path);
+}
+
+void PhotonLibrary::SetShared(std::unique_ptr<PhotonLibrary> library) {
+  gShared = std::move(library);
+}
+
+const PhotonLibrary* PhotonLibrary::Shared() { return gShared.get(); }
+
+std::int64_t PhotonLibrary::Cell(double x, double y, double z,
+                                 double dx, double dy, double dz, double lambda_nm) const {
+  const Header& h = *fHeader;
+  const double p[3] = {x, y, z};
+  std::int64_t cell = 0;
+  for (int a = 0; a < 3; ++a) {
+    if (p[a] < h.lo[a] || p[a] >= h.hi[a]) return -1;
+    cell = cell * h.nVoxel[a] + Bin(p[a], h.lo[a], h.hi[a], h.nVoxel[a]);
+  }
+  const double pi = std::acos(-1.0);
+  cell = cell * h.nCosTheta + Bin(dz, -1.0, 1.0, h.nCosTheta);
+  cell = cell * h.nPhi + Bin(std::atan2(dy, dx), -pi, pi, h.nPhi);
+  cell = cell * h.nLambda + Bin(lambda_nm, h.lambdaMin, h.lambdaMax, h.nLambda);
+  return cell;
+}
@@ -0,0 +1,125 @@
+#include "PhotonRecords.hh"
+
+#include "PMTHit.hh"
+
+#include <G4Event.hh>
+#include <G4EventManager.hh>
+#include <G4Step.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4Track.hh>
+#include <G4VProcess.hh>
+#include <G4ios.hh>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+std::string gPath;
+std::mutex gFileMutex;
+std::ofstream gOut;
+
+std::atomic<unsigned long long> gRecords{0};
+std::atomic<unsigned long long> gScattered{0};
+
+// Scatter tallies of the current event on this thread (track ids are per event).
+struct ScatterState {
+  int eventId = -1;
+  std::unordered_map<int, std::pair<int, int>> counts; // track id -> (Rayleigh, Mie)
+};
+thread_local ScatterState tScatters;
+
+thread_local std::ostringstream tQueue;
+thread_local unsigned long long tQueued = 0;
+
+} // namespace
+
+namespace PhotonRecords {
+
+void Configure(const std::string& csvPath) {
+  const auto dir = std::filesystem::path(csvPath).parent_path();
+  if (!dir.empty()) std::filesystem::create_directories(dir);
+  gOut.open(csvPath, std::ios::trunc);
+  if (!gOut) throw std::runtime_error("PhotonRecords: cannot create '" + csvPath + "'");
+  gOut << "event,pmt,t_rel_ns,weight,wavelength_nm,path_mm,n_rayleigh,n_mie\n";
+  gPath = csvPath;
+}
+
+bool Enabled() { return !gPath.empty(); }
+
+const std::string& Path() { return gPath; }
+
+void CountScatter(const G4Step* step) {
+  if (!Enabled()) return;
+  const auto* process = step->GetPostStepPoint()->GetProcessDefinedStep();
+  if (!process) return;
+  const auto& name = process->GetProcessName();
+  const bool rayleigh = name == "OpRayleigh";
+  if (!rayleigh && name != "OpMieHG") return;
+
+  const auto* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  const int eventId = event ? event->GetEventID() : -1;
+  if (eventId != tScatters.eventId) {
+    tScatters.eventId = eventId;
+    tScatters.counts.clear();
+  }
+  auto& count = tScatters.counts[step->GetTrack()->GetTrackID()];
+  (rayleigh ? count.first : count.second) += 1;
+}
+
+void FillScatters(int trackId, PMTHit& hit) {
+  if (tScatters.counts.empty()) return;
+  const auto* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  if ((event ? event->GetEventID() : -1) != tScatters.eventId) return;
+  const auto it = tScatters.counts.find(trackId);
+  if (it == tScatters.counts.end()) return;
+  hit.n_rayleigh = it->second.first;
+  hit.n_mie = it->second.second;
+  tScatters.counts.erase(it); // the photon is absorbed at the photocathode
+}
+
+void Add(long long key, double t0_ns, const PMTHit& hit) {
+  if (!Enabled()) return;
+  if (tQueued == 0) tQueue.precision(9);
+  tQueue << key << ',' << hit.pmt_id << ',' << (hit.time / ns - t0_ns) << ',' << hit.pe << ','
+         << hit.wavelength_nm << ',' << hit.path_length / mm << ',' << hit.n_rayleigh << ','
+         << hit.n_mie << '\n';
+  ++tQueued;
+  gRecords.fetch_add(1, std::memory_order_relaxed);
+  if (hit.n_rayleigh > 0 || hit.n_mie > 0) gScattered.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Flush() {
+  if (!Enabled() || tQueued == 0) return;
+  {
+    // One locked write per event, so workers never interleave rows.
+    std::lock_guard<std::mutex> lock(gFileMutex);
+    gOut << tQueue.str();
+  }
+  tQueue.str(std::string());
+  tQueue.clear();
+  tQueued = 0;
+}
+
+void ResetCounters() {
+  gRecords = 0;
+  gScattered = 0;
+}
+
+void Report() {
+  if (!Enabled()) return;
+  {
+    std::lock_guard<std::mutex> lock(gFileMutex);
+    gOut.flush();
+  }
+  G4cout << "[PhotonRecords] out=" << gPath << " photons=" << gRecords.load()
+         << " scattered=" << gScattered.load() << G4endl;
+}
+
+} // namespace PhotonRecords
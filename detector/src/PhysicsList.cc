@@ -2,6 +2,7 @@
 
 #include <string>
 
+#include <G4FastSimulationPhysics.hh>
 #include <G4OpticalParameters.hh>
 #include <G4OpticalPhysics.hh>
 #include <G4OpticalPhoton.hh>
@@ -26,6 +27,12 @@ PhysicsList::PhysicsList(const OpticalProcessConfig& cfg)
   : FTFP_BERT(), fConfig(cfg) {
   auto* optical = new G4OpticalPhysics();
   RegisterPhysics(optical);
+  if (fConfig.fastDirectLight) {
+    // Hands optical photons to DirectLightModel in the water can region.
+    auto* fastSim = new G4FastSimulationPhysics();
+    fastSim->ActivateFastSimulation("opticalphoton");
+    RegisterPhysics(fastSim);
+  }
 
   // Mirror configuration onto shared optical parameters singleton (used by processes at runtime).
   auto* params = G4OpticalParameters::Instance();
@@ -46,6 +53,7 @@ PhysicsList::PhysicsList(const OpticalProcessConfig& cfg)
          << " Boundary=" << OnOff(fConfig.enableBoundary)
          << " maxPhotons=" << fConfig.maxPhotonsPerStep
          << " maxBetaΔ=" << fConfig.maxBetaChangePerStep
+         << " fastDirectLight=" << OnOff(fConfig.fastDirectLight)
          << G4endl;
 }
 
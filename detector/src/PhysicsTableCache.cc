@@ -0,0 +1,168 @@
+#include "PhysicsTableCache.hh"
+
+#include <G4StateManager.hh>
+#include <G4VStateDependent.hh>
+#include <G4VUserPhysicsList.hh>
+#include <G4ios.hh>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* kCompleteMarker = "complete";
+constexpr const char* kKeyFile = "key.txt";
+
+bool gEnabled = false;
+bool gRetrieved = false;
+bool gStoreTried = false;
+bool gStartupReported = false;
+std::string gDirectory;
+std::string gKey;
+G4VUserPhysicsList* gPhysicsList = nullptr;
+
+Clock::time_point gProcessStart;
+Clock::time_point gFirstInit;
+bool gFirstInitSeen = false;
+
+double Ms(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+// Times each stay in G4State_Init: the first is /run/initialize, the second
+// the first BeamOn's run initialisation.
+class InitPhaseTimer : public G4VStateDependent {
+public:
+  G4bool Notify(G4ApplicationState requested) override {
+    const auto current = G4StateManager::GetStateManager()->GetCurrentState();
+    const auto now = Clock::now();
+    if (requested == G4State_Init && current != G4State_Init) {
+      fStart = now;
+      if (!gFirstInitSeen) {
+        gFirstInit = now;
+        gFirstInitSeen = true;
+      }
+    } else if (current == G4State_Init && requested != G4State_Init) {
+      phases.push_back(Ms(fStart, now));
+    }
+    return true;
+  }
+
+  std::vector<double> phases;
+
+private:
+  Clock::time_point fStart;
+};
+
+InitPhaseTimer* gTimer = nullptr; // registered with the state manager, never deleted
+
+std::uintmax_t DirectoryBytes(const fs::path& dir, std::size_t& files) {
+  std::uintmax_t bytes = 0;
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator(dir, ec)) {
+    if (!entry.is_regular_file(ec)) continue;
+    ++files;
+    bytes += entry.file_size(ec);
+  }
+  return bytes;
+}
+
+} // namespace
+
+namespace PhysicsTableCache {
+
+void StartTimer() {
+  gProcessStart = Clock::now();
+  if (!gTimer) gTimer = new InitPhaseTimer();
+}
+
+std::string Hash(const std::string& text) {
+  std::uint64_t h = 1469598103934665603ull;
+  for (unsigned char c : text) {
+    h ^= c;
+    h *= 1099511628211ull;
+  }
+  std::ostringstream os;
+  os << std::hex << std::setw(16) << std::setfill('0') << h;
+  return os.str();
+}
+
+void Configure(const std::string& root, const std::string& key, G4VUserPhysicsList* physicsList) {
+  if (root.empty() || !physicsList) return;
+  gEnabled = true;
+  gKey = key;
+  gPhysicsList = physicsList;
+  gDirectory = (fs::path(root) / Hash(key)).string();
+  std::error_code ec;
+  gRetrieved = fs::exists(fs::path(gDirectory) / kCompleteMarker, ec);
+  if (gRetrieved) {
+    physicsList->SetPhysicsTableRetrieved(gDirectory);
+  }
+  G4cout << "[PhysCache] dir=" << gDirectory << " tables=" << (gRetrieved ? "retrieve" : "build+store")
+         << G4endl;
+}
+
+bool Enabled() { return gEnabled; }
+bool Retrieved() { return gRetrieved; }
+const std::string& Directory() { return gDirectory; }
+
+void ReportStartup() {
+  if (gStartupReported) return;
+  gStartupReported = true;
+  const auto now = Clock::now();
+  const std::vector<double> phases = gTimer ? gTimer->phases : std::vector<double>();
+  G4cout << "[STARTUP] setup_ms=" << (gFirstInitSeen ? Ms(gProcessStart, gFirstInit) : 0.0)
+         << " initialize_ms=" << (phases.size() > 0 ? phases[0] : 0.0)
+         << " run_init_ms=" << (phases.size() > 1 ? phases[1] : 0.0)
+         << " to_first_run_ms=" << Ms(gProcessStart, now)
+         << " physics_tables=" << (!gEnabled ? "built" : gRetrieved ? "retrieved" : "built+store")
+         << " cache=" << (gEnabled ? gDirectory : std::string("off")) << G4endl;
+}
+
+void StoreIfMissing() {
+  if (!gEnabled || gRetrieved || gStoreTried) return;
+  gStoreTried = true;
+  const fs::path dir(gDirectory);
+  std::error_code ec;
+  if (fs::exists(dir / kCompleteMarker, ec)) return; // another process got there first
+
+  const auto start = Clock::now();
+  const fs::path tmp = gDirectory + ".tmp." + std::to_string(::getpid());
+  fs::remove_all(tmp, ec);
+  fs::create_directories(tmp, ec);
+  if (ec) {
+    G4cout << "[WARN] PhysCache: cannot create '" << tmp.string() << "': " << ec.message() << G4endl;
+    return;
+  }
+  if (!gPhysicsList->StorePhysicsTable(tmp.string())) {
+    G4cout << "[WARN] PhysCache: StorePhysicsTable failed; nothing cached" << G4endl;
+    fs::remove_all(tmp, ec);
+    return;
+  }
+  std::ofstream(tmp / kKeyFile) << gKey << '\n';
+  std::ofstream(tmp / kCompleteMarker) << "ok\n";
+  std::size_t files = 0;
+  const auto bytes = DirectoryBytes(tmp, files);
+  fs::rename(tmp, dir, ec);
+  if (ec) {
+    // Lost the race to a concurrent job (or the rename failed): keep theirs.
+    fs::remove_all(tmp, ec);
+    return;
+  }
+  G4cout << "[PhysCache] stored dir=" << gDirectory << " files=" << files
+         << " mb=" << bytes / (1024.0 * 1024.0) << " store_ms=" << Ms(start, Clock::now()) << G4endl;
+}
+
+} // namespace PhysicsTableCache
@@ -1,12 +1,20 @@
 #include "PrimaryGeneratorAction.hh"
 
+#include "EventSeeder.hh"
 #include "GeometryRegistry.hh"
+#include "LazyCerenkov.hh"
+#include "PrimaryVertexInfo.hh"
 #include "RootrackerPrimaryGenerator.hh"
 
+#include <G4Event.hh>
 #include <G4GenericMessenger.hh>
+#include <G4Geantino.hh>
 #include <G4OpticalPhoton.hh>
 #include <G4ParticleGun.hh>
 #include <G4ParticleTable.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4RunManager.hh>
 #include <G4SystemOfUnits.hh>
 #include <G4ThreeVector.hh>
 #include <G4ios.hh>
@@ -40,7 +48,7 @@ PrimaryGeneratorAction::PrimaryGeneratorAction(const G4String& rootFile,
 
   fMessenger->DeclareMethod("aimAtPMT",
                             &PrimaryGeneratorAction::AimAtPMTCommand,
-                            "Aim optical gun at PMT: /fln/aimAtPMT <id> [offset_mm] [energy_eV] [count]");
+                            "Aim optical gun at PMT: /fln/aimAtPMT <id> [offset_mm] [energy_eV] [count] [tilt_deg] [water]");
 
   auto& countCmd = fMessenger->DeclareMethod("gunCount",
                                              &PrimaryGeneratorAction::SetPhotonGunCount,
@@ -80,17 +88,44 @@ void PrimaryGeneratorAction::AnnounceModeOnce() {
 }
 
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* event) {
+  if (LazyCerenkov::Replaying()) {
+    GenerateFromSegments(event);
+    return;
+  }
   AnnounceModeOnce();
 
   if (fMode == "gun") {
+    EventSeeder::SeedEvent(event->GetEventID());
     for (int i = 0; i < std::max(1, fGunPhotonCount); ++i) {
       fGun->GeneratePrimaryVertex(event);
     }
+    PrimaryVertexInfo::Attach(event, fGun->GetParticlePosition(),
+                              fGun->GetParticleTime() / ns);
   } else {
     EnsureRootracker()->GeneratePrimaries(event);
   }
 }
 
+void PrimaryGeneratorAction::GenerateFromSegments(G4Event* event) {
+  long long key = -1;
+  double t0ns = 0.0;
+  G4ThreeVector x0;
+  if (!LazyCerenkov::LoadNextEvent(key, t0ns, x0)) {
+    G4Exception("PrimaryGeneratorAction", "EndOfSegments", JustWarning,
+                "No more stored segment events; aborting run cleanly.");
+    auto* rm = G4RunManager::GetRunManager();
+    if (rm) rm->AbortRun(true);
+    return;
+  }
+  EventSeeder::SeedEvent(key);
+  // The optical photons come from the stored segments; a geantino only
+  // carries the vertex and is dropped by the stacking action.
+  auto* vtx = new G4PrimaryVertex(x0, t0ns * ns);
+  vtx->SetPrimary(new G4PrimaryParticle(G4Geantino::Definition(), 0.0, 0.0, 1.0 * MeV));
+  event->AddPrimaryVertex(vtx);
+  PrimaryVertexInfo::Attach(event, x0, t0ns, key);
+}
+
 void PrimaryGeneratorAction::AimAtPMTCommand(const G4String& args) {
   std::string cleaned(args);
   cleaned.erase(std::remove(cleaned.begin(), cleaned.end(), '"'), cleaned.end());
@@ -106,13 +141,26 @@ void PrimaryGeneratorAction::AimAtPMTCommand(const G4String& args) {
   while (iss >> value) {
     values.push_back(value);
   }
+  // A trailing "water" fires from the water side onto the photocathode face.
+  bool fromWater = false;
+  iss.clear();
+  std::string side;
+  if (iss >> side) {
+    if (side != "water") {
+      G4cout << "[PHOTON_GUN] ERROR: /fln/aimAtPMT: unknown argument '" << side << "'." << G4endl;
+      return;
+    }
+    fromWater = true;
+  }
   double offset = values.size() > 0 ? values[0] : 50.0;
   double energy = values.size() > 1 ? values[1] : 3.0;
   int count = values.size() > 2 ? static_cast<int>(std::round(values[2])) : 1;
-  AimAtPMT(id, offset, energy, count);
+  double tilt = values.size() > 3 ? values[3] : 0.0;
+  AimAtPMT(id, offset, energy, count, tilt, fromWater);
 }
 
-void PrimaryGeneratorAction::AimAtPMT(int id, double offset_mm, double energy_eV, int count) {
+void PrimaryGeneratorAction::AimAtPMT(int id, double offset_mm, double energy_eV, int count,
+                                      double tilt_deg, bool fromWater) {
   PMTRecord rec;
   if (!GeometryRegistry::Instance().GetPMT(id, rec)) {
     G4cout << "[PHOTON_GUN] ERROR: PMT id=" << id << " not found." << G4endl;
@@ -130,13 +178,18 @@ void PrimaryGeneratorAction::AimAtPMT(int id, double offset_mm, double energy_eV
     normal = normal.unit();
   }
 
+  // `fromWater` fires onto the photocathode face from the water side; a tilt
+  // makes the incidence oblique, still aimed at the PMT centre.
+  G4ThreeVector dir = fromWater ? -normal : normal;
+  if (tilt_deg != 0.0) dir.rotate(tilt_deg * deg, normal.orthogonal());
+
   const G4double offset = offset_mm * mm;
-  G4ThreeVector gunPos = rec.position - normal * offset;
+  G4ThreeVector gunPos = rec.position - dir * offset;
 
   fGun->SetParticleDefinition(G4OpticalPhoton::OpticalPhotonDefinition());
   fGun->SetNumberOfParticles(1);
   fGun->SetParticlePosition(gunPos);
-  fGun->SetParticleMomentumDirection(normal);
+  fGun->SetParticleMomentumDirection(dir);
   fGun->SetParticleEnergy(energy_eV * eV);
   fGunPhotonCount = count;
 
@@ -154,9 +207,11 @@ void PrimaryGeneratorAction::AimAtPMT(int id, double offset_mm, double energy_eV
   G4cout << std::setprecision(2);
   G4cout << "[PHOTON_GUN] pmt=" << id
          << " pos=(" << gunPos.x()/mm << "," << gunPos.y()/mm << "," << gunPos.z()/mm << ") mm"
-         << " dir=(" << normal.x() << "," << normal.y() << "," << normal.z() << ")"
+         << " dir=(" << dir.x() << "," << dir.y() << "," << dir.z() << ")"
          << " E=" << energy_eV << " eV"
          << " offset=" << offset_mm << " mm"
+         << " tilt_deg=" << tilt_deg
+         << " side=" << (fromWater ? "water" : "back")
          << " phi_deg=" << phi_norm
          << " count=" << count
          << G4endl;
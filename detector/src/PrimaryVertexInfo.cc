@@ -0,0 +1,43 @@
+#include "PrimaryVertexInfo.hh"
+
+#include <G4Event.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4ios.hh>
+
+void PrimaryVertexInfo::Print() const {
+  G4cout << "[PrimaryVertex] x0(mm)=(" << fX0.x() / mm << "," << fX0.y() / mm << "," << fX0.z() / mm
+         << ") t0(ns)=" << fT0ns
+         << " entry=" << fEntry << G4endl;
+}
+
+void PrimaryVertexInfo::Attach(G4Event* event, const G4ThreeVector& x0, double t0_ns, long long entry) {
+  if (!event) return;
+  if (auto* existing = dynamic_cast<PrimaryVertexInfo*>(event->GetUserInformation())) {
+    existing->fX0 = x0;
+    existing->fT0ns = t0_ns;
+    existing->fEntry = entry;
+    return;
+  }
+  event->SetUserInformation(new PrimaryVertexInfo(x0, t0_ns, entry));
+}
+
+const PrimaryVertexInfo* PrimaryVertexInfo::Find(const G4Event* event) {
+  if (!event) return nullptr;
+  return dynamic_cast<const PrimaryVertexInfo*>(event->GetUserInformation());
+}
+
+G4ThreeVector PrimaryVertexInfo::X0Of(const G4Event* event) {
+  const auto* info = Find(event);
+  return info ? info->X0() : G4ThreeVector();
+}
+
+double PrimaryVertexInfo::T0nsOf(const G4Event* event) {
+  const auto* info = Find(event);
+  return info ? info->T0ns() : 0.0;
+}
+
+long long PrimaryVertexInfo::KeyOf(const G4Event* event) {
+  if (!event) return -1;
+  const auto* info = Find(event);
+  return (info && info->Entry() >= 0) ? info->Entry() : event->GetEventID();
+}
@@ -0,0 +1,286 @@
+#include "RootrackerSource.hh"
+
+#include <G4Exception.hh>
+#include <G4GenericMessenger.hh>
+#include <G4ios.hh>
+
+#include <TFile.h>
+#include <TKey.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <optional>
+#include <string>
+
+namespace {
+
+TTree* FindTreeByGuess(TFile* f) {
+  if (!f) return nullptr;
+  // common name
+  if (auto* t = dynamic_cast<TTree*>(f->Get("gRooTracker"))) return t;
+  // otherwise pick the first TTree in the file
+  TIter nextkey(f->GetListOfKeys());
+  while (auto* key = (TKey*)nextkey()) {
+    if (std::string(key->GetClassName()) == "TTree")
+      return dynamic_cast<TTree*>(key->ReadObj());
+  }
+  return nullptr;
+}
+
+void RaiseTo(std::atomic<long long>& target, long long value) {
+  long long cur = target.load();
+  while (cur < value && !target.compare_exchange_weak(cur, value)) {}
+}
+
+std::atomic<RootrackerSource*> gShared{nullptr};
+
+} // namespace
+
+RootrackerSource* RootrackerSource::Shared() {
+  return gShared.load();
+}
+
+RootrackerSource::RootrackerSource(const G4String& fileName, G4double zShiftMM)
+: fFileName(fileName), fZShiftMM(zShiftMM) {
+  RootrackerSource* expected = nullptr;
+  if (!gShared.compare_exchange_strong(expected, this)) return; // private reader, no UI
+
+  // UI: /rootracker/* lives on the master only; workers never see these
+  // commands, so a seek cannot race with entries being claimed.
+  fMsg = std::make_unique<G4GenericMessenger>(this, "/rootracker/", "Rootracker controls");
+  auto& idx = fMsg->DeclareMethod("eventIndex", &RootrackerSource::SetEventIndexCmd,
+                                  "Set next entry index (0-based).");
+  idx.command->SetToBeBroadcasted(false);
+  auto& dz = fMsg->DeclareMethod("zShiftMM", &RootrackerSource::SetZShiftMM,
+                                 "Additive z shift [mm] to map CAN->GDML.");
+  dz.command->SetToBeBroadcasted(false);
+  auto& depth = fMsg->DeclareMethod("prefetch", &RootrackerSource::SetPrefetchDepth,
+                                    "Number of decoded entries kept ahead of the workers.");
+  depth.command->SetToBeBroadcasted(false);
+}
+
+RootrackerSource::~RootrackerSource() {
+  Stop();
+  RootrackerSource* self = this;
+  gShared.compare_exchange_strong(self, nullptr);
+}
+
+void RootrackerSource::SetPrefetchDepth(G4int depth) {
+  std::lock_guard<std::mutex> lock(fControlMutex);
+  if (fRunning.load()) {
+    G4cout << "[Rootracker] prefetch depth applies from the next run" << G4endl;
+  }
+  fDepth = static_cast<std::size_t>(std::max(1, depth));
+}
+
+bool RootrackerSource::OpenTree() {
+  if (fTree) return true;
+  fFile.reset(TFile::Open(fFileName.c_str(), "READ"));
+  if (!fFile || fFile->IsZombie()) return false;
+  fTree = FindTreeByGuess(fFile.get());
+  if (!fTree) return false;
+
+  // Attach branches if present
+  fTree->SetBranchStatus("*",0);
+  auto enable = [&](const char* b){
+    if (fTree->GetBranch(b)) { fTree->SetBranchStatus(b,1); return true; }
+    return false;
+  };
+  enable("EvtVtx");      fTree->SetBranchAddress("EvtVtx",     EvtVtx);
+  enable("StdHepN");     fTree->SetBranchAddress("StdHepN",    &StdHepN);
+  enable("StdHepPdg");   fTree->SetBranchAddress("StdHepPdg",  StdHepPdg);
+  fHasStatus = enable("StdHepStatus");
+  if (fHasStatus)
+    fTree->SetBranchAddress("StdHepStatus", StdHepStatus);
+  if (enable("StdHepP4"))
+    fTree->SetBranchAddress("StdHepP4",     StdHepP4);
+  else
+    G4Exception("RootrackerSource","NoP4",JustWarning,
+                "StdHepP4 not found; momentumless primaries would be useless.");
+
+  fEntries = fTree->GetEntries();
+  G4cout << "[Rootracker] Opened " << fFileName << " with " << fEntries << " entries\n";
+  ResolveRangeLocked();
+  return true;
+}
+
+void RootrackerSource::ResolveRangeLocked() {
+  if (fRangeResolved) return;
+  fRangeResolved = true;
+  if (fShardCount > 0) {
+    fRangeBegin = fEntries * fShardIndex / fShardCount;
+    fRangeEnd   = fEntries * (fShardIndex + 1) / fShardCount;
+  } else {
+    fRangeBegin = std::min(fRangeBegin, fEntries);
+    fRangeEnd   = fRangeCount < 0 ? fEntries : std::min(fEntries, fRangeBegin + fRangeCount);
+  }
+  fNextEntry.store(std::max(fNextEntry.load(), fRangeBegin));
+  if (fShardCount > 0 || fRangeBegin > 0 || fRangeEnd < fEntries) {
+    G4cout << "[Rootracker] Entry range [" << fRangeBegin << ", " << fRangeEnd << ")";
+    if (fShardCount > 0) G4cout << " shard " << fShardIndex << "/" << fShardCount;
+    G4cout << G4endl;
+  }
+}
+
+void RootrackerSource::SetEntryRange(long long first, long long count) {
+  std::lock_guard<std::mutex> lock(fControlMutex);
+  fRangeBegin = std::max(0LL, first);
+  fRangeCount = count;
+  fShardIndex = -1;
+  fShardCount = 0;
+  fRangeResolved = false;
+  fNextEntry.store(fRangeBegin);
+}
+
+void RootrackerSource::SetShard(int index, int count) {
+  std::lock_guard<std::mutex> lock(fControlMutex);
+  if (count <= 0 || index < 0 || index >= count) {
+    G4Exception("RootrackerSource::SetShard","BadShard",FatalException,
+                ("Invalid shard " + std::to_string(index) + "/" + std::to_string(count)).c_str());
+    return;
+  }
+  fShardIndex = index;
+  fShardCount = count;
+  fRangeResolved = false;
+  fNextEntry.store(0);
+}
+
+long long RootrackerSource::RangeBegin() {
+  std::lock_guard<std::mutex> lock(fControlMutex);
+  if (!fRangeResolved) OpenTree();
+  return fRangeBegin;
+}
+
+long long RootrackerSource::RangeEnd() {
+  std::lock_guard<std::mutex> lock(fControlMutex);
+  if (!fRangeResolved) OpenTree();
+  return fRangeEnd < 0 ? fEntries : fRangeEnd;
+}
+
+void RootrackerSource::StartLocked() {
+  if (fRunning.load()) return;
+  if (!OpenTree()) {
+    G4Exception("RootrackerSource","NoTree",FatalException,
+                ("Failed to open ROOTRACKER tree from "+std::string(fFileName)).c_str());
+    return;
+  }
+  fQueue = std::make_unique<BoundedQueue<RootrackerPrimary>>(fDepth);
+  fStopRequested.store(false);
+  fProducerDone.store(false);
+  fRunning.store(true);
+  fProducer = std::thread(&RootrackerSource::ProducerLoop, this, fNextEntry.load());
+}
+
+void RootrackerSource::ProducerLoop(long long first) {
+  const long long end = fRangeEnd < 0 ? fEntries : std::min(fRangeEnd, fEntries);
+  for (long long i = std::max(0LL, first); i < end; ++i) {
+    RootrackerPrimary rec;
+    Decode(i, rec);
+    if (!fQueue->TryPush(rec)) {
+      // Full: workers are behind; sleep until one claims a record.
+      std::unique_lock<std::mutex> lock(fWaitMutex);
+      fNotFull.wait(lock, [&] { return fStopRequested.load() || fQueue->TryPush(rec); });
+    }
+    if (fStopRequested.load()) return;
+    { std::lock_guard<std::mutex> lock(fWaitMutex); }
+    fNotEmpty.notify_one();
+  }
+  {
+    std::lock_guard<std::mutex> lock(fWaitMutex);
+    fProducerDone.store(true);
+  }
+  fNotEmpty.notify_all();
+}
+
+bool RootrackerSource::Decode(long long i, RootrackerPrimary& out) {
+  out = RootrackerPrimary{};
+  out.entry = i;
+  fTree->GetEntry(i);
+
+  // Choose the outgoing charged lepton (prefer mu±, status==1 if available)
+  int idx = -1;
+  for (int j=0; j<StdHepN; ++j) {
+    int pdg = StdHepPdg[j];
+    if (pdg==13 || pdg==-13) {
+      if (fHasStatus) {
+        if (StdHepStatus[j]==1) { idx = j; break; }
+      } else { idx = j; break; }
+    }
+  }
+  if (idx<0) {
+    // fallback: pick the highest-momentum charged final state
+    double bestp2 = -1;
+    for (int j=0; j<StdHepN; ++j) {
+      if (fHasStatus && StdHepStatus[j]!=1) continue;
+      int pdg = StdHepPdg[j];
+      if (pdg==22 || pdg==12 || pdg==-12 || pdg==14 || pdg==-14 || pdg==16 || pdg==-16) continue; // skip γ, ν
+      double px = StdHepP4[j][0], py=StdHepP4[j][1], pz=StdHepP4[j][2];
+      double p2 = px*px+py*py+pz*pz;
+      if (p2>bestp2) { bestp2=p2; idx=j; }
+    }
+  }
+  if (idx<0) return false; // pdg stays 0; the worker raises the exception
+
+  // Units: GeV→MeV; m→mm; s→ns
+  out.pdg = StdHepPdg[idx];
+  for (int k = 0; k < 4; ++k) out.p4_MeV[k] = StdHepP4[idx][k]*1000.0;
+  out.vtx_mm_ns[0] = EvtVtx[0]*1000.0;
+  out.vtx_mm_ns[1] = EvtVtx[1]*1000.0;
+  out.vtx_mm_ns[2] = EvtVtx[2]*1000.0;
+  out.vtx_mm_ns[3] = EvtVtx[3]*1.0e9;
+  return true;
+}
+
+bool RootrackerSource::Claim(RootrackerPrimary& out) {
+  if (!fRunning.load()) {
+    std::lock_guard<std::mutex> lock(fControlMutex);
+    StartLocked();
+  }
+  std::optional<RootrackerPrimary> rec = fQueue->TryPop();
+  if (!rec) {
+    // The producer is behind: sleep until it pushes a record or finishes.
+    std::unique_lock<std::mutex> lock(fWaitMutex);
+    fNotEmpty.wait(lock, [&] {
+      if ((rec = fQueue->TryPop())) return true;
+      if (!fProducerDone.load()) return false;
+      // Producer may have pushed its last record after our pop attempt.
+      rec = fQueue->TryPop();
+      return true;
+    });
+    if (!rec) return false;
+  }
+  { std::lock_guard<std::mutex> lock(fWaitMutex); }
+  fNotFull.notify_one();
+  out = *rec;
+  fClaimed.fetch_add(1);
+  RaiseTo(fNextEntry, out.entry + 1);
+  return true;
+}
+
+void RootrackerSource::Stop() {
+  std::lock_guard<std::mutex> lock(fControlMutex);
+  if (!fRunning.load()) return;
+  {
+    std::lock_guard<std::mutex> lock(fWaitMutex);
+    fStopRequested.store(true);
+  }
+  fNotFull.notify_all();
+  if (fProducer.joinable()) fProducer.join();
+  // Decoded but unclaimed entries go back to the cursor for the next run.
+  bool rewound = false;
+  while (auto rec = fQueue->TryPop()) {
+    if (!rewound) {
+      fNextEntry.store(rec->entry);
+      rewound = true;
+    }
+  }
+  fRunning.store(false);
+  fQueue.reset();
+  fTree = nullptr;
+  fFile.reset();
+}
+
+void RootrackerSource::SetNextEntry(long long entry) {
+  Stop();
+  fNextEntry.store(std::max(0LL, entry));
+}
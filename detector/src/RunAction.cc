@@ -1,6 +1,18 @@
 #include "RunAction.hh"
+#include "BatchOptics.hh"
+#include "LazyCerenkov.hh"
+#include "OpticalRoulette.hh"
+#include "OpticalSubEvent.hh"
+#include "OpticalTimeCut.hh"
+#include "OutputMerge.hh"
+#include "PMTDigitizer.hh"
+#include "PhotonBudget.hh"
 #include "PhotonCountActions.hh"
+#include "PhotonRecords.hh"
+#include "PhysicsTableCache.hh"
 #include "RunManifest.hh"
+#include "RootrackerSource.hh"
+#include "SurfaceHits.hh"
 
 #include <G4Run.hh>
 #include <G4ios.hh>
@@ -8,7 +20,17 @@
 RunAction::RunAction() = default;
 
 void RunAction::BeginOfRunAction(const G4Run*) {
+  // Workers register their own output files; the shared totals and the
+  // manifest echo belong to the master (or the only thread in serial mode).
+  if (!IsMaster()) return;
   PhotonCountEventAction::ResetTotal();
+  OpticalTimeCut::ResetCounters();
+  OpticalRoulette::ResetCounters();
+  BatchOptics::ResetCounters();
+  LazyCerenkov::ResetCounters();
+  PhotonRecords::ResetCounters();
+  SurfaceHits::ResetCounters();
+  PhysicsTableCache::ReportStartup();
   const auto& manifest = GetRunManifest();
   G4cout << "[Manifest] profile=" << manifest.profile
          << " macro=" << manifest.macro
@@ -17,6 +39,15 @@ void RunAction::BeginOfRunAction(const G4Run*) {
          << " git=" << manifest.gitSHA
          << G4endl;
   G4cout << "[Manifest] quiet=" << (manifest.quiet ? "on" : "off")
+         << " threads=" << manifest.threads
+         << " seed=" << manifest.seed
+         << " event_seeding=" << (manifest.eventSeeding ? "on" : "off")
+         << " digi_threads=" << manifest.digiThreads
+         << " qe_prethin=" << (manifest.qePrethin ? "on" : "off")
+         << " photon_weight=" << manifest.photonWeight
+         << " optical_backend=" << manifest.opticalBackend
+         << " pmt_mode=" << manifest.pmtMode
+         << " direct_light=" << (manifest.directLight ? "on" : "off")
          << " opt_verbose=" << manifest.opticalVerboseLevel
          << " summary_every=" << manifest.summaryEvery
          << " digitizer_out=" << (manifest.digitizerOutput.empty() ? "<none>" : manifest.digitizerOutput)
@@ -25,9 +56,34 @@ void RunAction::BeginOfRunAction(const G4Run*) {
 
 void RunAction::EndOfRunAction(const G4Run*) {
   const auto& manifest = GetRunManifest();
-  if (!manifest.quiet && manifest.opticalVerboseLevel > 0) {
+  if (IsMaster() && !manifest.quiet && manifest.opticalVerboseLevel > 0) {
     G4cout << "[Optics] total_optical_photons="
            << PhotonCountEventAction::GetTotal() << G4endl;
   }
+  if (!IsMaster()) {
+    // Worker: release the shard; the master merges after all workers end.
+    if (fDigitizer) fDigitizer->CloseOutput();
+    return;
+  }
+  // Park the prefetcher; unclaimed entries are handed out again next run.
+  if (auto* src = RootrackerSource::Shared()) {
+    src->Stop();
+    if (src->Claimed() > 0) SetManifestEntryRange(src->RangeBegin(), src->NextEntry());
+  }
+  OpticalTimeCut::Report();
+  OpticalRoulette::Report();
+  BatchOptics::Report();
+  LazyCerenkov::Report();
+  PhotonRecords::Report();
+  SurfaceHits::Report();
+  PhysicsTableCache::StoreIfMissing();
+  if (fDigitizer && OpticalSubEvent::Enabled()) {
+    // Events normally complete on the workers; leftovers join their shards.
+    fDigitizer->DigitizeSubEventHits();
+    fDigitizer->CloseOutput();
+  }
+  if (OpticalSubEvent::Enabled()) PhotonBudgetEventAction::WritePendingRows();
+  if (fDigitizer) fDigitizer->FlushOutput(); // manifest write must not race the I/O thread
   FlushManifestToOutputs();
+  OutputMerge::MergePendingShards();
 }
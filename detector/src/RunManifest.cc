@@ -15,7 +15,7 @@ namespace {
 
 RunManifest gManifest;
 bool gManifestSet = false;
-std::vector<TFile*> gRegisteredFiles;
+thread_local std::vector<TFile*> gRegisteredFiles;
 
 std::string JsonEscape(const std::string& in) {
   std::ostringstream os;
@@ -58,6 +58,9 @@ std::string BuildManifestJson(const RunManifest& m) {
 
   appendKV("profile", m.profile);
   appendKV("macro", m.macro);
+  appendKV("geometry_source", m.geometrySource);
+  appendKV("geometry_path", m.geometryPath);
+  appendKV("geometry_contents", m.geometryContents);
   appendKV("optics_path", m.opticsPath);
   appendKV("optics_contents", m.opticsContents);
   appendKV("pmt_path", m.pmtPath);
@@ -72,8 +75,37 @@ std::string BuildManifestJson(const RunManifest& m) {
   appendBool("quiet", m.quiet);
   appendKV("optical_verbose", std::to_string(m.opticalVerboseLevel));
   appendKV("summary_every", std::to_string(m.summaryEvery));
+  appendKV("threads", std::to_string(m.threads));
+  appendKV("seed", std::to_string(m.seed));
+  appendBool("event_seeding", m.eventSeeding);
+  appendKV("subevent_photons", std::to_string(m.subEventPhotons));
+  appendKV("digi_threads", std::to_string(m.digiThreads));
+  appendKV("shard_index", std::to_string(m.shardIndex));
+  appendKV("shard_count", std::to_string(m.shardCount));
+  appendKV("entry_first", std::to_string(m.entryFirst));
+  appendKV("entry_end", std::to_string(m.entryEnd));
   appendKV("qe_scale_override", std::isfinite(m.qeScaleOverride) ? std::to_string(m.qeScaleOverride) : "nan");
   appendKV("qe_flat_override", std::isfinite(m.qeFlatOverride) ? std::to_string(m.qeFlatOverride) : "nan");
+  appendBool("qe_prethin", m.qePrethin);
+  appendKV("photon_keep_probability", std::to_string(m.photonKeepProbability));
+  appendKV("photon_weight", std::to_string(m.photonWeight));
+  appendKV("photon_library", m.photonLibrary);
+  appendKV("lazy_cerenkov_chunk", std::to_string(m.lazyCerenkovChunk));
+  appendKV("segments_out", m.segmentsOut);
+  appendKV("segments_in", m.segmentsIn);
+  appendKV("photon_records", m.photonRecords);
+  appendKV("roulette_reflections", std::to_string(m.rouletteReflections));
+  appendKV("roulette_distance_m", std::to_string(m.rouletteDistanceM));
+  appendKV("roulette_survival", std::to_string(m.rouletteSurvival));
+  appendKV("optical_backend", m.opticalBackend);
+  appendKV("pmt_mode", m.pmtMode);
+  appendKV("pmt_placement", m.pmtPlacement);
+  appendKV("cathode_surface", m.cathodeSurface);
+  appendKV("physics_cache", m.physicsCache);
+  appendBool("physics_tables_retrieved", m.physicsTablesRetrieved);
+  appendBool("direct_light", m.directLight);
+  appendKV("fast_indirect_fraction", std::to_string(m.fastIndirectFraction));
+  appendKV("gate_time_cut_ns", std::isfinite(m.gateTimeCutNs) ? std::to_string(m.gateTimeCutNs) : "nan");
   appendKV("threshold_pe_override", std::isfinite(m.thresholdPEOverride) ? std::to_string(m.thresholdPEOverride) : "nan", true);
   os << "}";
   return os.str();
@@ -86,6 +118,11 @@ void SetRunManifest(RunManifest manifest) {
   gManifestSet = true;
 }
 
+void SetManifestEntryRange(long long first, long long end) {
+  gManifest.entryFirst = first;
+  gManifest.entryEnd = end;
+}
+
 const RunManifest& GetRunManifest() {
   return gManifest;
 }
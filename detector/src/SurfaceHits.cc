@@ -0,0 +1,434 @@
+#include "SurfaceHits.hh"
+
+#include "GeometryRegistry.hh"
+
+#include <G4Box.hh>
+#include <G4LogicalVolume.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4Tubs.hh>
+#include <G4ios.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxCellsPerAxis = 4096;
+constexpr int kMaxSamples = 4096;
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// One wall face and its grid of cells. Box faces and endcaps are planes with
+// (u, v) the two in-plane coordinates; the tubs side is the cylinder with
+// u = phi and v = z.
+struct Face {
+  int axis = 0;         // plane faces: normal axis (0, 1, 2)
+  double sign = 1.0;    // outward direction along `axis`
+  bool cylinder = false;
+  double shell = 0.0;   // discs lie within this distance of the wall
+  double u0 = 0.0, v0 = 0.0, du = 1.0, dv = 1.0;
+  int nu = 1, nv = 1;
+  std::vector<int> start; // cell -> first entry in `slots` (CSR, size nu*nv+1)
+  std::vector<int> slots; // disc slots per cell
+};
+
+// Shared, read-only once Build() returns.
+struct Map {
+  bool tubs = false;
+  double h[3] = {0.0, 0.0, 0.0}; // box half lengths; tubs uses r and h[2]
+  double r = 0.0;
+  G4ThreeVector offset;          // can origin in the world
+  // Disc-free core: box [lo, hi] per axis; tubs radius core[0] and z in [lo[2], hi[2]].
+  double lo[3] = {0.0, 0.0, 0.0};
+  double hi[3] = {0.0, 0.0, 0.0};
+  double coreR = 0.0;
+
+  std::vector<int> id;           // PMT discs (structure of arrays)
+  std::vector<double> px, py, pz, nx, ny, nz;
+  double discR = 0.0;
+  double discR2 = 0.0;
+  double sampleStep = 1.0;       // spacing of the cell lookups along a segment
+  std::vector<Face> faces;       // box: +x -x +y -y +z -z; tubs: side +z -z
+};
+
+bool gEnabled = false;
+bool gReady = false;
+Map gMap;
+
+std::atomic<unsigned long long> gCrossings{0};
+std::atomic<unsigned long long> gTests{0};
+std::atomic<unsigned long long> gHits{0};
+
+double Coord(const G4ThreeVector& p, int axis) { return axis == 0 ? p.x() : axis == 1 ? p.y() : p.z(); }
+
+// Distance of a point inside the can from the face's wall.
+double Inset(const Map& m, const Face& f, const G4ThreeVector& p) {
+  if (f.cylinder) return m.r - std::hypot(p.x(), p.y());
+  return m.h[f.axis] - f.sign * Coord(p, f.axis);
+}
+
+// Face coordinates (u, v) of a point on or near the face.
+void FaceUV(const Face& f, const G4ThreeVector& p, double& u, double& v) {
+  if (f.cylinder) {
+    u = std::atan2(p.y(), p.x());
+    v = p.z();
+  } else {
+    u = Coord(p, (f.axis + 1) % 3);
+    v = Coord(p, (f.axis + 2) % 3);
+  }
+}
+
+int CellIndex(double x, double x0, double dx, int n) {
+  const int i = static_cast<int>(std::floor((x - x0) / dx));
+  return std::clamp(i, 0, n - 1);
+}
+
+// Parameter interval (t0, t1) of a + t d inside the disc-free core; empty
+// (t0 >= t1) if the line misses it.
+void CoreInterval(const Map& m, const G4ThreeVector& a, const G4ThreeVector& d, double& t0, double& t1) {
+  t0 = -kInf;
+  t1 = kInf;
+  auto slab = [&](double p, double dp, double lo, double hi) {
+    if (dp == 0.0) {
+      if (p <= lo || p >= hi) t0 = kInf;
+      return;
+    }
+    const double ta = (lo - p) / dp;
+    const double tb = (hi - p) / dp;
+    t0 = std::max(t0, std::min(ta, tb));
+    t1 = std::min(t1, std::max(ta, tb));
+  };
+  if (m.tubs) {
+    const double qa = d.x() * d.x() + d.y() * d.y();
+    const double qb = a.x() * d.x() + a.y() * d.y();
+    const double qc = a.x() * a.x() + a.y() * a.y() - m.coreR * m.coreR;
+    if (qa == 0.0) {
+      if (qc >= 0.0) t0 = kInf;
+    } else {
+      const double disc = qb * qb - qa * qc;
+      if (disc <= 0.0) {
+        t0 = kInf;
+      } else {
+        const double s = std::sqrt(disc);
+        t0 = (-qb - s) / qa;
+        t1 = (-qb + s) / qa;
+      }
+    }
+    slab(a.z(), d.z(), m.lo[2], m.hi[2]);
+  } else {
+    for (int k = 0; k < 3; ++k) slab(Coord(a, k), Coord(d, k), m.lo[k], m.hi[k]);
+  }
+}
+
+// Calls visit(face, cell) for each new cell the segment a -> a + d (can
+// coordinates, length `len`) passes through within a face's shell. Only the
+// parts of the segment outside the disc-free core can cross a disc: [0, c0]
+// and [c1, 1]; they are looked up every sampleStep.
+template <typename Visit>
+void WalkCells(const Map& m, const G4ThreeVector& a, const G4ThreeVector& d, double len, Visit&& visit) {
+  double c0 = 0.0, c1 = 0.0;
+  CoreInterval(m, a, d, c0, c1);
+  std::pair<double, double> parts[2];
+  int nParts = 0;
+  if (c0 >= c1 || c1 <= 0.0 || c0 >= 1.0) {
+    parts[nParts++] = {0.0, 1.0};
+  } else {
+    if (c0 > 0.0) parts[nParts++] = {0.0, c0};
+    if (c1 < 1.0) parts[nParts++] = {c1, 1.0};
+  }
+
+  int lastCell[6] = {-1, -1, -1, -1, -1, -1};
+  auto lookup = [&](double t) {
+    const G4ThreeVector p = a + t * d;
+    // Near edges a point can be in the shell of more than one face.
+    for (std::size_t f = 0; f < m.faces.size(); ++f) {
+      const Face& face = m.faces[f];
+      if (Inset(m, face, p) > face.shell) continue;
+      double u = 0.0, v = 0.0;
+      FaceUV(face, p, u, v);
+      const int c = CellIndex(u, face.u0, face.du, face.nu) * face.nv + CellIndex(v, face.v0, face.dv, face.nv);
+      if (c == lastCell[f]) continue;
+      lastCell[f] = c;
+      visit(face, c);
+    }
+  };
+  for (int p = 0; p < nParts; ++p) {
+    const auto [t0, t1] = parts[p];
+    const int n = std::clamp(static_cast<int>(std::ceil((t1 - t0) * len / m.sampleStep)), 1, kMaxSamples);
+    for (int i = 0; i <= n; ++i) lookup(t0 + (t1 - t0) * i / n);
+  }
+}
+
+// Candidates(): slots already listed for the current query, by generation.
+struct Seen {
+  std::vector<unsigned> mark;
+  unsigned generation = 0;
+};
+thread_local Seen tSeen;
+
+} // namespace
+
+namespace SurfaceHits {
+
+void Configure() { gEnabled = true; }
+
+bool Enabled() { return gEnabled; }
+
+bool Ready() { return gReady; }
+
+bool Build(const G4LogicalVolume* canLV, const G4ThreeVector& canOffset, double cathodeRadius) {
+  gReady = false;
+  const auto* snap = GeometryRegistry::Instance().Snapshot();
+  if (!snap || !canLV || cathodeRadius <= 0.0) {
+    G4cout << "[WARN] SurfaceHits: need a frozen PMT table and photocathode discs" << G4endl;
+    return false;
+  }
+
+  Map m;
+  if (auto* box = dynamic_cast<const G4Box*>(canLV->GetSolid())) {
+    m.h[0] = box->GetXHalfLength();
+    m.h[1] = box->GetYHalfLength();
+    m.h[2] = box->GetZHalfLength();
+    for (int f = 0; f < 6; ++f) {
+      Face face;
+      face.axis = f / 2;
+      face.sign = (f % 2 == 0) ? 1.0 : -1.0;
+      m.faces.push_back(face);
+    }
+  } else if (auto* tubs = dynamic_cast<const G4Tubs*>(canLV->GetSolid());
+             tubs && tubs->GetInnerRadius() == 0.0 && tubs->GetDeltaPhiAngle() >= twopi) {
+    m.tubs = true;
+    m.r = tubs->GetOuterRadius();
+    m.h[0] = m.h[1] = m.r;
+    m.h[2] = tubs->GetZHalfLength();
+    Face side;
+    side.cylinder = true;
+    m.faces.push_back(side);
+    for (double sign : {1.0, -1.0}) {
+      Face cap;
+      cap.axis = 2;
+      cap.sign = sign;
+      m.faces.push_back(cap);
+    }
+  } else {
+    G4cout << "[WARN] SurfaceHits: water can must be a G4Box or a full G4Tubs" << G4endl;
+    return false;
+  }
+  m.offset = canOffset;
+  m.id = snap->id;
+  m.px = snap->x; m.py = snap->y; m.pz = snap->z;
+  m.nx = snap->nx; m.ny = snap->ny; m.nz = snap->nz;
+  m.discR = cathodeRadius;
+  m.discR2 = cathodeRadius * cathodeRadius;
+
+  // Face of each disc: the wall its normal (into the water) faces away from.
+  // A face's shell is as deep as its deepest disc center plus one radius.
+  const int nPmt = static_cast<int>(m.id.size());
+  std::vector<int> faceOf(nPmt);
+  std::vector<int> count(m.faces.size(), 0);
+  for (int k = 0; k < nPmt; ++k) {
+    const G4ThreeVector p(m.px[k], m.py[k], m.pz[k]);
+    const G4ThreeVector n(m.nx[k], m.ny[k], m.nz[k]);
+    int f = 0;
+    double inset = 0.0;
+    if (m.tubs) {
+      const double radial = std::hypot(n.x(), n.y());
+      f = std::abs(n.z()) > radial ? (n.z() < 0.0 ? 1 : 2) : 0;
+      inset = f == 0 ? m.r - std::hypot(p.x(), p.y()) : m.h[2] - m.faces[f].sign * p.z();
+    } else {
+      int axis = 0;
+      for (int a = 1; a < 3; ++a) {
+        if (std::abs(Coord(n, a)) > std::abs(Coord(n, axis))) axis = a;
+      }
+      f = 2 * axis + (Coord(n, axis) < 0.0 ? 0 : 1);
+      inset = m.h[axis] - m.faces[f].sign * Coord(p, axis);
+    }
+    faceOf[k] = f;
+    m.faces[f].shell = std::max(m.faces[f].shell, std::max(0.0, inset) + m.discR);
+    ++count[f];
+  }
+  if (m.tubs) {
+    m.coreR = std::max(0.0, m.r - m.faces[0].shell);
+    m.hi[2] = m.h[2] - m.faces[1].shell;
+    m.lo[2] = -m.h[2] + m.faces[2].shell;
+  } else {
+    for (int a = 0; a < 3; ++a) {
+      m.hi[a] = m.h[a] - m.faces[2 * a].shell;
+      m.lo[a] = -m.h[a] + m.faces[2 * a + 1].shell;
+    }
+  }
+
+  // Grids: cells of one disc diameter. Segments are looked up every half
+  // radius, so a disc crossed by a segment is within 1.5 radii of a lookup
+  // point; each disc is listed in every cell within two radii of its center.
+  const double cell = 2.0 * m.discR;
+  const double pad = 2.0 * m.discR;
+  m.sampleStep = 0.5 * m.discR;
+  std::size_t nCells = 0;
+  std::size_t maxPerCell = 0;
+  for (std::size_t f = 0; f < m.faces.size(); ++f) {
+    auto& face = m.faces[f];
+    const double rho = std::max(m.r - face.shell, m.discR); // innermost radius of the side shell
+    if (count[f] == 0) {
+      face.nu = face.nv = 1; // no discs: a single empty cell
+    } else if (face.cylinder) {
+      face.nu = std::clamp(static_cast<int>(std::ceil(twopi * rho / cell)), 1, kMaxCellsPerAxis);
+      face.u0 = -pi;
+      face.du = twopi / face.nu;
+      face.nv = std::clamp(static_cast<int>(std::ceil(2.0 * m.h[2] / cell)), 1, kMaxCellsPerAxis);
+      face.v0 = -m.h[2];
+      face.dv = 2.0 * m.h[2] / face.nv;
+    } else {
+      const double hu = m.h[(face.axis + 1) % 3];
+      const double hv = m.h[(face.axis + 2) % 3];
+      face.nu = std::clamp(static_cast<int>(std::ceil(2.0 * hu / cell)), 1, kMaxCellsPerAxis);
+      face.nv = std::clamp(static_cast<int>(std::ceil(2.0 * hv / cell)), 1, kMaxCellsPerAxis);
+      face.u0 = -hu;
+      face.v0 = -hv;
+      face.du = 2.0 * hu / face.nu;
+      face.dv = 2.0 * hv / face.nv;
+    }
+
+    std::vector<std::vector<int>> lists(static_cast<std::size_t>(face.nu) * face.nv);
+    for (int k = 0; k < nPmt; ++k) {
+      if (faceOf[k] != static_cast<int>(f)) continue;
+      double u = 0.0, v = 0.0;
+      FaceUV(face, G4ThreeVector(m.px[k], m.py[k], m.pz[k]), u, v);
+      const double padU = face.cylinder ? pad / rho : pad;
+      const int v1 = CellIndex(v - pad, face.v0, face.dv, face.nv);
+      const int v2 = CellIndex(v + pad, face.v0, face.dv, face.nv);
+      int u1 = 0, u2 = 0;
+      if (face.cylinder) {
+        // phi wraps: walk the raw indices and fold them back.
+        u1 = static_cast<int>(std::floor((u - padU - face.u0) / face.du));
+        u2 = static_cast<int>(std::floor((u + padU - face.u0) / face.du));
+        if (u2 - u1 + 1 >= face.nu) { u1 = 0; u2 = face.nu - 1; }
+      } else {
+        u1 = CellIndex(u - padU, face.u0, face.du, face.nu);
+        u2 = CellIndex(u + padU, face.u0, face.du, face.nu);
+      }
+      for (int iu = u1; iu <= u2; ++iu) {
+        const int cu = ((iu % face.nu) + face.nu) % face.nu;
+        for (int iv = v1; iv <= v2; ++iv) {
+          lists[static_cast<std::size_t>(cu) * face.nv + iv].push_back(k);
+        }
+      }
+    }
+    face.start.assign(lists.size() + 1, 0);
+    for (std::size_t c = 0; c < lists.size(); ++c) {
+      face.start[c + 1] = face.start[c] + static_cast<int>(lists[c].size());
+      face.slots.insert(face.slots.end(), lists[c].begin(), lists[c].end());
+      maxPerCell = std::max(maxPerCell, lists[c].size());
+    }
+    nCells += lists.size();
+  }
+
+  gMap = std::move(m);
+  gReady = true;
+  G4cout << "[SurfaceHits] can=" << (gMap.tubs ? "tubs" : "box") << " pmts=" << nPmt
+         << " faces=" << gMap.faces.size() << " cells=" << nCells
+         << " max_discs_per_cell=" << maxPerCell << G4endl;
+  return true;
+}
+
+int Find(const G4ThreeVector& pre, const G4ThreeVector& post, double& fraction) {
+  if (!gReady) return -1;
+  const auto& m = gMap;
+  const G4ThreeVector a = pre - m.offset;
+  const G4ThreeVector d = post - pre;
+  const double len = d.mag();
+  if (len <= 0.0) return -1;
+  gCrossings.fetch_add(1, std::memory_order_relaxed);
+
+  const G4ThreeVector dir = d / len;
+  double best = len;
+  int bestSlot = -1;
+  unsigned long long tests = 0;
+  WalkCells(m, a, d, len, [&](const Face& face, int c) {
+    for (int i = face.start[c]; i < face.start[c + 1]; ++i) {
+      const int k = face.slots[i];
+      ++tests;
+      const double cosIn = dir.x() * m.nx[k] + dir.y() * m.ny[k] + dir.z() * m.nz[k];
+      if (cosIn == 0.0) continue;
+      const double num = (m.px[k] - a.x()) * m.nx[k] + (m.py[k] - a.y()) * m.ny[k] + (m.pz[k] - a.z()) * m.nz[k];
+      const double s = num / cosIn;
+      if (s < 0.0 || s > best) continue;
+      const double qx = a.x() + s * dir.x() - m.px[k];
+      const double qy = a.y() + s * dir.y() - m.py[k];
+      const double qz = a.z() + s * dir.z() - m.pz[k];
+      if (qx * qx + qy * qy + qz * qz <= m.discR2) {
+        best = s;
+        bestSlot = k;
+      }
+    }
+  });
+
+  gTests.fetch_add(tests, std::memory_order_relaxed);
+  if (bestSlot < 0) return -1;
+  gHits.fetch_add(1, std::memory_order_relaxed);
+  fraction = best / len;
+  return m.id[bestSlot];
+}
+
+void Candidates(const G4ThreeVector& a, const G4ThreeVector& dir, double length, std::vector<int>& slots) {
+  slots.clear();
+  if (!gReady || length <= 0.0) return;
+  const auto& m = gMap;
+  auto& seen = tSeen;
+  if (seen.mark.size() != m.id.size()) {
+    seen.mark.assign(m.id.size(), 0);
+    seen.generation = 0;
+  }
+  if (++seen.generation == 0) { // wrapped: old marks could alias
+    std::fill(seen.mark.begin(), seen.mark.end(), 0);
+    seen.generation = 1;
+  }
+  WalkCells(m, a, length * dir, length, [&](const Face& face, int c) {
+    for (int i = face.start[c]; i < face.start[c + 1]; ++i) {
+      const int k = face.slots[i];
+      if (seen.mark[k] == seen.generation) continue;
+      seen.mark[k] = seen.generation;
+      slots.push_back(k);
+    }
+  });
+}
+
+double ExitDistance(const G4ThreeVector& a, const G4ThreeVector& dir) {
+  if (!gReady) return 0.0;
+  const auto& m = gMap;
+  auto slab = [](double p, double dp, double h) {
+    return dp > 0.0 ? (h - p) / dp : dp < 0.0 ? (-h - p) / dp : kInf;
+  };
+  double t = slab(a.z(), dir.z(), m.h[2]);
+  if (m.tubs) {
+    const double qa = dir.x() * dir.x() + dir.y() * dir.y();
+    const double qb = a.x() * dir.x() + a.y() * dir.y();
+    const double qc = a.x() * a.x() + a.y() * a.y() - m.r * m.r;
+    if (qa > 0.0) t = std::min(t, (-qb + std::sqrt(std::max(0.0, qb * qb - qa * qc))) / qa);
+  } else {
+    t = std::min({t, slab(a.x(), dir.x(), m.h[0]), slab(a.y(), dir.y(), m.h[1])});
+  }
+  return std::max(0.0, t);
+}
+
+void ResetCounters() {
+  gCrossings = 0;
+  gTests = 0;
+  gHits = 0;
+}
+
+void Report() {
+  if (!gEnabled) return;
+  const auto crossings = gCrossings.load();
+  const auto tests = gTests.load();
+  G4cout << "[SurfaceHits] wall_steps=" << crossings << " hits=" << gHits.load()
+         << " discs_tested_per_step=" << std::fixed << std::setprecision(2)
+         << (crossings > 0 ? static_cast<double>(tests) / crossings : 0.0)
+         << std::defaultfloat << G4endl;
+}
+
+} // namespace SurfaceHits
@@ -0,0 +1,123 @@
+#include "TaskPool.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Loop {
+  const std::function<void(std::size_t)>* fn = nullptr;
+  std::size_t n = 0;
+  std::atomic<std::size_t> next{0};
+  std::atomic<std::size_t> done{0};
+  std::mutex mutex; // guards error and the completion wait
+  std::condition_variable finished;
+  std::exception_ptr error;
+};
+
+// Claim iterations until the loop is exhausted.
+void Work(Loop& loop) {
+  for (;;) {
+    const std::size_t i = loop.next.fetch_add(1, std::memory_order_relaxed);
+    if (i >= loop.n) return;
+    try {
+      (*loop.fn)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(loop.mutex);
+      if (!loop.error) loop.error = std::current_exception();
+    }
+    if (loop.done.fetch_add(1, std::memory_order_acq_rel) + 1 == loop.n) {
+      std::lock_guard<std::mutex> lock(loop.mutex);
+      loop.finished.notify_all();
+    }
+  }
+}
+
+class Pool {
+public:
+  explicit Pool(int helpers) {
+    fThreads.reserve(static_cast<std::size_t>(helpers));
+    for (int i = 0; i < helpers; ++i) fThreads.emplace_back(&Pool::Run, this);
+  }
+
+  ~Pool() {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = true;
+    }
+    fWake.notify_all();
+    for (auto& t : fThreads) t.join();
+  }
+
+  std::size_t Helpers() const { return fThreads.size(); }
+
+  // Offer `loop` to up to `helpers` idle threads.
+  void Post(const std::shared_ptr<Loop>& loop, std::size_t helpers) {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      for (std::size_t i = 0; i < helpers; ++i) fPending.push_back(loop);
+    }
+    fWake.notify_all();
+  }
+
+private:
+  void Run() {
+    for (;;) {
+      std::shared_ptr<Loop> loop;
+      {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fWake.wait(lock, [this] { return fStop || !fPending.empty(); });
+        if (fPending.empty()) return;
+        loop = std::move(fPending.front());
+        fPending.pop_front();
+      }
+      Work(*loop);
+    }
+  }
+
+  std::mutex fMutex;
+  std::condition_variable fWake;
+  std::deque<std::shared_ptr<Loop>> fPending;
+  bool fStop = false;
+  std::vector<std::thread> fThreads; // last: started once the queue exists
+};
+
+int gLanes = 1;
+std::unique_ptr<Pool> gPool;
+
+} // namespace
+
+namespace TaskPool {
+
+void Configure(int lanes) {
+  gLanes = std::max(1, lanes);
+  gPool.reset(gLanes > 1 ? new Pool(gLanes - 1) : nullptr);
+}
+
+int Lanes() { return gLanes; }
+
+void ParallelFor(std::size_t n, const std::function<void(std::size_t)>& fn) {
+  if (!gPool || n < 2) {
+    for (std::size_t i = 0; i < n; ++i) fn(i);
+    return;
+  }
+  auto loop = std::make_shared<Loop>();
+  loop->fn = &fn;
+  loop->n = n;
+  gPool->Post(loop, std::min(gPool->Helpers(), n - 1));
+  Work(*loop);
+  {
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->finished.wait(lock, [&] { return loop->done.load(std::memory_order_acquire) == n; });
+  }
+  if (loop->error) std::rethrow_exception(loop->error);
+}
+
+} // namespace TaskPool
@@ -0,0 +1,353 @@
+// flndr_buildlib: build the voxelized photon-detection library used by
+// `flndr --photon_library=<file>`.
+//
+//   G4_GDML=<geometry.gdml> flndr_buildlib --out=<lib.bin> [--voxels=nx,ny,nz]
+//       [--dirs=n_costheta,n_phi] [--lambda=n,min_nm,max_nm] [--photons=N]
+//       [--threads=N] [--optics=<optics.yaml>]
+//
+// The voxel grid spans the bounding box of the water can (G4_CAN_LV, default
+// "Detector"). Each (voxel, direction bin, wavelength bin) cell is one event
+// in which the optical photon gun fires N photons, uniform within the cell
+// and inside the water, with full optical tracking. PMTSD hits give, per PMT,
+// the hit probability and the mean/RMS arrival time.
+
+#include "DetectorConstruction.hh"
+#include "PhotonLibrary.hh"
+#include "PhysicsList.hh"
+#include "PMTHit.hh"
+#include "RunManifest.hh"
+
+#include <G4Event.hh>
+#include <G4HCofThisEvent.hh>
+#include <G4LogicalVolume.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4ParticleGun.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4PhysicalVolumeStore.hh>
+#include <G4RunManager.hh>
+#include <G4RunManagerFactory.hh>
+#include <G4SDManager.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4UserEventAction.hh>
+#include <G4VSolid.hh>
+#include <G4VUserActionInitialization.hh>
+#include <G4VUserPrimaryGeneratorAction.hh>
+#include <G4ios.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct CellTally {
+  std::uint32_t fired = 0;
+  std::vector<PhotonLibrary::Entry> entries;
+};
+
+// Shared between the master (setup, output) and the workers (one cell per
+// event; each cell is written by exactly one event).
+struct BuildState {
+  PhotonLibrary::Header header{};
+  G4ThreeVector canOffset;         // can placement in the world [mm]
+  const G4VSolid* canSolid = nullptr;
+  std::vector<CellTally> cells;
+} gBuild;
+
+struct CellIndex {
+  int voxel[3];
+  int cosTheta, phi, lambda;
+};
+
+CellIndex Decode(std::uint64_t cell) {
+  const auto& h = gBuild.header;
+  CellIndex c{};
+  c.lambda = static_cast<int>(cell % h.nLambda); cell /= h.nLambda;
+  c.phi = static_cast<int>(cell % h.nPhi); cell /= h.nPhi;
+  c.cosTheta = static_cast<int>(cell % h.nCosTheta); cell /= h.nCosTheta;
+  for (int a = 2; a >= 0; --a) {
+    c.voxel[a] = static_cast<int>(cell % h.nVoxel[a]);
+    cell /= h.nVoxel[a];
+  }
+  return c;
+}
+
+class LibraryGun : public G4VUserPrimaryGeneratorAction {
+public:
+  explicit LibraryGun(int photons) : fPhotons(photons), fGun(1) {
+    fGun.SetParticleDefinition(G4OpticalPhoton::OpticalPhotonDefinition());
+    fGun.SetParticleTime(0.0);
+  }
+
+  void GeneratePrimaries(G4Event* event) override {
+    const auto cell = static_cast<std::uint64_t>(event->GetEventID());
+    if (cell >= gBuild.cells.size()) return;
+    const auto& h = gBuild.header;
+    const CellIndex c = Decode(cell);
+    auto edge = [](double lo, double hi, int n, int i) { return lo + (hi - lo) * i / n; };
+
+    std::uint32_t fired = 0;
+    for (int n = 0; n < fPhotons; ++n) {
+      // Uniform in the voxel, rejecting points outside the water.
+      G4ThreeVector pos;
+      bool inside = false;
+      for (int attempt = 0; attempt < 32 && !inside; ++attempt) {
+        double p[3];
+        for (int a = 0; a < 3; ++a) {
+          const double lo = edge(h.lo[a], h.hi[a], h.nVoxel[a], c.voxel[a]);
+          const double hi = edge(h.lo[a], h.hi[a], h.nVoxel[a], c.voxel[a] + 1);
+          p[a] = lo + (hi - lo) * G4UniformRand();
+        }
+        pos = G4ThreeVector(p[0], p[1], p[2]) * mm;
+        inside = gBuild.canSolid->Inside(pos - gBuild.canOffset) == kInside;
+      }
+      if (!inside) continue;
+
+      const double cosTheta = edge(-1.0, 1.0, h.nCosTheta, c.cosTheta) +
+                              (2.0 / h.nCosTheta) * G4UniformRand();
+      const double phi = edge(-CLHEP::pi, CLHEP::pi, h.nPhi, c.phi) +
+                         (CLHEP::twopi / h.nPhi) * G4UniformRand();
+      const double sinTheta = std::sqrt(std::max(0.0, 1.0 - cosTheta * cosTheta));
+      const G4ThreeVector dir(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+      const double lambda_nm = edge(h.lambdaMin, h.lambdaMax, h.nLambda, c.lambda) +
+                               (h.lambdaMax - h.lambdaMin) / h.nLambda * G4UniformRand();
+      // Random linear polarization perpendicular to the direction.
+      const G4ThreeVector perp = dir.orthogonal().unit();
+      const double psi = CLHEP::twopi * G4UniformRand();
+      const G4ThreeVector pol = std::cos(psi) * perp + std::sin(psi) * dir.cross(perp);
+
+      fGun.SetParticlePosition(pos);
+      fGun.SetParticleMomentumDirection(dir);
+      fGun.SetParticlePolarization(pol);
+      fGun.SetParticleEnergy(h_Planck * c_light / (lambda_nm * nm));
+      fGun.GeneratePrimaryVertex(event);
+      ++fired;
+    }
+    gBuild.cells[cell].fired = fired;
+  }
+
+private:
+  int fPhotons;
+  G4ParticleGun fGun;
+};
+
+class LibraryTally : public G4UserEventAction {
+public:
+  void EndOfEventAction(const G4Event* event) override {
+    const auto cell = static_cast<std::uint64_t>(event->GetEventID());
+    if (cell >= gBuild.cells.size()) return;
+    auto& tally = gBuild.cells[cell];
+    if (tally.fired == 0) return;
+
+    auto* hce = event->GetHCofThisEvent();
+    if (!hce) return;
+    if (fHcId < 0) fHcId = G4SDManager::GetSDMpointer()->GetCollectionID("PMTSD/OpticalHits");
+    auto* hits = fHcId >= 0 ? static_cast<PMTHitsCollection*>(hce->GetHC(fHcId)) : nullptr;
+    if (!hits) return;
+
+    struct Sum { double n = 0, t = 0, t2 = 0; };
+    std::map<int, Sum> perPMT; // ordered by PMT, as PhotonLibrary expects
+    for (std::size_t i = 0; i < hits->entries(); ++i) {
+      const PMTHit* hit = (*hits)[i];
+      const double t = hit->time / ns;
+      auto& s = perPMT[hit->pmt_id];
+      s.n += 1.0;
+      s.t += t;
+      s.t2 += t * t;
+    }
+    tally.entries.reserve(perPMT.size());
+    for (const auto& [pmt, s] : perPMT) {
+      const double mean = s.t / s.n;
+      const double var = std::max(0.0, s.t2 / s.n - mean * mean);
+      tally.entries.push_back({pmt, static_cast<float>(s.n / tally.fired),
+                               static_cast<float>(mean), static_cast<float>(std::sqrt(var))});
+    }
+  }
+
+private:
+  int fHcId = -1;
+};
+
+class LibraryActions : public G4VUserActionInitialization {
+public:
+  explicit LibraryActions(int photons) : fPhotons(photons) {}
+  void Build() const override {
+    SetUserAction(new LibraryGun(fPhotons));
+    SetUserAction(new LibraryTally());
+  }
+
+private:
+  int fPhotons;
+};
+
+bool ParseInts(const std::string& value, std::vector<int>& out, std::size_t n) {
+  std::stringstream ss(value);
+  std::string tok;
+  out.clear();
+  while (std::getline(ss, tok, ',')) {
+    try {
+      out.push_back(std::stoi(tok));
+    } catch (...) {
+      return false;
+    }
+  }
+  return out.size() == n && std::all_of(out.begin(), out.end(), [](int v) { return v > 0; });
+}
+
+void Usage(const char* argv0) {
+  G4cout << "Usage: G4_GDML=<geometry.gdml> " << argv0
+         << " --out=<lib.bin> [--voxels=nx,ny,nz] [--dirs=n_costheta,n_phi]"
+         << " [--lambda=n,min_nm,max_nm] [--photons=N] [--threads=N] [--optics=<optics.yaml>]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const char* gdml = std::getenv("G4_GDML");
+  std::string outPath;
+  std::string opticsConfig = "detector/config/optics.yaml";
+  if (const char* envOptics = std::getenv("FLNDR_OPTICS_CONFIG")) {
+    if (*envOptics) opticsConfig = envOptics;
+  }
+  std::vector<int> voxels = {10, 10, 10};
+  std::vector<int> dirs = {8, 8};
+  int nLambda = 4;
+  double lambdaMin = 300.0;
+  double lambdaMax = 600.0;
+  int photons = 1000;
+  int nThreads = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    if (std::strncmp(arg, "--out=", 6) == 0) {
+      outPath = arg + 6;
+    } else if (std::strncmp(arg, "--voxels=", 9) == 0) {
+      if (!ParseInts(arg + 9, voxels, 3)) {
+        G4cout << "[BuildLib] ERROR: --voxels expects nx,ny,nz\n";
+        return 2;
+      }
+    } else if (std::strncmp(arg, "--dirs=", 7) == 0) {
+      if (!ParseInts(arg + 7, dirs, 2)) {
+        G4cout << "[BuildLib] ERROR: --dirs expects n_costheta,n_phi\n";
+        return 2;
+      }
+    } else if (std::strncmp(arg, "--lambda=", 9) == 0) {
+      char comma;
+      std::istringstream iss(arg + 9);
+      if (!(iss >> nLambda >> comma >> lambdaMin >> comma >> lambdaMax) || nLambda <= 0 ||
+          lambdaMax <= lambdaMin) {
+        G4cout << "[BuildLib] ERROR: --lambda expects n,min_nm,max_nm\n";
+        return 2;
+      }
+    } else if (std::strncmp(arg, "--photons=", 10) == 0) {
+      photons = std::max(1, std::atoi(arg + 10));
+    } else if (std::strncmp(arg, "--threads=", 10) == 0) {
+      nThreads = std::max(0, std::atoi(arg + 10));
+    } else if (std::strncmp(arg, "--optics=", 9) == 0) {
+      opticsConfig = arg + 9;
+    } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+      Usage(argv[0]);
+      return 0;
+    } else {
+      G4cout << "[WARN] Unknown option '" << arg << "' ignored.\n";
+    }
+  }
+  if (!gdml || outPath.empty()) {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  RunManifest manifest;
+  manifest.quiet = true;
+  SetRunManifest(std::move(manifest));
+
+  auto* runManager = G4RunManagerFactory::CreateRunManager(
+      nThreads == 1 ? G4RunManagerType::Serial : G4RunManagerType::Tasking);
+  if (nThreads > 1) runManager->SetNumberOfThreads(nThreads);
+  runManager->SetUserInitialization(new DetectorConstruction(gdml, opticsConfig));
+  OpticalProcessConfig optics; // tracking-only: no Cerenkov from the gun photons
+  optics.enableCerenkov = false;
+  runManager->SetUserInitialization(new PhysicsList(optics));
+  runManager->SetUserInitialization(new LibraryActions(photons));
+  runManager->Initialize();
+
+  const char* canName = std::getenv("G4_CAN_LV");
+  const G4String targetCan = canName && *canName ? canName : "Detector";
+  auto* canLV = G4LogicalVolumeStore::GetInstance()->GetVolume(targetCan, /*verbose=*/false);
+  if (!canLV) {
+    G4cout << "[BuildLib] ERROR: water volume '" << targetCan << "' not found\n";
+    return 2;
+  }
+  for (auto* pv : *G4PhysicalVolumeStore::GetInstance()) {
+    if (pv && pv->GetLogicalVolume() == canLV) {
+      gBuild.canOffset = pv->GetTranslation();
+      break;
+    }
+  }
+  gBuild.canSolid = canLV->GetSolid();
+  G4ThreeVector lo, hi;
+  gBuild.canSolid->BoundingLimits(lo, hi);
+  lo += gBuild.canOffset;
+  hi += gBuild.canOffset;
+
+  auto& h = gBuild.header;
+  for (int a = 0; a < 3; ++a) {
+    h.nVoxel[a] = voxels[a];
+    h.lo[a] = lo[a] / mm;
+    h.hi[a] = hi[a] / mm;
+  }
+  h.nCosTheta = dirs[0];
+  h.nPhi = dirs[1];
+  h.nLambda = nLambda;
+  h.lambdaMin = lambdaMin;
+  h.lambdaMax = lambdaMax;
+  h.photonsPerCell = static_cast<std::uint64_t>(photons);
+  h.nCells = static_cast<std::uint64_t>(voxels[0]) * voxels[1] * voxels[2] * dirs[0] * dirs[1] * nLambda;
+  h.nPMT = 0;
+  for (auto* pv : *G4PhysicalVolumeStore::GetInstance()) {
+    if (pv && pv->GetName() == "PMT") h.nPMT += static_cast<std::uint32_t>(pv->GetMultiplicity());
+  }
+  if (h.nCells > static_cast<std::uint64_t>(std::numeric_limits<G4int>::max())) {
+    G4cout << "[BuildLib] ERROR: " << h.nCells << " cells exceed the event-id range\n";
+    return 2;
+  }
+  gBuild.cells.assign(h.nCells, CellTally{});
+
+  G4cout << "[BuildLib] grid=" << voxels[0] << "x" << voxels[1] << "x" << voxels[2]
+         << " over [" << h.lo[0] << "," << h.hi[0] << "]x[" << h.lo[1] << "," << h.hi[1]
+         << "]x[" << h.lo[2] << "," << h.hi[2] << "] mm dirs=" << dirs[0] << "x" << dirs[1]
+         << " lambda=" << nLambda << " bins in [" << lambdaMin << "," << lambdaMax << ") nm"
+         << " cells=" << h.nCells << " photons/cell=" << photons << G4endl;
+  runManager->BeamOn(static_cast<G4int>(h.nCells));
+
+  std::vector<std::uint64_t> offsets;
+  offsets.reserve(h.nCells + 1);
+  std::vector<PhotonLibrary::Entry> entries;
+  offsets.push_back(0);
+  std::uint64_t emptyCells = 0;
+  for (auto& cell : gBuild.cells) {
+    if (cell.fired == 0) ++emptyCells;
+    entries.insert(entries.end(), cell.entries.begin(), cell.entries.end());
+    offsets.push_back(entries.size());
+    std::vector<PhotonLibrary::Entry>().swap(cell.entries);
+  }
+  try {
+    PhotonLibrary::Write(outPath, h, offsets, entries);
+  } catch (const std::exception& ex) {
+    G4cout << "[BuildLib] ERROR: " << ex.what() << "\n";
+    return 2;
+  }
+  G4cout << "[BuildLib] wrote " << outPath << " cells=" << h.nCells
+         << " (outside water: " << emptyCells << ") entries=" << entries.size() << G4endl;
+
+  delete runManager;
+  return 0;
+}
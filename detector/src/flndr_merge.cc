@@ -0,0 +1,322 @@
+// flndr_merge: combine the outputs of `flndr --shard=i/N` batch jobs.
+//
+//   flndr_merge --out=<merged.root> [--csv_out=<merged.csv>] <inputs...>
+//
+// Inputs ending in .root are concatenated per tree (`hits`, `digi_events`,
+// `events`) in entry order; their `run_manifest`s are kept as a JSON array in
+// `run_manifests`. Inputs ending in .csv are PhotonBudget event CSVs and are
+// concatenated under one header. The merge then checks that the shards tile
+// the input tree and that every entry has exactly one event row: in the
+// digitizer's `digi_events` index (hits alone miss events without any), the
+// `events` tree and the CSVs, whichever are present.
+// Exit status: 0 ok, 1 missing/duplicate entries, 2 usage or I/O error.
+
+#include <TChain.h>
+#include <TFile.h>
+#include <TNamed.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ShardInfo {
+  std::string path;
+  std::string manifest;     // raw JSON, empty if absent
+  long long entryFirst = -1;
+  long long entryEnd = -1;
+  int shardIndex = -1;
+  int shardCount = 0;
+};
+
+bool EndsWith(const std::string& s, const char* suffix) {
+  const std::size_t n = std::strlen(suffix);
+  return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+// Manifest values are flat "key":"value" strings (see RunManifest.cc).
+long long ManifestInt(const std::string& json, const std::string& key, long long fallback) {
+  const std::string needle = "\"" + key + "\":\"";
+  const auto pos = json.find(needle);
+  if (pos == std::string::npos) return fallback;
+  try {
+    return std::stoll(json.substr(pos + needle.size()));
+  } catch (...) {
+    return fallback;
+  }
+}
+
+bool ReadShardInfo(const std::string& path, ShardInfo& info) {
+  std::unique_ptr<TFile> f(TFile::Open(path.c_str(), "READ"));
+  if (!f || f->IsZombie()) {
+    std::cerr << "[Merge] ERROR: cannot open " << path << "\n";
+    return false;
+  }
+  info.path = path;
+  if (auto* named = dynamic_cast<TNamed*>(f->Get("run_manifest"))) {
+    info.manifest = named->GetTitle();
+    info.entryFirst = ManifestInt(info.manifest, "entry_first", -1);
+    info.entryEnd   = ManifestInt(info.manifest, "entry_end", -1);
+    info.shardIndex = static_cast<int>(ManifestInt(info.manifest, "shard_index", -1));
+    info.shardCount = static_cast<int>(ManifestInt(info.manifest, "shard_count", 0));
+  } else {
+    std::cerr << "[Merge] WARN: " << path << " has no run_manifest\n";
+  }
+  return true;
+}
+
+// Concatenate tree `name` from every input that has it; returns rows written.
+long long ConcatTree(const std::vector<ShardInfo>& inputs, const char* name, TFile* out,
+                     std::vector<long long>* eventKeys) {
+  TChain chain(name);
+  for (const auto& in : inputs) {
+    std::unique_ptr<TFile> f(TFile::Open(in.path.c_str(), "READ"));
+    if (f && dynamic_cast<TTree*>(f->Get(name))) chain.Add(in.path.c_str());
+  }
+  if (chain.GetNtrees() == 0) return -1;
+  out->cd();
+  TTree* merged = chain.CloneTree(-1);
+  if (!merged) return -1;
+  merged->Write(name, TObject::kOverwrite);
+  const long long rows = merged->GetEntries();
+
+  if (eventKeys && merged->GetBranch("event")) {
+    int event = 0;
+    merged->SetBranchStatus("*", 0);
+    merged->SetBranchStatus("event", 1);
+    merged->SetBranchAddress("event", &event);
+    eventKeys->reserve(eventKeys->size() + static_cast<std::size_t>(rows));
+    for (Long64_t i = 0; i < rows; ++i) {
+      merged->GetEntry(i);
+      eventKeys->push_back(event);
+    }
+    merged->ResetBranchAddresses();
+  }
+  return rows;
+}
+
+// Concatenate PhotonBudget CSVs under the first header; collects the event column.
+bool ConcatCSV(const std::vector<std::string>& inputs, const std::string& outPath,
+               std::vector<long long>& eventKeys) {
+  std::ofstream out;
+  if (!outPath.empty()) {
+    out.open(outPath);
+    if (!out) {
+      std::cerr << "[Merge] ERROR: cannot write " << outPath << "\n";
+      return false;
+    }
+  }
+  std::string header;
+  for (const auto& path : inputs) {
+    std::ifstream in(path);
+    if (!in) {
+      std::cerr << "[Merge] ERROR: cannot open " << path << "\n";
+      return false;
+    }
+    std::string line;
+    if (!std::getline(in, line)) continue;
+    if (header.empty()) {
+      header = line;
+      if (out.is_open()) out << header << "\n";
+    } else if (line != header) {
+      std::cerr << "[Merge] ERROR: CSV header of " << path << " differs from the first input\n";
+      return false;
+    }
+    while (std::getline(in, line)) {
+      if (line.empty()) continue;
+      if (out.is_open()) out << line << "\n";
+      try {
+        eventKeys.push_back(std::stoll(line.substr(0, line.find(','))));
+      } catch (...) {
+        std::cerr << "[Merge] WARN: unparsable event in " << path << ": " << line << "\n";
+      }
+    }
+  }
+  return true;
+}
+
+// Shards must tile [min first, max end) without gaps or overlaps.
+bool CheckRanges(std::vector<ShardInfo> shards) {
+  bool ok = true;
+  shards.erase(std::remove_if(shards.begin(), shards.end(),
+                              [](const ShardInfo& s) { return s.entryFirst < 0 || s.entryEnd < 0; }),
+               shards.end());
+  std::sort(shards.begin(), shards.end(),
+            [](const ShardInfo& a, const ShardInfo& b) { return a.entryFirst < b.entryFirst; });
+  for (std::size_t i = 1; i < shards.size(); ++i) {
+    const auto& prev = shards[i - 1];
+    const auto& cur = shards[i];
+    if (cur.entryFirst > prev.entryEnd) {
+      std::cerr << "[Merge] MISSING: entries [" << prev.entryEnd << ", " << cur.entryFirst
+                << ") between " << prev.path << " and " << cur.path << "\n";
+      ok = false;
+    } else if (cur.entryFirst < prev.entryEnd) {
+      std::cerr << "[Merge] OVERLAP: entries [" << cur.entryFirst << ", " << prev.entryEnd
+                << ") in " << prev.path << " and " << cur.path << "\n";
+      ok = false;
+    }
+  }
+
+  std::map<int, std::set<int>> seenByCount; // shard count -> shard indices
+  for (const auto& s : shards) {
+    if (s.shardCount > 0) seenByCount[s.shardCount].insert(s.shardIndex);
+  }
+  for (const auto& [count, seen] : seenByCount) {
+    for (int i = 0; i < count; ++i) {
+      if (!seen.count(i)) {
+        std::cerr << "[Merge] MISSING: shard " << i << "/" << count << "\n";
+        ok = false;
+      }
+    }
+  }
+  return ok;
+}
+
+// Every entry in the declared ranges must have exactly one event row.
+bool CheckEventKeys(const std::vector<ShardInfo>& shards, std::vector<long long> keys,
+                    const char* what) {
+  std::sort(keys.begin(), keys.end());
+  bool ok = true;
+  std::size_t dupes = 0;
+  for (std::size_t i = 1; i < keys.size(); ++i) {
+    if (keys[i] == keys[i - 1]) {
+      if (dupes++ < 10) std::cerr << "[Merge] DUPLICATE: " << what << " event " << keys[i] << "\n";
+      ok = false;
+    }
+  }
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  std::size_t missing = 0;
+  for (const auto& s : shards) {
+    if (s.entryFirst < 0 || s.entryEnd < 0) continue;
+    for (long long e = s.entryFirst; e < s.entryEnd; ++e) {
+      if (!std::binary_search(keys.begin(), keys.end(), e)) {
+        if (missing++ < 10) std::cerr << "[Merge] MISSING: " << what << " event " << e << " (" << s.path << ")\n";
+        ok = false;
+      }
+    }
+  }
+  if (dupes > 10) std::cerr << "[Merge] ... " << dupes << " duplicate " << what << " events in total\n";
+  if (missing > 10) std::cerr << "[Merge] ... " << missing << " missing " << what << " events in total\n";
+  return ok;
+}
+
+void Usage(const char* argv0) {
+  std::cout << "Usage: " << argv0
+            << " --out=<merged.root> [--csv_out=<merged.csv>] <shard.root|budget.csv>...\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::string outPath;
+  std::string csvOut;
+  std::vector<std::string> rootInputs;
+  std::vector<std::string> csvInputs;
+
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    if (std::strncmp(arg, "--out=", 6) == 0) {
+      outPath = arg + 6;
+    } else if (std::strcmp(arg, "--out") == 0 && i + 1 < argc) {
+      outPath = argv[++i];
+    } else if (std::strncmp(arg, "--csv_out=", 10) == 0) {
+      csvOut = arg + 10;
+    } else if (std::strcmp(arg, "--csv_out") == 0 && i + 1 < argc) {
+      csvOut = argv[++i];
+    } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+      Usage(argv[0]);
+      return 0;
+    } else if (EndsWith(arg, ".root")) {
+      rootInputs.emplace_back(arg);
+    } else if (EndsWith(arg, ".csv")) {
+      csvInputs.emplace_back(arg);
+    } else {
+      std::cerr << "[Merge] WARN: ignoring '" << arg << "'\n";
+    }
+  }
+  if (rootInputs.empty() && csvInputs.empty()) {
+    Usage(argv[0]);
+    return 2;
+  }
+  if (!rootInputs.empty() && outPath.empty()) {
+    std::cerr << "[Merge] ERROR: --out is required for ROOT inputs\n";
+    return 2;
+  }
+
+  std::vector<ShardInfo> shards;
+  for (const auto& path : rootInputs) {
+    ShardInfo info;
+    if (!ReadShardInfo(path, info)) return 2;
+    shards.push_back(std::move(info));
+  }
+  // Entry order, so concatenated trees come out sorted by event key.
+  std::stable_sort(shards.begin(), shards.end(), [](const ShardInfo& a, const ShardInfo& b) {
+    return a.entryFirst < b.entryFirst;
+  });
+
+  bool ok = CheckRanges(shards);
+
+  if (!shards.empty()) {
+    std::unique_ptr<TFile> out(TFile::Open(outPath.c_str(), "RECREATE"));
+    if (!out || out->IsZombie()) {
+      std::cerr << "[Merge] ERROR: cannot create " << outPath << "\n";
+      return 2;
+    }
+    const long long nHits = ConcatTree(shards, "hits", out.get(), nullptr);
+    std::vector<long long> digiKeys;
+    const long long nDigi = ConcatTree(shards, "digi_events", out.get(), &digiKeys);
+    if (nDigi >= 0) ok = CheckEventKeys(shards, digiKeys, "digitizer") && ok;
+    std::vector<long long> treeKeys;
+    const long long nEvents = ConcatTree(shards, "events", out.get(), &treeKeys);
+    if (nEvents >= 0) ok = CheckEventKeys(shards, treeKeys, "events-tree") && ok;
+    if (nHits >= 0 && nDigi < 0 && nEvents < 0 && csvInputs.empty()) {
+      std::cerr << "[Merge] WARN: no digi_events index (older digitizer output); "
+                   "events without hits cannot be checked\n";
+    }
+
+    std::ostringstream all;
+    all << "[";
+    bool first = true;
+    for (const auto& s : shards) {
+      if (s.manifest.empty()) continue;
+      all << (first ? "" : ",") << s.manifest;
+      first = false;
+    }
+    all << "]";
+    out->cd();
+    for (const auto& s : shards) {
+      if (s.manifest.empty()) continue;
+      TNamed("run_manifest", s.manifest.c_str()).Write();
+      break;
+    }
+    TNamed("run_manifests", all.str().c_str()).Write();
+    out->Close();
+    std::cout << "[Merge] " << shards.size() << " files -> " << outPath
+              << " hits=" << std::max(0LL, nHits)
+              << " digi_events=" << std::max(0LL, nDigi)
+              << " events=" << std::max(0LL, nEvents) << "\n";
+  }
+
+  if (!csvInputs.empty()) {
+    std::vector<long long> csvKeys;
+    if (!ConcatCSV(csvInputs, csvOut, csvKeys)) return 2;
+    ok = CheckEventKeys(shards, csvKeys, "csv") && ok;
+    std::cout << "[Merge] " << csvInputs.size() << " CSVs"
+              << (csvOut.empty() ? std::string() : " -> " + csvOut)
+              << " rows=" << csvKeys.size() << "\n";
+  }
+
+  std::cout << "[Merge] " << (ok ? "OK: no missing or duplicate entries" : "FAILED: see messages above")
+            << "\n";
+  return ok ? 0 : 1;
+}
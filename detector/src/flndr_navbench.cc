@@ -0,0 +1,269 @@
+// flndr_navbench: navigation cost of the two PMT wall placement forms.
+//
+//   flndr_navbench --pmts=N [--placement=param|copies] [--rays=M] [--seed=S]
+//       [--pitch_m=P] [--cathode_surface=skin|border]
+//
+// Builds a vacuum world holding a water G4Tubs can, sized (height = diameter)
+// so that TubsWallLayout puts about N photocathode discs on its side at a
+// pitch of P metres (default 0.3). The layout is placed as one
+// G4PVParameterised or as N G4PVPlacements, exactly as DetectorConstruction
+// does. The geometry is closed (voxelized), then M straight rays from random
+// points in the water are walked to the wall with a G4Navigator. No physics
+// and no run manager are involved.
+//
+// The photocathode optical surface is attached with AttachCathodeSurface as
+// in DetectorConstruction (one skin surface, or one border surface per PMT
+// volume). Every boundary the rays cross is then resolved to its optical
+// surface the way G4OpBoundaryProcess does (border table, then skin
+// surfaces), in a separate timed pass over the recorded boundaries.
+//
+// Prints one [NavBench] line: layout/placement and close times, the time to
+// create and list the cathode surfaces, navigator ns per step, surface
+// lookup ns per boundary, disc entries with the sum of their copy numbers
+// and the entries that resolved to the cathode surface (equal for all forms
+// at the same seed), and the peak RSS of the process. Run each configuration
+// in its own process (tools/qc/pmt_placement_bench.sh,
+// tools/qc/photocathode_surface_bench.sh).
+
+#include "PMTLayout.hh"
+
+#include <G4Box.hh>
+#include <G4GeometryManager.hh>
+#include <G4LogicalBorderSurface.hh>
+#include <G4LogicalSkinSurface.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Navigator.hh>
+#include <G4NistManager.hh>
+#include <G4OpticalSurface.hh>
+#include <G4PVPlacement.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4ThreeVector.hh>
+#include <G4TouchableHistory.hh>
+#include <G4Tubs.hh>
+#include <G4ios.hh>
+#include <Randomize.hh>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxStepsPerRay = 64;
+
+double PeakRssMb() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+  return usage.ru_maxrss / 1024.0;            // kilobytes
+#endif
+}
+
+double MsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Surface lookup order of G4OpBoundaryProcess::PostStepDoIt.
+const G4LogicalSurface* ResolveSurface(const G4VPhysicalVolume* pre, const G4VPhysicalVolume* post) {
+  if (auto* border = G4LogicalBorderSurface::GetSurface(pre, post)) return border;
+  const G4LogicalSurface* skin = nullptr;
+  if (post->GetMotherLogical() == pre->GetLogicalVolume()) {
+    skin = G4LogicalSkinSurface::GetSurface(post->GetLogicalVolume());
+    if (!skin) skin = G4LogicalSkinSurface::GetSurface(pre->GetLogicalVolume());
+  } else {
+    skin = G4LogicalSkinSurface::GetSurface(pre->GetLogicalVolume());
+    if (!skin) skin = G4LogicalSkinSurface::GetSurface(post->GetLogicalVolume());
+  }
+  return skin;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  long targetPmts = 2000;
+  long rays = 200000;
+  long seed = 12345;
+  double pitchM = 0.3;
+  std::string placementName = "param";
+  std::string surfaceName = "skin";
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    try {
+      if (std::strncmp(arg, "--pmts=", 7) == 0) {
+        targetPmts = std::stol(arg + 7);
+      } else if (std::strncmp(arg, "--rays=", 7) == 0) {
+        rays = std::stol(arg + 7);
+      } else if (std::strncmp(arg, "--seed=", 7) == 0) {
+        seed = std::stol(arg + 7);
+      } else if (std::strncmp(arg, "--pitch_m=", 10) == 0) {
+        pitchM = std::stod(arg + 10);
+      } else if (std::strncmp(arg, "--placement=", 12) == 0) {
+        placementName = arg + 12;
+      } else if (std::strncmp(arg, "--cathode_surface=", 18) == 0) {
+        surfaceName = arg + 18;
+      } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+        G4cout << "Usage: flndr_navbench --pmts=N [--placement=param|copies] [--rays=M] [--seed=S]"
+               << " [--pitch_m=P] [--cathode_surface=skin|border]\n";
+        return 0;
+      } else {
+        G4cout << "[NavBench] ERROR: unknown option '" << arg << "'\n";
+        return 2;
+      }
+    } catch (const std::exception&) {
+      G4cout << "[NavBench] ERROR: invalid value in '" << arg << "'\n";
+      return 2;
+    }
+  }
+  if (targetPmts <= 0 || rays <= 0 || pitchM <= 0.0 ||
+      (placementName != "param" && placementName != "copies") ||
+      (surfaceName != "skin" && surfaceName != "border")) {
+    G4cout << "[NavBench] ERROR: need --pmts>0, --rays>0, --pitch_m>0, --placement=param|copies,"
+           << " --cathode_surface=skin|border\n";
+    return 2;
+  }
+  const PMTPlacement placement =
+      placementName == "param" ? PMTPlacement::kParameterised : PMTPlacement::kCopies;
+  const CathodeSurface cathMode = surfaceName == "skin" ? CathodeSurface::kSkin : CathodeSurface::kBorder;
+
+  // Same disc as DetectorConstruction.
+  const G4double pmtRadius = 0.10 * m;
+  const G4double pmtThick = 0.8 * mm;
+  const G4double pitch = pitchM * m;
+
+  // Side area 4 pi r^2 holds N discs at one per pitch^2.
+  const G4double rCan = std::max(pitch * std::sqrt(targetPmts / (4.0 * pi)), 4.0 * pmtRadius);
+  const G4double ringRadius = rCan - 5.0 * mm - pmtRadius;
+  const int nPhi = std::max(3, static_cast<int>(std::lround(twopi * ringRadius / pitch)));
+  const int rings = std::max(1, static_cast<int>(std::lround(static_cast<double>(targetPmts) / nPhi)));
+  const G4double zMargin = pmtRadius + 5.0 * cm;
+  const G4double zHalf = zMargin + 0.5 * (rings - 1) * pitch + 1.0 * mm;
+
+  auto* nist = G4NistManager::Instance();
+  auto* vacuum = nist->FindOrBuildMaterial("G4_Galactic");
+  auto* water = nist->FindOrBuildMaterial("G4_WATER");
+  auto* aluminium = nist->FindOrBuildMaterial("G4_Al");
+
+  auto* worldSolid = new G4Box("World", rCan + 1.0 * m, rCan + 1.0 * m, zHalf + 1.0 * m);
+  auto* worldLV = new G4LogicalVolume(worldSolid, vacuum, "World");
+  auto* worldPV = new G4PVPlacement(nullptr, {}, worldLV, "World", nullptr, false, 0, false);
+  auto* canSolid = new G4Tubs("Detector", 0.0, rCan, zHalf, 0.0, twopi);
+  auto* canLV = new G4LogicalVolume(canSolid, water, "Detector");
+  auto* canPV = new G4PVPlacement(nullptr, {}, canLV, "Detector", worldLV, false, 0, false);
+  auto* pmtSol = new G4Tubs("PMT_cathode_tubs", 0., pmtRadius, pmtThick / 2., 0., 360 * deg);
+  auto* pmtLV = new G4LogicalVolume(pmtSol, aluminium, "PMT_cathode_log");
+
+  const auto buildStart = std::chrono::steady_clock::now();
+  auto layout = TubsWallLayout(rCan, zHalf, pmtRadius, pitch, nPhi);
+  std::unique_ptr<G4VPVParameterisation> param;
+  const auto pvs = PlacePMTs(*layout, pmtLV, canLV, placement, param);
+  const double buildMs = MsSince(buildStart);
+
+  // Same surface as DetectorConstruction; creation plus the [SURF_TAB]
+  // listing is the startup cost that scales with the number of surfaces.
+  auto* cathSurface = new G4OpticalSurface("PhotocathodeWaterBoundary");
+  cathSurface->SetType(dielectric_dielectric);
+  cathSurface->SetModel(unified);
+  cathSurface->SetFinish(polished);
+  const auto surfaceStart = std::chrono::steady_clock::now();
+  const std::size_t surfaces = AttachCathodeSurface(pvs, pmtLV, canPV, cathSurface, cathMode);
+  std::ostringstream surfaceTab;
+  if (const auto* table = G4LogicalBorderSurface::GetSurfaceTable()) {
+    for (const auto& kv : *table) {
+      surfaceTab << "[SURF_TAB] " << kv.second->GetName() << " pv1=" << kv.second->GetVolume1()->GetName()
+                 << " pv2=" << kv.second->GetVolume2()->GetName() << '\n';
+    }
+  }
+  if (const auto* skin = G4LogicalSkinSurface::GetSurface(pmtLV)) {
+    surfaceTab << "[SURF_TAB] " << skin->GetName() << " skin=" << pmtLV->GetName() << '\n';
+  }
+  const double surfaceMs = MsSince(surfaceStart);
+
+  const auto closeStart = std::chrono::steady_clock::now();
+  G4GeometryManager::GetInstance()->CloseGeometry(/*optimise=*/true, /*verbose=*/false, worldPV);
+  const double closeMs = MsSince(closeStart);
+
+  G4Random::setTheSeed(seed);
+  G4Navigator nav;
+  nav.SetWorldVolume(worldPV);
+  unsigned long long steps = 0;
+  unsigned long long entries = 0;
+  unsigned long long copySum = 0;
+  std::vector<std::pair<const G4VPhysicalVolume*, const G4VPhysicalVolume*>> boundaries;
+  const G4double rSample = rCan - 1.0 * mm;
+  const auto walkStart = std::chrono::steady_clock::now();
+  for (long r = 0; r < rays; ++r) {
+    const G4double rho = rSample * std::sqrt(G4UniformRand());
+    const G4double phi = twopi * G4UniformRand();
+    G4ThreeVector p(rho * std::cos(phi), rho * std::sin(phi), (2.0 * G4UniformRand() - 1.0) * (zHalf - 1.0 * mm));
+    const G4double cosT = 2.0 * G4UniformRand() - 1.0;
+    const G4double sinT = std::sqrt(std::max(0.0, 1.0 - cosT * cosT));
+    const G4double dirPhi = twopi * G4UniformRand();
+    const G4ThreeVector dir(sinT * std::cos(dirPhi), sinT * std::sin(dirPhi), cosT);
+
+    const G4VPhysicalVolume* prePV =
+        nav.LocateGlobalPointAndSetup(p, &dir, /*relativeSearch=*/false, /*ignoreDirection=*/false);
+    for (int s = 0; s < kMaxStepsPerRay; ++s) {
+      G4double safety = 0.0;
+      const G4double step = nav.ComputeStep(p, dir, kInfinity, safety);
+      if (step == kInfinity) break;
+      p += step * dir;
+      nav.SetGeometricallyLimitedStep();
+      auto* pv = nav.LocateGlobalPointAndSetup(p, &dir, /*relativeSearch=*/true, /*ignoreDirection=*/false);
+      ++steps;
+      if (!pv || pv == worldPV) break; // left the can
+      if (pv != prePV) boundaries.emplace_back(prePV, pv);
+      prePV = pv;
+      if (pv->GetLogicalVolume() == pmtLV) {
+        std::unique_ptr<G4TouchableHistory> touchable(nav.CreateTouchableHistory());
+        ++entries;
+        copySum += static_cast<unsigned long long>(touchable->GetCopyNumber());
+      }
+    }
+  }
+  const double walkMs = MsSince(walkStart);
+
+  // Surface resolution, timed apart from navigation over a few passes.
+  constexpr int kLookupPasses = 5;
+  unsigned long long cathodeResolved = 0;
+  const auto lookupStart = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < kLookupPasses; ++pass) {
+    unsigned long long resolved = 0;
+    for (const auto& [pre, post] : boundaries) {
+      const auto* surface = ResolveSurface(pre, post);
+      if (surface && surface->GetSurfaceProperty() == cathSurface && post->GetLogicalVolume() == pmtLV) {
+        ++resolved;
+      }
+    }
+    cathodeResolved = resolved;
+  }
+  const double lookupMs = MsSince(lookupStart);
+  const double lookupCalls = static_cast<double>(boundaries.size()) * kLookupPasses;
+
+  G4cout << "[NavBench] placement=" << PMTPlacementName(placement)
+         << " pmts=" << layout->Size() << " rings=" << layout->rings << " per_ring=" << layout->perRing
+         << " volumes=" << pvs.size() << " rotations=" << layout->rotations.size()
+         << " cathode_surface=" << CathodeSurfaceName(cathMode) << " surfaces=" << surfaces
+         << " can_r_m=" << rCan / m << " can_halfz_m=" << zHalf / m
+         << " build_ms=" << buildMs << " surface_ms=" << surfaceMs << " close_ms=" << closeMs
+         << " rays=" << rays << " steps=" << steps
+         << " ns_per_step=" << (steps > 0 ? 1e6 * walkMs / steps : 0.0)
+         << " boundaries=" << boundaries.size()
+         << " lookup_ns_per_boundary=" << (lookupCalls > 0 ? 1e6 * lookupMs / lookupCalls : 0.0)
+         << " entries=" << entries << " copy_sum=" << copySum << " cathode_resolved=" << cathodeResolved
+         << " peak_rss_mb=" << PeakRssMb() << G4endl;
+
+  G4GeometryManager::GetInstance()->OpenGeometry(worldPV);
+  return 0;
+}
@@ -1,13 +1,33 @@
 #include "DetectorConstruction.hh"
 #include "ActionInitialization.hh"
+#include "BatchOptics.hh"
+#include "DirectLightModel.hh"
+#include "EventSeeder.hh"
+#include "LazyCerenkov.hh"
+#include "OpticalRoulette.hh"
+#include "OpticalSubEvent.hh"
+#include "OpticalTimeCut.hh"
+#include "OutputMerge.hh"
+#include "PMTDigitizer.hh"
+#include "PMTLayout.hh"
+#include "PhotonLibrary.hh"
+#include "PhotonRecords.hh"
 #include "PhysicsList.hh"
+#include "PhysicsTableCache.hh"
 #include "RunManifest.hh"
+#include "SurfaceHits.hh"
+#include "TaskPool.hh"
 
 #include <G4RunManagerFactory.hh>
 #include <G4SystemOfUnits.hh>
+#include <G4Threading.hh>
 #include <G4UIExecutive.hh>
 #include <G4UImanager.hh>
+#include <G4Version.hh>
 #include <G4VisExecutive.hh>
+#include <Randomize.hh>
+
+#include <TROOT.h>
 
 #include <algorithm>
 #include <cctype>
@@ -18,14 +38,14 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <stdexcept>
 
 int main(int argc, char** argv) {
-  auto* runManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::Default);
-
+  PhysicsTableCache::StartTimer();
   const char* gdml = std::getenv("G4_GDML");
   const char* rtrk = std::getenv("G4_ROOTRACKER");
   const char* zsh  = std::getenv("G4_ZSHIFT_MM");
-  if(!gdml || !rtrk){
+  if(!rtrk){
     G4Exception("main","Env",FatalException,"Set G4_GDML and G4_ROOTRACKER env vars.");
   }
   const double zshift = zsh ? atof(zsh) : 0.0;
@@ -44,6 +64,18 @@ int main(int argc, char** argv) {
     }
   }
 
+  // Native geometry YAML; empty => parse the G4_GDML file.
+  std::string geometryConfig;
+  if (const char* envGeometry = std::getenv("FLNDR_GEOMETRY_CONFIG")) {
+    geometryConfig = envGeometry;
+  }
+
+  // Physics table cache root; empty or "off" => tables built every run.
+  std::string physicsCache;
+  if (const char* envCache = std::getenv("FLNDR_PHYSICS_CACHE")) {
+    physicsCache = envCache;
+  }
+
   std::string macroArg;
   std::string optEnableOverride;
   bool pmtExplicit = false;
@@ -56,12 +88,36 @@ int main(int argc, char** argv) {
   bool quiet = false;
   int optVerbose = 0;
   int summaryEvery = 0;
+  int nThreads = 0; // 0 => Geant4 default (honours G4FORCE_RUN_MANAGER_TYPE / G4FORCE_NUMBEROFTHREADS)
+  unsigned long long runSeed = 0; // 0 => keep the engine's default seed
+  bool eventSeeding = false;
+  int subEventPhotons = 0; // >0 => optical photons tracked in sub-events of this size
+  int digiThreads = 1;     // lanes per digitization loop (1 => inline)
+  int lazyCerenkov = 0;    // >0 => Cerenkov photons generated from recorded segments in chunks of this size
+  std::string segmentsOut; // stage 1: write Cerenkov emitter segments, emit no photons
+  std::string segmentsIn;  // stage 2: replay optics from a stage-1 segment file
+  std::string photonRecordsPath; // per-photon detection records for optics reweighting
+  int shardIndex = -1;
+  int shardCount = 0;
+  long long firstEntry = -1;
+  long long nEntries = -1;
   std::optional<double> digitizerQeFlat;
   std::optional<double> digitizerQeScale;
   std::optional<double> digitizerThreshold;
   bool timingBoundaryOnly = false;
   bool digitizerEnableTTS = true;
   bool digitizerEnableJitter = true;
+  bool qePrethin = false;  // kill optical photons at birth with 1 - peak QE
+  double photonWeight = 1.0; // >1 => keep 1/w of optical photons at weight w
+  bool gateTimeCut = false;  // kill optical photons past the digitizer gate end
+  std::string photonLibraryPath; // non-empty => sample PMT hits from a flndr_buildlib library
+  double gateTimeCutMarginNs = 50.0;
+  int rouletteReflections = 0;    // >0 => roulette every K boundary reflections
+  double rouletteDistanceM = 0.0; // >0 => roulette every X metres of photon path
+  double rouletteSurvival = 0.5;  // survival probability per roulette round
+  std::string opticalBackend = "geant4"; // geant4 | batch (BatchOptics tracer)
+  std::string pmtMode = "volume";        // volume | surface (no PMT volumes; SurfaceHits map)
+  double fastIndirectFraction = 0.0; // day2fast: share of optical photons still tracked for indirect light
   std::string digitizerGateMode = "standard";
   std::optional<double> digitizerGateNsOverride;
 
@@ -76,6 +132,20 @@ int main(int argc, char** argv) {
     }
   };
 
+  auto parseShard = [&](const std::string& value) {
+    const auto slash = value.find('/');
+    try {
+      if (slash == std::string::npos) throw std::invalid_argument(value);
+      const int idx = std::stoi(value.substr(0, slash));
+      const int cnt = std::stoi(value.substr(slash + 1));
+      if (cnt <= 0 || idx < 0 || idx >= cnt) throw std::out_of_range(value);
+      shardIndex = idx;
+      shardCount = cnt;
+    } catch (...) {
+      G4cout << "[WARN] Invalid value for --shard ('" << value << "'); expected i/N with 0<=i<N. Ignoring.\n";
+    }
+  };
+
   auto toLower = [](std::string s) {
     std::transform(s.begin(), s.end(), s.begin(),
                    [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
@@ -97,6 +167,16 @@ int main(int argc, char** argv) {
         G4cout << "[WARN] --optics flag expects a value; using existing value '"
                << opticsConfig << "'\n";
       }
+    } else if (std::strncmp(arg, "--geometry=", 11) == 0) {
+      geometryConfig = std::string(arg + 11);
+    } else if (std::strcmp(arg, "--geometry") == 0) {
+      if (i + 1 < argc) {
+        geometryConfig = std::string(argv[++i]);
+      } else {
+        G4cout << "[WARN] --geometry flag expects a value; ignoring.\n";
+      }
+    } else if (std::strncmp(arg, "--physics_cache=", 16) == 0) {
+      physicsCache = std::string(arg + 16);
     } else if (std::strncmp(arg, "--pmt=", 6) == 0) {
       pmtConfig = std::string(arg + 6);
       pmtExplicit = true;
@@ -155,6 +235,149 @@ int main(int argc, char** argv) {
       } else {
         G4cout << "[WARN] --summary_every flag expects a value; keeping 0.\n";
       }
+    } else if (std::strncmp(arg, "--threads=", 10) == 0) {
+      try {
+        nThreads = std::max(0, std::stoi(arg + 10));
+      } catch (...) {
+        nThreads = 0;
+        G4cout << "[WARN] Invalid value for --threads ('" << (arg + 10) << "'); using default.\n";
+      }
+    } else if (std::strcmp(arg, "--threads") == 0) {
+      if (i + 1 < argc) {
+        try {
+          nThreads = std::max(0, std::stoi(argv[++i]));
+        } catch (...) {
+          nThreads = 0;
+          G4cout << "[WARN] Invalid value for --threads ('" << argv[i] << "'); using default.\n";
+        }
+      } else {
+        G4cout << "[WARN] --threads flag expects a value; using default.\n";
+      }
+    } else if (std::strncmp(arg, "--seed=", 7) == 0) {
+      try {
+        runSeed = std::stoull(arg + 7);
+      } catch (...) {
+        runSeed = 0;
+        G4cout << "[WARN] Invalid value for --seed ('" << (arg + 7) << "'); using engine default.\n";
+      }
+    } else if (std::strcmp(arg, "--seed") == 0) {
+      if (i + 1 < argc) {
+        try {
+          runSeed = std::stoull(argv[++i]);
+        } catch (...) {
+          runSeed = 0;
+          G4cout << "[WARN] Invalid value for --seed ('" << argv[i] << "'); using engine default.\n";
+        }
+      } else {
+        G4cout << "[WARN] --seed flag expects a value; using engine default.\n";
+      }
+    } else if (std::strncmp(arg, "--event_seeding=", 16) == 0) {
+      parseToggle01("--event_seeding", std::string(arg + 16), eventSeeding);
+    } else if (std::strcmp(arg, "--event_seeding") == 0) {
+      if (i + 1 < argc) {
+        parseToggle01("--event_seeding", argv[++i], eventSeeding);
+      } else {
+        G4cout << "[WARN] --event_seeding flag expects 0 or 1; keeping "
+               << (eventSeeding ? "1.\n" : "0.\n");
+      }
+    } else if (std::strncmp(arg, "--subevent_photons=", 19) == 0) {
+      try {
+        subEventPhotons = std::max(0, std::stoi(arg + 19));
+      } catch (...) {
+        subEventPhotons = 0;
+        G4cout << "[WARN] Invalid value for --subevent_photons ('" << (arg + 19) << "'); disabled.\n";
+      }
+    } else if (std::strcmp(arg, "--subevent_photons") == 0) {
+      if (i + 1 < argc) {
+        try {
+          subEventPhotons = std::max(0, std::stoi(argv[++i]));
+        } catch (...) {
+          subEventPhotons = 0;
+          G4cout << "[WARN] Invalid value for --subevent_photons ('" << argv[i] << "'); disabled.\n";
+        }
+      } else {
+        G4cout << "[WARN] --subevent_photons flag expects a value; disabled.\n";
+      }
+    } else if (std::strncmp(arg, "--lazy_cerenkov=", 16) == 0) {
+      try {
+        lazyCerenkov = std::max(0, std::stoi(arg + 16));
+      } catch (...) {
+        lazyCerenkov = 0;
+        G4cout << "[WARN] Invalid value for --lazy_cerenkov ('" << (arg + 16) << "'); disabled.\n";
+      }
+    } else if (std::strcmp(arg, "--lazy_cerenkov") == 0) {
+      if (i + 1 < argc) {
+        try {
+          lazyCerenkov = std::max(0, std::stoi(argv[++i]));
+        } catch (...) {
+          lazyCerenkov = 0;
+          G4cout << "[WARN] Invalid value for --lazy_cerenkov ('" << argv[i] << "'); disabled.\n";
+        }
+      } else {
+        G4cout << "[WARN] --lazy_cerenkov flag expects a value; disabled.\n";
+      }
+    } else if (std::strncmp(arg, "--digi_threads=", 15) == 0) {
+      try {
+        digiThreads = std::max(1, std::stoi(arg + 15));
+      } catch (...) {
+        digiThreads = 1;
+        G4cout << "[WARN] Invalid value for --digi_threads ('" << (arg + 15) << "'); using 1.\n";
+      }
+    } else if (std::strcmp(arg, "--digi_threads") == 0) {
+      if (i + 1 < argc) {
+        try {
+          digiThreads = std::max(1, std::stoi(argv[++i]));
+        } catch (...) {
+          digiThreads = 1;
+          G4cout << "[WARN] Invalid value for --digi_threads ('" << argv[i] << "'); using 1.\n";
+        }
+      } else {
+        G4cout << "[WARN] --digi_threads flag expects a value; using 1.\n";
+      }
+    } else if (std::strncmp(arg, "--shard=", 8) == 0) {
+      parseShard(arg + 8);
+    } else if (std::strcmp(arg, "--shard") == 0) {
+      if (i + 1 < argc) {
+        parseShard(argv[++i]);
+      } else {
+        G4cout << "[WARN] --shard flag expects i/N; ignoring.\n";
+      }
+    } else if (std::strncmp(arg, "--first_entry=", 14) == 0) {
+      try {
+        firstEntry = std::max(0LL, std::stoll(arg + 14));
+      } catch (...) {
+        firstEntry = -1;
+        G4cout << "[WARN] Invalid value for --first_entry ('" << (arg + 14) << "'); ignoring.\n";
+      }
+    } else if (std::strcmp(arg, "--first_entry") == 0) {
+      if (i + 1 < argc) {
+        try {
+          firstEntry = std::max(0LL, std::stoll(argv[++i]));
+        } catch (...) {
+          firstEntry = -1;
+          G4cout << "[WARN] Invalid value for --first_entry ('" << argv[i] << "'); ignoring.\n";
+        }
+      } else {
+        G4cout << "[WARN] --first_entry flag expects a value; ignoring.\n";
+      }
+    } else if (std::strncmp(arg, "--n_entries=", 12) == 0) {
+      try {
+        nEntries = std::max(0LL, std::stoll(arg + 12));
+      } catch (...) {
+        nEntries = -1;
+        G4cout << "[WARN] Invalid value for --n_entries ('" << (arg + 12) << "'); ignoring.\n";
+      }
+    } else if (std::strcmp(arg, "--n_entries") == 0) {
+      if (i + 1 < argc) {
+        try {
+          nEntries = std::max(0LL, std::stoll(argv[++i]));
+        } catch (...) {
+          nEntries = -1;
+          G4cout << "[WARN] Invalid value for --n_entries ('" << argv[i] << "'); ignoring.\n";
+        }
+      } else {
+        G4cout << "[WARN] --n_entries flag expects a value; ignoring.\n";
+      }
     } else if (std::strcmp(arg, "--timing_opt_boundary_only") == 0) {
       timingBoundaryOnly = true;
     } else if (std::strncmp(arg, "--qe_override=", 15) == 0) {
@@ -259,6 +482,186 @@ int main(int argc, char** argv) {
         G4cout << "[WARN] --enable_jitter flag expects 0 or 1; keeping "
                << (digitizerEnableJitter ? "1.\n" : "0.\n");
       }
+    } else if (std::strncmp(arg, "--photon_weight=", 16) == 0) {
+      try {
+        photonWeight = std::max(1.0, std::stod(arg + 16));
+      } catch (...) {
+        photonWeight = 1.0;
+        G4cout << "[WARN] Invalid value for --photon_weight ('" << (arg + 16) << "'); using 1.\n";
+      }
+    } else if (std::strcmp(arg, "--photon_weight") == 0) {
+      if (i + 1 < argc) {
+        try {
+          photonWeight = std::max(1.0, std::stod(argv[++i]));
+        } catch (...) {
+          photonWeight = 1.0;
+          G4cout << "[WARN] Invalid value for --photon_weight ('" << argv[i] << "'); using 1.\n";
+        }
+      } else {
+        G4cout << "[WARN] --photon_weight flag expects a value; using 1.\n";
+      }
+    } else if (std::strncmp(arg, "--qe_prethin=", 13) == 0) {
+      parseToggle01("--qe_prethin", std::string(arg + 13), qePrethin);
+    } else if (std::strcmp(arg, "--qe_prethin") == 0) {
+      if (i + 1 < argc) {
+        parseToggle01("--qe_prethin", argv[++i], qePrethin);
+      } else {
+        G4cout << "[WARN] --qe_prethin flag expects 0 or 1; keeping "
+               << (qePrethin ? "1.\n" : "0.\n");
+      }
+    } else if (std::strncmp(arg, "--photon_library=", 17) == 0) {
+      photonLibraryPath = arg + 17;
+    } else if (std::strcmp(arg, "--photon_library") == 0) {
+      if (i + 1 < argc) {
+        photonLibraryPath = argv[++i];
+      } else {
+        G4cout << "[WARN] --photon_library flag expects a path; ignoring.\n";
+      }
+    } else if (std::strncmp(arg, "--photon_records=", 17) == 0) {
+      photonRecordsPath = arg + 17;
+    } else if (std::strcmp(arg, "--photon_records") == 0) {
+      if (i + 1 < argc) {
+        photonRecordsPath = argv[++i];
+      } else {
+        G4cout << "[WARN] --photon_records flag expects a path; ignoring.\n";
+      }
+    } else if (std::strncmp(arg, "--segments_out=", 15) == 0) {
+      segmentsOut = arg + 15;
+    } else if (std::strcmp(arg, "--segments_out") == 0) {
+      if (i + 1 < argc) {
+        segmentsOut = argv[++i];
+      } else {
+        G4cout << "[WARN] --segments_out flag expects a path; ignoring.\n";
+      }
+    } else if (std::strncmp(arg, "--segments_in=", 14) == 0) {
+      segmentsIn = arg + 14;
+    } else if (std::strcmp(arg, "--segments_in") == 0) {
+      if (i + 1 < argc) {
+        segmentsIn = argv[++i];
+      } else {
+        G4cout << "[WARN] --segments_in flag expects a path; ignoring.\n";
+      }
+    } else if (std::strncmp(arg, "--optical_backend=", 18) == 0) {
+      opticalBackend = toLower(arg + 18);
+    } else if (std::strcmp(arg, "--optical_backend") == 0) {
+      if (i + 1 < argc) {
+        opticalBackend = toLower(argv[++i]);
+      } else {
+        G4cout << "[WARN] --optical_backend flag expects geant4 or batch; keeping "
+               << opticalBackend << ".\n";
+      }
+    } else if (std::strncmp(arg, "--pmt_mode=", 11) == 0) {
+      pmtMode = toLower(arg + 11);
+    } else if (std::strcmp(arg, "--pmt_mode") == 0) {
+      if (i + 1 < argc) {
+        pmtMode = toLower(argv[++i]);
+      } else {
+        G4cout << "[WARN] --pmt_mode flag expects volume or surface; keeping " << pmtMode << ".\n";
+      }
+    } else if (std::strncmp(arg, "--fast_indirect_fraction=", 25) == 0) {
+      try {
+        fastIndirectFraction = std::clamp(std::stod(arg + 25), 0.0, 1.0);
+      } catch (...) {
+        G4cout << "[WARN] Invalid value for --fast_indirect_fraction ('" << (arg + 25) << "'); keeping "
+               << fastIndirectFraction << ".\n";
+      }
+    } else if (std::strcmp(arg, "--fast_indirect_fraction") == 0) {
+      if (i + 1 < argc) {
+        try {
+          fastIndirectFraction = std::clamp(std::stod(argv[++i]), 0.0, 1.0);
+        } catch (...) {
+          G4cout << "[WARN] Invalid value for --fast_indirect_fraction ('" << argv[i] << "'); keeping "
+                 << fastIndirectFraction << ".\n";
+        }
+      } else {
+        G4cout << "[WARN] --fast_indirect_fraction flag expects a value; keeping "
+               << fastIndirectFraction << ".\n";
+      }
+    } else if (std::strncmp(arg, "--roulette_reflections=", 23) == 0) {
+      try {
+        rouletteReflections = std::max(0, std::stoi(arg + 23));
+      } catch (...) {
+        G4cout << "[WARN] Invalid value for --roulette_reflections ('" << (arg + 23) << "'); keeping "
+               << rouletteReflections << ".\n";
+      }
+    } else if (std::strcmp(arg, "--roulette_reflections") == 0) {
+      if (i + 1 < argc) {
+        try {
+          rouletteReflections = std::max(0, std::stoi(argv[++i]));
+        } catch (...) {
+          G4cout << "[WARN] Invalid value for --roulette_reflections ('" << argv[i] << "'); keeping "
+                 << rouletteReflections << ".\n";
+        }
+      } else {
+        G4cout << "[WARN] --roulette_reflections flag expects a value; keeping "
+               << rouletteReflections << ".\n";
+      }
+    } else if (std::strncmp(arg, "--roulette_distance_m=", 22) == 0) {
+      try {
+        rouletteDistanceM = std::max(0.0, std::stod(arg + 22));
+      } catch (...) {
+        G4cout << "[WARN] Invalid value for --roulette_distance_m ('" << (arg + 22) << "'); keeping "
+               << rouletteDistanceM << ".\n";
+      }
+    } else if (std::strcmp(arg, "--roulette_distance_m") == 0) {
+      if (i + 1 < argc) {
+        try {
+          rouletteDistanceM = std::max(0.0, std::stod(argv[++i]));
+        } catch (...) {
+          G4cout << "[WARN] Invalid value for --roulette_distance_m ('" << argv[i] << "'); keeping "
+                 << rouletteDistanceM << ".\n";
+        }
+      } else {
+        G4cout << "[WARN] --roulette_distance_m flag expects a value; keeping "
+               << rouletteDistanceM << ".\n";
+      }
+    } else if (std::strncmp(arg, "--roulette_survival=", 20) == 0) {
+      try {
+        rouletteSurvival = std::clamp(std::stod(arg + 20), 0.0, 1.0);
+      } catch (...) {
+        G4cout << "[WARN] Invalid value for --roulette_survival ('" << (arg + 20) << "'); keeping "
+               << rouletteSurvival << ".\n";
+      }
+    } else if (std::strcmp(arg, "--roulette_survival") == 0) {
+      if (i + 1 < argc) {
+        try {
+          rouletteSurvival = std::clamp(std::stod(argv[++i]), 0.0, 1.0);
+        } catch (...) {
+          G4cout << "[WARN] Invalid value for --roulette_survival ('" << argv[i] << "'); keeping "
+                 << rouletteSurvival << ".\n";
+        }
+      } else {
+        G4cout << "[WARN] --roulette_survival flag expects a value; keeping "
+               << rouletteSurvival << ".\n";
+      }
+    } else if (std::strncmp(arg, "--gate_time_cut=", 16) == 0) {
+      parseToggle01("--gate_time_cut", std::string(arg + 16), gateTimeCut);
+    } else if (std::strcmp(arg, "--gate_time_cut") == 0) {
+      if (i + 1 < argc) {
+        parseToggle01("--gate_time_cut", argv[++i], gateTimeCut);
+      } else {
+        G4cout << "[WARN] --gate_time_cut flag expects 0 or 1; keeping "
+               << (gateTimeCut ? "1.\n" : "0.\n");
+      }
+    } else if (std::strncmp(arg, "--gate_time_cut_margin_ns=", 26) == 0) {
+      try {
+        gateTimeCutMarginNs = std::max(0.0, std::stod(arg + 26));
+      } catch (...) {
+        G4cout << "[WARN] Invalid value for --gate_time_cut_margin_ns ('" << (arg + 26) << "'); keeping "
+               << gateTimeCutMarginNs << ".\n";
+      }
+    } else if (std::strcmp(arg, "--gate_time_cut_margin_ns") == 0) {
+      if (i + 1 < argc) {
+        try {
+          gateTimeCutMarginNs = std::max(0.0, std::stod(argv[++i]));
+        } catch (...) {
+          G4cout << "[WARN] Invalid value for --gate_time_cut_margin_ns ('" << argv[i] << "'); keeping "
+                 << gateTimeCutMarginNs << ".\n";
+        }
+      } else {
+        G4cout << "[WARN] --gate_time_cut_margin_ns flag expects a value; keeping "
+               << gateTimeCutMarginNs << ".\n";
+      }
     } else if (std::strncmp(arg, "--gate_mode=", 12) == 0) {
       digitizerGateMode = toLower(std::string(arg + 12));
     } else if (std::strcmp(arg, "--gate_mode") == 0) {
@@ -305,14 +708,39 @@ int main(int argc, char** argv) {
       }
     } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
       G4cout << "Usage: " << argv[0]
-             << " [--profile=<name>] [--optics=<cfg.yaml>] [--pmt=<cfg.yaml>] [--opt_enable=list]"
+             << " [--profile=<name>] [--geometry=<cfg.yaml>] [--optics=<cfg.yaml>] [--pmt=<cfg.yaml>] [--opt_enable=list]"
              << " [--opt_dbg] [--quiet] [--opt_verbose=<0..2>] [--summary_every=<int>]"
-             << " [--qe_flat=<float>] [--qe_scale=<float>] [--threshold_pe=<float>] [--enable_tts=0|1] [--enable_jitter=0|1]"
-             << " [--gate_mode=<standard|centered|off>] [--gate_ns_override=<float>] [--timing_opt_boundary_only]"
-             << " [--check_overlaps_n=<int>] [macro.mac]\n"
-             << "Profiles: day1 (default), day2, day3, custom\n"
+             << " [--qe_flat=<float>] [--qe_scale=<float>] [--qe_prethin=0|1] [--photon_weight=<w>] [--threshold_pe=<float>] [--enable_tts=0|1] [--enable_jitter=0|1]"
+             << " [--gate_mode=<standard|centered|off>] [--gate_ns_override=<float>] [--gate_time_cut=0|1] [--gate_time_cut_margin_ns=<float>] [--photon_library=<lib.bin>] [--fast_indirect_fraction=<f>] [--optical_backend=geant4|batch] [--pmt_mode=volume|surface] [--timing_opt_boundary_only]"
+             << " [--check_overlaps_n=<int>] [--physics_cache=<dir>|off] [--threads=<N>] [--seed=<N>] [--event_seeding=0|1]"
+             << " [--subevent_photons=<N>] [--lazy_cerenkov=<N>] [--segments_out=<file>] [--segments_in=<file>] [--photon_records=<file.csv>] [--roulette_reflections=<K>] [--roulette_distance_m=<X>] [--roulette_survival=<p>] [--digi_threads=<N>] [--shard=<i>/<N>] [--first_entry=<K>] [--n_entries=<M>] [macro.mac]\n"
+             << "Profiles: day1 (default), day2, day2fast, day3, custom\n"
+             << "Geometry: G4_GDML by default; --geometry=<cfg.yaml> (or FLNDR_GEOMETRY_CONFIG) builds the world, can and PMT wall"
+             << " natively from YAML (see detector/config/geometry.yaml)\n"
              << "Optics: defaults to detector/config/optics.yaml\n"
              << "PMT: defaults to detector/config/pmt.yaml (day2)\n"
+             << "Physics cache: --physics_cache=<dir> (or FLNDR_PHYSICS_CACHE) stores the physics tables after the first run"
+             << " and retrieves them in later runs with the same physics list, cuts, optics and geometry\n"
+             << "Threads: 1 forces serial; N>1 uses G4TaskRunManager with N workers\n"
+             << "Sub-events: --subevent_photons=N tracks optical photons in batches of N on idle workers (MT, Geant4>=11.2)\n"
+             << "Lazy Cerenkov: --lazy_cerenkov=N records charged steps as emitter segments and generates their photons N at a time once the shower is done\n"
+             << "Two-stage optics: --segments_out=<file> writes the emitter segments and skips optics;"
+             << " --segments_in=<file> replays only the optics from them (any optics YAML or process list)\n"
+             << "Optics reweighting: --photon_records=<file.csv> writes path length, wavelength and scatter counts"
+             << " of every detected photon for tools/qc/optics_reweight.py\n"
+             << "Roulette: --roulette_reflections=K and/or --roulette_distance_m=X play Russian roulette with"
+             << " survival --roulette_survival=p (default 0.5) every K reflections / X metres; survivors get weight /p\n"
+             << "QE pre-thinning: --qe_prethin=1 kills optical photons at birth with 1 - qe_scale*max(QE); the digitizer applies QE(lambda)/max(QE)\n"
+             << "Photon weights: --photon_weight=w tracks 1/w of optical photons at weight w; PE and budget counters sum weights\n"
+             << "Time cut: --gate_time_cut=1 kills optical photons once t - t0 > gate_offset_ns + gate_ns + margin (default 50 ns)\n"
+             << "Fast optics: --photon_library=<lib.bin> samples PMT hits from a flndr_buildlib library instead of tracking photons\n"
+             << "Direct light: --profile=day2fast scores unscattered light analytically (clear water by default);"
+             << " --fast_indirect_fraction=f still tracks a fraction f of photons at weight 1/f for scattered light\n"
+             << "Optical backend: --optical_backend=batch traces optical photons in batches at end of event (box/tubs cans)\n"
+             << "PMT mode: --pmt_mode=surface places no PMT volumes; wall crossings are mapped to photocathode discs analytically\n"
+             << "Digitization: --digi_threads=N splits very large hit collections by PMT over N lanes; output does not depend on N\n"
+             << "Sharding: --shard=i/N simulates slice i of N of the G4_ROOTRACKER tree; outputs get a .shard<i> tag\n"
+             << "Seeding: --event_seeding=1 reseeds every event from (seed, rootracker entry | gun event id)\n"
              << "Optical processes list accepts comma-separated names: "
              << "cerenkov, abs, rayleigh, mie, boundary\n";
       return 0;
@@ -323,21 +751,129 @@ int main(int argc, char** argv) {
     }
   }
 
+  if (opticalBackend != "geant4" && opticalBackend != "batch") {
+    G4cout << "[WARN] Invalid value for --optical_backend ('" << opticalBackend << "'); using geant4.\n";
+    opticalBackend = "geant4";
+  }
+  if (opticalBackend == "batch" && !photonLibraryPath.empty()) {
+    G4cout << "[WARN] --photon_library replaces optical tracking; --optical_backend=batch ignored.\n";
+    opticalBackend = "geant4";
+  }
+  if (opticalBackend == "batch") {
+    BatchOptics::Configure();
+    G4cout << "[CFG] Optical backend: batch (optical photons traced per event outside Geant4)" << G4endl;
+    if (subEventPhotons > 0) {
+      G4cout << "[WARN] --subevent_photons has no effect with --optical_backend=batch.\n";
+      subEventPhotons = 0;
+    }
+    if (gateTimeCut) {
+      G4cout << "[WARN] --gate_time_cut has no effect with --optical_backend=batch.\n";
+      gateTimeCut = false;
+    }
+  }
+
+  if (pmtMode != "volume" && pmtMode != "surface") {
+    G4cout << "[WARN] Invalid value for --pmt_mode ('" << pmtMode << "'); using volume.\n";
+    pmtMode = "volume";
+  }
+  if (pmtMode == "surface") {
+    SurfaceHits::Configure();
+    G4cout << "[CFG] PMT mode: surface (no PMT volumes; wall crossings mapped to photocathodes)" << G4endl;
+  }
+
+  if (subEventPhotons > 0 && nThreads == 1) {
+    G4cout << "[WARN] --subevent_photons needs worker threads; ignored with --threads=1.\n";
+    subEventPhotons = 0;
+  }
+  OpticalSubEvent::Configure(subEventPhotons);
+  if (subEventPhotons > 0 && !OpticalSubEvent::Supported()) {
+    G4cout << "[WARN] --subevent_photons needs Geant4 >= 11.2; ignored.\n";
+    subEventPhotons = 0;
+  }
+
+  TaskPool::Configure(digiThreads);
+  if (digiThreads > 1) {
+    G4cout << "[CFG] Per-PMT digitization: " << digiThreads << " lanes for large hit collections" << G4endl;
+  }
+
+  G4RunManagerType runManagerType = G4RunManagerType::Default;
+  if (nThreads == 1) {
+    runManagerType = G4RunManagerType::Serial;
+  } else if (nThreads > 1) {
+    runManagerType = G4RunManagerType::Tasking;
+  }
+#if G4VERSION_NUMBER >= 1120
+  if (OpticalSubEvent::Enabled()) {
+    runManagerType = G4RunManagerType::SubEvt;
+  }
+#endif
+  auto* runManager = G4RunManagerFactory::CreateRunManager(runManagerType);
+  if (nThreads > 1) {
+    runManager->SetNumberOfThreads(nThreads);
+  }
+#if G4VERSION_NUMBER >= 1120
+  if (OpticalSubEvent::Enabled()) {
+    runManager->RegisterSubEventType(OpticalSubEvent::kType, subEventPhotons);
+    G4cout << "[CFG] Sub-event optical tracking: " << subEventPhotons << " photons per sub-event" << G4endl;
+  }
+#endif
+  const int effectiveThreads = G4Threading::IsMultithreadedApplication()
+                                 ? std::max(1, runManager->GetNumberOfThreads())
+                                 : 1;
+  // The Rootracker prefetch thread reads ROOT alongside the event loop even in
+  // serial mode, and MT workers write their own TFiles concurrently.
+  ROOT::EnableThreadSafety();
+  G4cout << "[CFG] Threads: " << effectiveThreads
+         << (G4Threading::IsMultithreadedApplication() ? " (MT)" : " (serial)") << G4endl;
+
+  if (runSeed != 0) {
+    // Master engine; in MT it also drives the per-event seeds handed to workers.
+    G4Random::setTheSeed(static_cast<long>(runSeed & 0x7fffffffULL));
+  }
+  EventSeeder::Configure(runSeed, eventSeeding);
+  G4cout << "[CFG] Seed: " << runSeed
+         << " event_seeding=" << (eventSeeding ? "on (Philox per entry)" : "off") << G4endl;
+
   const std::string profileNorm = toLower(profile);
-  const bool isDay2Profile = (profileNorm == "day2");
+  const bool isDay2FastProfile = (profileNorm == "day2fast");
+  const bool isDay2Profile = (profileNorm == "day2" || isDay2FastProfile);
   const bool isDay3Profile = (profileNorm == "day3");
 
   G4cout << "[CFG] Profile: " << profile << G4endl;
 
   if (isDay2Profile && !opticsExplicit) {
-    opticsConfig = "detector/config/optics.yaml";
+    opticsConfig = isDay2FastProfile ? "detector/config/optics_clear.yaml" : "detector/config/optics.yaml";
   }
 
+  // day2fast: configure before the detector and physics list are built.
+  bool directLight = isDay2FastProfile;
+  if (directLight && !photonLibraryPath.empty()) {
+    G4cout << "[WARN] --photon_library replaces optical tracking; day2fast direct light disabled.\n";
+    directLight = false;
+  }
+  if (directLight && BatchOptics::Enabled()) {
+    G4cout << "[WARN] --optical_backend=batch traces all optical light; day2fast direct light disabled.\n";
+    directLight = false;
+  }
+  if (directLight) {
+    DirectLight::Configure(fastIndirectFraction);
+    G4cout << "[CFG] Direct light: analytic PMT hits for unscattered photons; indirect fraction="
+           << DirectLight::IndirectFraction() << G4endl;
+  } else if (fastIndirectFraction > 0.0) {
+    G4cout << "[WARN] --fast_indirect_fraction only applies to --profile=day2fast; ignored.\n";
+  }
+
+  if (geometryConfig.empty() && !gdml) {
+    G4Exception("main","Env",FatalException,"Set G4_GDML and G4_ROOTRACKER env vars.");
+  }
+  G4cout << "[CFG] Geometry: " << (geometryConfig.empty() ? "gdml " + std::string(gdml) : "native " + geometryConfig)
+         << G4endl;
   G4cout << "[CFG] Optics config: " << opticsConfig << G4endl;
   G4cout << "[CFG] Quiet=" << (quiet ? "on" : "off")
          << " opt_verbose=" << optVerbose
          << " summary_every=" << summaryEvery << G4endl;
-  runManager->SetUserInitialization(new DetectorConstruction(gdml, opticsConfig, checkOverlapsN, qeOverride, qeFlat));
+  runManager->SetUserInitialization(new DetectorConstruction(gdml ? gdml : "", opticsConfig, checkOverlapsN, qeOverride, qeFlat,
+                                                            geometryConfig));
 
   auto makeDefaultOptConfig = [](const std::string& prof) {
     OpticalProcessConfig cfg;
@@ -348,7 +884,7 @@ int main(int argc, char** argv) {
     cfg.enableMie = false;
     cfg.maxPhotonsPerStep = 50;
     cfg.maxBetaChangePerStep = 10.0;
-    if (prof == "day2") {
+    if (prof == "day2" || prof == "day2fast") {
       cfg.enableCerenkov = true;
       cfg.enableAbsorption = true;
       cfg.enableBoundary = true;
@@ -430,6 +966,7 @@ int main(int argc, char** argv) {
 
   OpticalProcessConfig opticalCfg = makeDefaultOptConfig(profileNorm);
   opticalCfg = applyOptOverride(optEnableOverride, opticalCfg);
+  opticalCfg.fastDirectLight = directLight;
   if (timingBoundaryOnly) {
     opticalCfg.enableCerenkov = false;
     opticalCfg.enableAbsorption = false;
@@ -440,6 +977,26 @@ int main(int argc, char** argv) {
     G4cout << "[CFG] timing_opt_boundary_only: forced boundary-only optics\n";
   }
 
+  if (!segmentsIn.empty() && !segmentsOut.empty()) {
+    G4cout << "[WARN] --segments_in replays stored segments; --segments_out ignored.\n";
+    segmentsOut.clear();
+  }
+  if ((!segmentsOut.empty() || !segmentsIn.empty()) && lazyCerenkov == 0) {
+    lazyCerenkov = LazyCerenkov::kDefaultChunk;
+  }
+  if (lazyCerenkov > 0 && segmentsIn.empty() && !opticalCfg.enableCerenkov) {
+    G4cout << "[WARN] --lazy_cerenkov/--segments_out need Cerenkov enabled; ignored.\n";
+    lazyCerenkov = 0;
+    segmentsOut.clear();
+  }
+  if (lazyCerenkov > 0) {
+    // The segments stand in for G4Cerenkov, which must not emit as well.
+    LazyCerenkov::Configure(lazyCerenkov);
+    opticalCfg.enableCerenkov = false;
+    G4cout << "[CFG] Lazy Cerenkov: G4Cerenkov off; photons from emitter segments, "
+           << lazyCerenkov << " per chunk" << G4endl;
+  }
+
   auto* physicsList = new PhysicsList(opticalCfg);
   if (isDay2Profile || isDay3Profile) {
     physicsList->SetDefaultCutValue(0.1 * mm);
@@ -480,6 +1037,131 @@ int main(int argc, char** argv) {
   runProfile.enableJitter = digitizerEnableJitter;
   runProfile.gateMode = digitizerGateMode;
   runProfile.gateNsOverride = digitizerGateNsOverride;
+  runProfile.photonWeight = photonWeight;
+  if (!photonLibraryPath.empty()) {
+    try {
+      PhotonLibrary::SetShared(PhotonLibrary::Open(photonLibraryPath));
+      const auto& lib = PhotonLibrary::Shared()->Info();
+      G4cout << "[CFG] Photon library " << photonLibraryPath << ": voxels=" << lib.nVoxel[0] << "x"
+             << lib.nVoxel[1] << "x" << lib.nVoxel[2] << " dirs=" << lib.nCosTheta << "x" << lib.nPhi
+             << " lambda_bins=" << lib.nLambda << " entries=" << lib.nEntries
+             << " (optical photons are not tracked)\n";
+      if (gateTimeCut) {
+        G4cout << "[WARN] --gate_time_cut has no effect with --photon_library.\n";
+        gateTimeCut = false;
+      }
+    } catch (const std::exception& ex) {
+      G4Exception("main", "PhotonLibrary", FatalException, ex.what());
+    }
+  }
+  if (gateTimeCut) {
+    if (!runProfile.enableDigitizer || toLower(digitizerGateMode) != "standard") {
+      G4cout << "[WARN] --gate_time_cut needs the digitizer in gate_mode=standard; ignored.\n";
+      gateTimeCut = false;
+    } else {
+      try {
+        const double gateEndNs = PMTDigitizer::GateEndNs(
+            runProfile.pmtConfigPath.empty() ? "detector/config/pmt.yaml" : runProfile.pmtConfigPath,
+            digitizerGateNsOverride);
+        OpticalTimeCut::Configure(gateEndNs, gateTimeCutMarginNs);
+        G4cout << "[CFG] Gate time cut: optical photons killed after t0+" << OpticalTimeCut::CutNs()
+               << " ns (gate end " << gateEndNs << " ns + margin " << gateTimeCutMarginNs << " ns)\n";
+      } catch (const std::exception& ex) {
+        G4cout << "[WARN] --gate_time_cut disabled: " << ex.what() << "\n";
+        gateTimeCut = false;
+      }
+    }
+  }
+  bool roulette = rouletteReflections > 0 || rouletteDistanceM > 0.0;
+  if (roulette && (!photonLibraryPath.empty() || BatchOptics::Enabled())) {
+    G4cout << "[WARN] --roulette_* needs Geant4 optical tracking; ignored with "
+           << (photonLibraryPath.empty() ? "--optical_backend=batch" : "--photon_library") << ".\n";
+    roulette = false;
+  }
+  if (roulette && (rouletteSurvival <= 0.0 || rouletteSurvival >= 1.0)) {
+    G4cout << "[WARN] --roulette_survival must be in (0, 1); roulette disabled.\n";
+    roulette = false;
+  }
+  if (roulette) {
+    OpticalRoulette::Configure(rouletteReflections, rouletteDistanceM * 1000.0, rouletteSurvival);
+    G4cout << "[CFG] Roulette: optical photons survive with p=" << rouletteSurvival << " every";
+    if (rouletteReflections > 0) G4cout << " " << rouletteReflections << " reflections";
+    if (rouletteReflections > 0 && rouletteDistanceM > 0.0) G4cout << " and every";
+    if (rouletteDistanceM > 0.0) G4cout << " " << rouletteDistanceM << " m";
+    G4cout << " (weight /p)\n";
+  }
+  if (photonWeight > 1.0) {
+    G4cout << "[CFG] Photon weighting: 1/" << photonWeight << " of optical photons tracked at weight "
+           << photonWeight << "\n";
+  }
+  if (qePrethin && !runProfile.enableDigitizer) {
+    G4cout << "[WARN] --qe_prethin needs the digitizer to renormalize QE; ignored for profile '"
+           << profile << "'.\n";
+    qePrethin = false;
+  }
+  if (qePrethin) {
+    try {
+      runProfile.photonKeepProbability = PMTDigitizer::PeakEfficiency(
+          runProfile.pmtConfigPath.empty() ? "detector/config/pmt.yaml" : runProfile.pmtConfigPath,
+          runProfile.qeFlatOverride, runProfile.qeScaleFactor);
+      runProfile.qePrethin = true;
+      G4cout << "[CFG] QE pre-thinning: keep optical photons with p="
+             << runProfile.photonKeepProbability << " at birth\n";
+    } catch (const std::exception& ex) {
+      G4cout << "[WARN] --qe_prethin disabled: " << ex.what() << "\n";
+      qePrethin = false;
+    }
+  }
+  if (shardCount > 0) {
+    if (firstEntry >= 0 || nEntries >= 0) {
+      G4cout << "[WARN] --shard overrides --first_entry/--n_entries\n";
+    }
+    runProfile.shardIndex = shardIndex;
+    runProfile.shardCount = shardCount;
+    runProfile.outputTag = ".shard" + std::to_string(shardIndex);
+    G4cout << "[CFG] Shard " << shardIndex << "/" << shardCount
+           << " (output tag " << runProfile.outputTag << ")\n";
+  } else if (firstEntry >= 0 || nEntries >= 0) {
+    runProfile.firstEntry = firstEntry;
+    runProfile.nEntries = nEntries;
+    G4cout << "[CFG] Entry range: first=" << std::max(0LL, firstEntry)
+           << " n=" << (nEntries < 0 ? std::string("all") : std::to_string(nEntries)) << "\n";
+  }
+  if (!segmentsOut.empty() || !segmentsIn.empty()) {
+    // Sharded stages pair up: shard i of stage 2 replays shard i of stage 1.
+    try {
+      if (!segmentsOut.empty()) {
+        segmentsOut = OutputMerge::TagPath(segmentsOut, runProfile.outputTag);
+        LazyCerenkov::WriteTo(segmentsOut);
+        G4cout << "[CFG] Stage 1: emitter segments written to " << segmentsOut
+               << " (no optical photons generated)\n";
+      } else {
+        segmentsIn = OutputMerge::TagPath(segmentsIn, runProfile.outputTag);
+        LazyCerenkov::ReadFrom(segmentsIn);
+        G4cout << "[CFG] Stage 2: optics replayed from " << segmentsIn
+               << " (charged particles are not simulated)\n";
+      }
+    } catch (const std::exception& ex) {
+      G4Exception("main", "SegmentFile", FatalException, ex.what());
+    }
+  }
+  if (!photonRecordsPath.empty()) {
+    // Needs real photon paths: the library and batch modes do not track them.
+    if (!photonLibraryPath.empty() || BatchOptics::Enabled()) {
+      G4cout << "[WARN] --photon_records needs Geant4 optical tracking; ignored with "
+             << (photonLibraryPath.empty() ? "--optical_backend=batch" : "--photon_library") << ".\n";
+      photonRecordsPath.clear();
+    } else {
+      try {
+        photonRecordsPath = OutputMerge::TagPath(photonRecordsPath, runProfile.outputTag);
+        PhotonRecords::Configure(photonRecordsPath);
+        G4cout << "[CFG] Photon records: detected photons written to " << photonRecordsPath << "\n";
+      } catch (const std::exception& ex) {
+        G4cout << "[WARN] --photon_records disabled: " << ex.what() << "\n";
+        photonRecordsPath.clear();
+      }
+    }
+  }
   G4cout << "[CFG] PMT config path: "
          << (runProfile.pmtConfigPath.empty() ? "<none>" : runProfile.pmtConfigPath)
          << G4endl;
@@ -496,6 +1178,9 @@ int main(int argc, char** argv) {
   RunManifest manifest;
   manifest.profile = profile;
   manifest.macro = macroArg.empty() ? "<interactive>" : macroArg;
+  manifest.geometrySource = geometryConfig.empty() ? "gdml" : "native";
+  manifest.geometryPath = geometryConfig.empty() ? std::string(gdml) : geometryConfig;
+  manifest.geometryContents = geometryConfig.empty() ? std::string() : readFile(geometryConfig);
   manifest.opticsPath = opticsConfig;
   manifest.opticsContents = readFile(opticsConfig);
   manifest.pmtPath = runProfile.pmtConfigPath;
@@ -505,15 +1190,61 @@ int main(int argc, char** argv) {
   manifest.compiler = FLNDR_COMPILER;
   manifest.cxxFlags = FLNDR_CXX_FLAGS;
   manifest.digitizerEnabled = runProfile.enableDigitizer;
-  manifest.digitizerOutput = runProfile.pmtOutputPath;
+  manifest.digitizerOutput = OutputMerge::TagPath(runProfile.pmtOutputPath, runProfile.outputTag);
   manifest.opticsOverride = optEnableOverride;
   manifest.opticalDebug = optDebug;
   manifest.quiet = quiet;
   manifest.opticalVerboseLevel = optVerbose;
   manifest.summaryEvery = summaryEvery;
+  manifest.threads = effectiveThreads;
+  manifest.seed = runSeed;
+  manifest.eventSeeding = eventSeeding;
+  manifest.subEventPhotons = subEventPhotons;
+  manifest.digiThreads = digiThreads;
+  manifest.lazyCerenkovChunk = lazyCerenkov;
+  manifest.segmentsOut = segmentsOut;
+  manifest.segmentsIn = segmentsIn;
+  manifest.photonRecords = photonRecordsPath;
+  manifest.rouletteReflections = roulette ? rouletteReflections : 0;
+  manifest.rouletteDistanceM = roulette ? rouletteDistanceM : 0.0;
+  manifest.rouletteSurvival = roulette ? rouletteSurvival : 1.0;
+  manifest.shardIndex = shardIndex;
+  manifest.shardCount = shardCount;
   manifest.qeScaleOverride = qeOverride;
   manifest.qeFlatOverride = qeFlat;
+  manifest.qePrethin = runProfile.qePrethin;
+  manifest.photonKeepProbability = runProfile.photonKeepProbability;
+  manifest.photonWeight = photonWeight;
+  manifest.photonLibrary = photonLibraryPath;
+  manifest.opticalBackend = opticalBackend;
+  manifest.pmtMode = pmtMode;
+  manifest.pmtPlacement = PMTPlacementName(PMTPlacementFromEnv());
+  manifest.cathodeSurface = CathodeSurfaceName(CathodeSurfaceFromEnv());
+  manifest.directLight = directLight;
+  manifest.fastIndirectFraction = directLight ? DirectLight::IndirectFraction() : 0.0;
+  manifest.gateTimeCutNs = gateTimeCut ? OpticalTimeCut::CutNs()
+                                       : std::numeric_limits<double>::quiet_NaN();
   manifest.thresholdPEOverride = thresholdPE;
+
+  // Physics tables depend on the process list, the cuts and the materials
+  // (geometry file, optics property tables).
+  if (physicsCache == "off" || physicsCache == "0") physicsCache.clear();
+  if (!physicsCache.empty()) {
+    std::ostringstream key;
+    key << "geant4=" << G4VERSION_NUMBER
+        << " physics_list=FTFP_BERT+G4OpticalPhysics"
+        << " cerenkov=" << opticalCfg.enableCerenkov << " abs=" << opticalCfg.enableAbsorption
+        << " rayleigh=" << opticalCfg.enableRayleigh << " mie=" << opticalCfg.enableMie
+        << " boundary=" << opticalCfg.enableBoundary << " fast_direct_light=" << opticalCfg.fastDirectLight
+        << " default_cut_mm=" << physicsList->GetDefaultCutValue() / mm
+        << " optics=" << PhysicsTableCache::Hash(manifest.opticsContents)
+        << " geometry=" << PhysicsTableCache::Hash(manifest.geometrySource == "native"
+                                                       ? manifest.geometryContents
+                                                       : readFile(manifest.geometryPath));
+    PhysicsTableCache::Configure(physicsCache, key.str(), physicsList);
+  }
+  manifest.physicsCache = PhysicsTableCache::Enabled() ? PhysicsTableCache::Directory() : std::string();
+  manifest.physicsTablesRetrieved = PhysicsTableCache::Retrieved();
   SetRunManifest(std::move(manifest));
 
   runManager->SetUserInitialization(new ActionInitialization(rtrk, zshift, runProfile));
@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+# The batch tracer must reproduce Geant4 tracking within the photon
+# statistics of the sample: |ratio - 1| <= 3 sigma, with sigma the Poisson
+# error of the batch/geant4 PE ratio from batch_optics_compare.sh.
+set -euo pipefail
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." && pwd)"
+cd "$repo_root"
+
+export QC_BATCH_OPTICS_MACRO="$repo_root/macros/detector/dev/mu50_fast_5.mac"
+
+rm -f out/day2/qc/batch_optics.json
+bash detector/tools/qc/batch_optics_compare.sh
+
+python3 - <<'PY'
+import json
+from pathlib import Path
+
+data = json.loads(Path("out/day2/qc/batch_optics.json").read_text())
+ratio = float(data.get("ratio", float("nan")))
+sigma = float(data.get("sigma_ratio", float("nan")))
+if not sigma > 0:
+    raise SystemExit(f"No PE to compare: {data}")
+if not abs(ratio - 1.0) <= 3.0 * sigma:
+    raise SystemExit(f"Batch optics PE differs from Geant4 tracking: ratio={ratio:.4f} "
+                     f"sigma={sigma:.4f} ({abs(ratio - 1.0) / sigma:.1f} sigma)")
+print(f"[TEST] Batch optics PE ratio OK: {ratio:.4f} +- {sigma:.4f}")
+PY
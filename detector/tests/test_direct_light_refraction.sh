@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+# day2fast with --fast_indirect_fraction=1 counts every photon analytically
+# and tracks it on as well; PMTSD must drop the tracked copy of a direct
+# photon. At 45 deg incidence the photon refracts into the photocathode
+# (n = 1.50 vs water), so a direction check would let it through and count
+# it twice: the PE at 45 deg must match normal incidence, not double it.
+set -euo pipefail
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." && pwd)"
+cd "$repo_root"
+source detector/GEANT4.sh
+
+outdir="out/day2/qc"
+mkdir -p "$outdir"
+for tilt in 0 45; do
+  cat <<MAC > "$outdir/direct_light_refraction_${tilt}.mac"
+/fln/genMode gun
+/run/initialize
+/vis/disable
+/fln/aimAtPMT 0 300 3 400 ${tilt} water
+/run/beamOn 5
+MAC
+  rm -f "$outdir/direct_light_refraction_${tilt}.root"
+  FLNDR_PMTHITS_OUT="$outdir/direct_light_refraction_${tilt}.root" \
+    detector/build/flndr --profile=day2fast --quiet --summary_every=0 --threads=1 --seed=12345 \
+    --fast_indirect_fraction=1 --threshold_pe=0 \
+    "$outdir/direct_light_refraction_${tilt}.mac"
+done
+
+python detector/tools/qc/pe_yield.py --json "$outdir/direct_light_refraction.json" \
+  --csv "$outdir/direct_light_refraction.csv" \
+  "$outdir/direct_light_refraction_0.root" "$outdir/direct_light_refraction_45.root"
+
+python3 - "$outdir/direct_light_refraction.json" <<'PY'
+import json
+import sys
+from pathlib import Path
+
+by_file = {Path(e["file"]).name: e for e in json.loads(Path(sys.argv[1]).read_text())}
+normal = by_file["direct_light_refraction_0.root"]["totalPE"]
+oblique = by_file["direct_light_refraction_45.root"]["totalPE"]
+if not normal > 0:
+    raise SystemExit(f"No PE at normal incidence: {normal}")
+ratio = oblique / normal
+if abs(ratio - 1.0) > 0.15:
+    raise SystemExit(f"Refracted direct photons counted twice: normal={normal} oblique={oblique} ratio={ratio:.3f}")
+print(f"[TEST] Direct light counted once under refraction: normal={normal} oblique={oblique} ratio={ratio:.3f}")
+PY
@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+# --gate_time_cut must measure time from the event t0: with the primary at
+# t0 = 5 us (far past gate end + margin), cut on and cut off must give the
+# same PE. Killing late photons shifts the random-number stream of the
+# photons tracked after them, so the totals agree statistically, not bit
+# for bit; a cut measured from t = 0 would kill every photon (PE ~ 0).
+set -euo pipefail
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." && pwd)"
+cd "$repo_root"
+source detector/GEANT4.sh
+
+outdir="out/day2/qc"
+mkdir -p "$outdir"
+cat <<'MAC' > "$outdir/gate_time_cut_t0.mac"
+/fln/genMode gun
+/run/initialize
+/vis/disable
+/gun/particle mu-
+/gun/energy 10 GeV
+/gun/position 0 0 -19850 mm
+/gun/direction 0 0 1
+/gun/time 5 us
+/run/beamOn 5
+MAC
+
+for cut in 0 1; do
+  rm -f "$outdir/gate_time_cut_t0_${cut}.root"
+  FLNDR_PMTHITS_OUT="$outdir/gate_time_cut_t0_${cut}.root" \
+    detector/build/flndr --profile=day2 --quiet --summary_every=0 --threads=1 --seed=12345 \
+    --optics=detector/config/optics_clear.yaml --threshold_pe=0 \
+    --gate_mode=standard --gate_time_cut="$cut" \
+    "$outdir/gate_time_cut_t0.mac"
+done
+
+python detector/tools/qc/pe_yield.py --json "$outdir/gate_time_cut_t0.json" --csv "$outdir/gate_time_cut_t0.csv" \
+  "$outdir/gate_time_cut_t0_0.root" "$outdir/gate_time_cut_t0_1.root"
+
+python3 - "$outdir/gate_time_cut_t0.json" <<'PY'
+import json
+import sys
+from pathlib import Path
+
+by_file = {Path(e["file"]).name: e for e in json.loads(Path(sys.argv[1]).read_text())}
+off = by_file["gate_time_cut_t0_0.root"]["totalPE"]
+on = by_file["gate_time_cut_t0_1.root"]["totalPE"]
+if not off > 0:
+    raise SystemExit(f"No PE without the cut: {off}")
+ratio = on / off
+if abs(ratio - 1.0) > 0.03:
+    raise SystemExit(f"Gate time cut changes PE at t0=5us: off={off} on={on} ratio={ratio:.3f}")
+print(f"[TEST] Gate time cut at t0=5us keeps PE: off={off} on={on} ratio={ratio:.3f}")
+PY
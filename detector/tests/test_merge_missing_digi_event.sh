@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+# flndr_merge must catch a digitizer shard that lost an event. Two jobs
+# digitize entries [0,3) and [3,6); their merge passes. Dropping entry 3
+# from the second shard's hits and digi_events (its manifest still claims
+# [3,6)) must make the merge fail, whether or not entry 3 had any hits.
+set -euo pipefail
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." && pwd)"
+cd "$repo_root"
+source detector/GEANT4.sh
+
+outdir="out/day2/qc"
+mkdir -p "$outdir"
+cat <<'MAC' > "$outdir/merge_missing_digi_event.mac"
+/run/initialize
+/vis/disable
+/run/beamOn 3
+MAC
+
+for first in 0 3; do
+  rm -f "$outdir/merge_missing_digi_event_${first}.root"
+  FLNDR_PMTHITS_OUT="$outdir/merge_missing_digi_event_${first}.root" \
+    detector/build/flndr --profile=day2fast --quiet --summary_every=0 --threads=1 --seed=12345 \
+    --first_entry="$first" --n_entries=3 \
+    "$outdir/merge_missing_digi_event.mac"
+done
+
+detector/build/flndr_merge --out="$outdir/merge_missing_digi_event_ok.root" \
+  "$outdir/merge_missing_digi_event_0.root" "$outdir/merge_missing_digi_event_3.root"
+
+cat <<'C' > "$outdir/merge_drop_event.C"
+void merge_drop_event(const char* in, const char* out, int event) {
+  TFile fin(in);
+  TFile fout(out, "RECREATE");
+  for (const char* name : {"hits", "digi_events"}) {
+    auto* tree = static_cast<TTree*>(fin.Get(name));
+    fout.cd();
+    tree->CopyTree(Form("event != %d", event))->Write();
+  }
+  fout.cd();
+  fin.Get("run_manifest")->Write("run_manifest");
+  fout.Close();
+}
+C
+root -l -b -q "$outdir/merge_drop_event.C(\"$outdir/merge_missing_digi_event_3.root\",\"$outdir/merge_missing_digi_event_3_drop.root\",3)"
+
+status=0
+log="$(detector/build/flndr_merge --out="$outdir/merge_missing_digi_event_bad.root" \
+  "$outdir/merge_missing_digi_event_0.root" "$outdir/merge_missing_digi_event_3_drop.root" 2>&1)" || status=$?
+echo "$log"
+if [[ "$status" -ne 1 ]]; then
+  echo "Merge with entry 3 missing exited $status, expected 1" >&2
+  exit 1
+fi
+if ! grep -q "MISSING: digitizer event 3" <<<"$log"; then
+  echo "Merge did not report digitizer event 3 as missing" >&2
+  exit 1
+fi
+echo "[TEST] flndr_merge flags the digitizer shard missing entry 3"
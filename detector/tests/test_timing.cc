@@ -11,17 +11,6 @@
 #include <numeric>
 #include <vector>
 
-namespace PrimaryInfo {
-static G4ThreeVector gX0(0., 0., 0.);
-static double gT0 = 0.0;
-void Set(const G4ThreeVector& x0, double t0_ns) {
-  gX0 = x0;
-  gT0 = t0_ns;
-}
-const G4ThreeVector& X0() { return gX0; }
-double T0ns() { return gT0; }
-} // namespace PrimaryInfo
-
 namespace {
 
 double compute_sigma(const std::vector<double>& values) {
@@ -56,7 +45,7 @@ std::vector<double> extract_times(const std::vector<DigiHit>& hits) {
 } // namespace
 
 int main() {
-  PrimaryInfo::Set(G4ThreeVector(), 0.0);
+  const double t0_ns = 0.0;
 
   DigitizerParams base;
   base.QE = 1.0;
@@ -72,7 +61,7 @@ int main() {
   CLHEP::HepRandom::setTheSeed(12345);
   Digitizer digiNoSmear(base);
   std::vector<DigiHit> outNoSmear;
-  digiNoSmear.Digitize(0, hits, outNoSmear);
+  digiNoSmear.Digitize(0, t0_ns, hits, outNoSmear);
   const double sigmaNoSmear = compute_sigma(extract_times(outNoSmear));
 
   std::cout << "[timing] sigma(TTS=0,J=0) = " << sigmaNoSmear << " ns" << std::endl;
@@ -88,7 +77,7 @@ int main() {
   CLHEP::HepRandom::setTheSeed(67890);
   Digitizer digiSmear(smear);
   std::vector<DigiHit> outSmear;
-  digiSmear.Digitize(1, hits, outSmear);
+  digiSmear.Digitize(1, t0_ns, hits, outSmear);
   const double sigmaSmear = compute_sigma(extract_times(outSmear));
   const double expectedSigma = std::sqrt(smear.TTS_ns * smear.TTS_ns +
                                          smear.JITTER_ns * smear.JITTER_ns);
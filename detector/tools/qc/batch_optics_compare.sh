@@ -0,0 +1,83 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+script_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_root="$(cd "$script_dir/../../.." && pwd)"
+source "$repo_root/detector/GEANT4.sh"
+
+outdir="$repo_root/out/day2/qc"
+mkdir -p "$outdir"
+macro="${QC_BATCH_OPTICS_MACRO:-$repo_root/macros/detector/dev/mu50_fast.mac}"
+optics="${QC_BATCH_OPTICS_CONFIG:-detector/config/optics_clear.yaml}"
+
+rm -f "$outdir/batch_optics_wall.txt.tmp"
+for backend in geant4 batch; do
+  out_root="$outdir/mu50_fast_${backend}.root"
+  echo "[BATCH_OPTICS] Running ${backend} backend..."
+  rm -f "$out_root"
+  start=$(date +%s%N)
+  FLNDR_PMTHITS_OUT="$out_root" \
+    "$repo_root/detector/build/flndr" --profile=day2 --quiet --summary_every=0 \
+    --optics="$optics" \
+    --optical_backend="$backend" \
+    --threshold_pe=0 \
+    "$macro"
+  end=$(date +%s%N)
+  echo "$backend $(( (end - start) / 1000000 ))" >> "$outdir/batch_optics_wall.txt.tmp"
+done
+mv "$outdir/batch_optics_wall.txt.tmp" "$outdir/batch_optics_wall.txt"
+
+json_detail="$outdir/batch_optics_detail.json"
+csv_detail="$outdir/batch_optics_detail.csv"
+python "$repo_root/detector/tools/qc/pe_yield.py" \
+  --json "$json_detail" --csv "$csv_detail" \
+  "$outdir/mu50_fast_geant4.root" "$outdir/mu50_fast_batch.root"
+
+python - "$repo_root" <<'PY'
+import json
+import math
+from pathlib import Path
+import sys
+
+import uproot
+
+repo = Path(sys.argv[1])
+qc = repo / 'out/day2/qc'
+data = json.loads((qc / 'batch_optics_detail.json').read_text())
+by_file = {Path(entry["file"]).name: entry for entry in data}
+try:
+    pe_g4 = by_file['mu50_fast_geant4.root']['totalPE']
+    pe_batch = by_file['mu50_fast_batch.root']['totalPE']
+except KeyError as ex:
+    raise SystemExit(f"Missing expected entry in detail JSON: {ex}") from ex
+
+def photon_weight(name):
+    """Photon weight w from the run manifest: npe sums weights, so Var(PE) = w * PE."""
+    with uproot.open(qc / name) as f:
+        if "run_manifest;1" not in f:
+            return 1.0
+        manifest = json.loads(f["run_manifest;1"].member("fTitle"))
+    return float(manifest.get("photon_weight", 1.0))
+
+w_g4 = photon_weight('mu50_fast_geant4.root')
+w_batch = photon_weight('mu50_fast_batch.root')
+ratio = pe_batch / pe_g4 if pe_g4 else float('nan')
+# Poisson error of the ratio of two independent weighted PE counts.
+sigma = ratio * math.sqrt(w_g4 / pe_g4 + w_batch / pe_batch) if pe_g4 and pe_batch else float('nan')
+
+wall = {}
+for line in (qc / 'batch_optics_wall.txt').read_text().splitlines():
+    name, ms = line.split()
+    wall[name] = float(ms) / 1000.0
+
+summary = {
+    'PE_geant4': pe_g4,
+    'PE_batch': pe_batch,
+    'ratio': ratio,
+    'sigma_ratio': sigma,
+    'wall_s': wall,
+}
+out_path = qc / 'batch_optics.json'
+out_path.write_text(json.dumps(summary, indent=2))
+print(f"[BATCH_OPTICS] Wrote summary JSON: {out_path}")
+PY
@@ -0,0 +1,71 @@
+#!/usr/bin/env bash
+# GDML vs native geometry builder (--geometry): runs the same macro once per
+# geometry source and compares the geometry build time (the [GEOM] build_ms
+# line), the wall time, the PMT count and the total PE. Fails if the two
+# sources place a different number of PMTs.
+#
+#   QC_NATIVE_GEOMETRY_CONFIG=detector/config/geometry.yaml \
+#     bash detector/tools/qc/native_geometry_compare.sh
+set -euo pipefail
+
+script_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_root="$(cd "$script_dir/../../.." && pwd)"
+source "$repo_root/detector/GEANT4.sh"
+
+outdir="$repo_root/out/day2/qc"
+mkdir -p "$outdir"
+macro="${QC_NATIVE_GEOMETRY_MACRO:-$repo_root/macros/detector/dev/mu50_fast_5.mac}"
+geometry="${QC_NATIVE_GEOMETRY_CONFIG:-$repo_root/detector/config/geometry.yaml}"
+
+rm -f "$outdir/native_geometry_wall.txt.tmp"
+for source in gdml native; do
+  out_root="$outdir/native_geometry_${source}.root"
+  log="$outdir/native_geometry_${source}.log"
+  geometry_arg=()
+  [[ "$source" == native ]] && geometry_arg=(--geometry="$geometry")
+  echo "[NATIVE_GEOM] Running ${source} geometry..."
+  rm -f "$out_root"
+  start=$(date +%s%N)
+  FLNDR_PMTHITS_OUT="$out_root" \
+    "$repo_root/detector/build/flndr" --profile=day2 --quiet --summary_every=0 \
+    --seed=12345 --threshold_pe=0 ${geometry_arg[@]+"${geometry_arg[@]}"} "$macro" > "$log" 2>&1
+  end=$(date +%s%N)
+  echo "$source $(( (end - start) / 1000000 ))" >> "$outdir/native_geometry_wall.txt.tmp"
+done
+mv "$outdir/native_geometry_wall.txt.tmp" "$outdir/native_geometry_wall.txt"
+
+python "$repo_root/detector/tools/qc/pe_yield.py" \
+  --json "$outdir/native_geometry_detail.json" --csv "$outdir/native_geometry_detail.csv" \
+  "$outdir/native_geometry_gdml.root" "$outdir/native_geometry_native.root"
+
+python - "$outdir" <<'PY'
+import json
+import re
+import sys
+from pathlib import Path
+
+qc = Path(sys.argv[1])
+by_file = {Path(e["file"]).name: e for e in json.loads((qc / "native_geometry_detail.json").read_text())}
+wall = dict(line.split() for line in (qc / "native_geometry_wall.txt").read_text().splitlines())
+
+summary = {}
+for source in ("gdml", "native"):
+    log = (qc / f"native_geometry_{source}.log").read_text()
+    build = re.search(r"^\[GEOM\] source=\S+ path=\S+ build_ms=([0-9.eE+-]+)", log, re.M)
+    placed = re.search(r"^\[PMT\] placed=(\d+)", log, re.M)
+    summary[source] = {
+        "geometry_build_ms": float(build.group(1)) if build else None,
+        "wall_s": float(wall[source]) / 1000.0,
+        "pmts": int(placed.group(1)) if placed else None,
+        "totalPE": by_file[f"native_geometry_{source}.root"]["totalPE"],
+    }
+g, n = summary["gdml"], summary["native"]
+summary["pe_ratio"] = n["totalPE"] / g["totalPE"] if g["totalPE"] else float("nan")
+out_path = qc / "native_geometry.json"
+out_path.write_text(json.dumps(summary, indent=2))
+print(f"[NATIVE_GEOM] build_ms gdml={g['geometry_build_ms']} native={n['geometry_build_ms']}"
+      f" pmts gdml={g['pmts']} native={n['pmts']} PE ratio={summary['pe_ratio']:.3f}")
+print(f"[NATIVE_GEOM] Wrote summary JSON: {out_path}")
+if g["pmts"] != n["pmts"]:
+    raise SystemExit("[NATIVE_GEOM] GDML and native geometry place different PMT counts")
+PY
@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+"""
+Reweight detected photons from one FLOUNDER run to other water models.
+
+flndr --photon_records=<file.csv> writes every photocathode hit with its
+wavelength, time after t0, weight, path length and Rayleigh/Mie scatter
+counts. The path is independent of the water model, so each photon's
+detection probability under another ABSLENGTH(lambda)/RAYLEIGH(lambda)
+table differs from the generated one by
+
+    w = exp(-L (1/A' - 1/A)) * (R/R')^n_rayleigh * exp(-L (1/R' - 1/R))
+
+with A, R the generated and A', R' the target lengths at the photon's
+wavelength (interpolated linearly in photon energy, as Geant4 does).
+Generate once with absorption off (--opt_enable=cerenkov,rayleigh,boundary)
+or with the longest absorption lengths of the models to keep w <= 1.
+Rayleigh must be on in the generation if any target model scatters.
+
+Usage:
+    python detector/tools/qc/optics_reweight.py photons.csv [more.csv ...] \\
+        --generated detector/config/optics_clear.yaml \\
+        --gen_opt_enable cerenkov,rayleigh,boundary \\
+        --model detector/config/optics_lake.yaml --model detector/config/optics_poor.yaml
+
+Outputs:
+    JSON: out/day2/qc/optics_reweight.json (one entry per model)
+    CSV : out/day2/qc/optics_reweight.csv
+    CSV : out/day2/qc/optics_reweight_time.csv (weighted t - t0 histogram per model)
+"""
+
+import argparse
+import csv
+import json
+import math
+import sys
+from pathlib import Path
+from typing import Dict, List, Optional, Set
+
+import numpy as np
+import yaml
+
+HC_EV_NM = 1239.84198  # h c in eV nm
+ALL_PROCESSES = {"cerenkov", "abs", "rayleigh", "mie", "boundary"}
+
+
+def find_key(node: Dict, names) -> Optional[object]:
+    lowered = {str(k).lower(): v for k, v in node.items()}
+    for name in names:
+        if name.lower() in lowered:
+            return lowered[name.lower()]
+    return None
+
+
+class WaterModel:
+    """ABSLENGTH and RAYLEIGH of the `water` section of an optics YAML."""
+
+    def __init__(self, path: Path, processes: Set[str]):
+        with path.open() as f:
+            root = yaml.safe_load(f) or {}
+        water = find_key(root, ["water"])
+        lam = find_key(root, ["wavelength_nm"])
+        if not isinstance(water, dict) or lam is None:
+            raise ValueError(f"{path}: needs 'wavelength_nm' and a 'water' section")
+        absorption = find_key(water, ["absorption_length_mm", "abs_length_mm", "ABSLENGTH", "absorption"])
+        rayleigh = find_key(water, ["rayleigh_length_mm", "scattering_length_mm", "RAYLEIGH"])
+        if absorption is None or rayleigh is None:
+            raise ValueError(f"{path}: water section lacks absorption or Rayleigh lengths")
+        lam = np.asarray(lam, dtype=float)
+        if not (len(lam) == len(absorption) == len(rayleigh)):
+            raise ValueError(f"{path}: water spectra do not match the wavelength grid")
+        # Geant4 interpolates material properties linearly in photon energy.
+        order = np.argsort(HC_EV_NM / lam)
+        self.name = path.stem
+        self.path = str(path)
+        self.energy = (HC_EV_NM / lam)[order]
+        self.abs_mm = np.asarray(absorption, dtype=float)[order]
+        self.ray_mm = np.asarray(rayleigh, dtype=float)[order]
+        self.absorption = "abs" in processes
+        self.rayleigh = "rayleigh" in processes
+
+    def inverse_lengths(self, wavelength_nm: np.ndarray):
+        energy = HC_EV_NM / wavelength_nm
+        zero = np.zeros_like(energy)
+        mu_a = 1.0 / np.interp(energy, self.energy, self.abs_mm) if self.absorption else zero
+        mu_s = 1.0 / np.interp(energy, self.energy, self.ray_mm) if self.rayleigh else zero
+        return mu_a, mu_s
+
+
+def parse_processes(text: Optional[str]) -> Set[str]:
+    if not text:
+        return set(ALL_PROCESSES)
+    procs = {p.strip().lower() for p in text.split(",") if p.strip()}
+    unknown = procs - ALL_PROCESSES
+    if unknown:
+        raise ValueError(f"unknown optical processes: {', '.join(sorted(unknown))}")
+    return procs
+
+
+def load_records(paths: List[Path]) -> Dict[str, np.ndarray]:
+    columns = ["event", "pmt", "t_rel_ns", "weight", "wavelength_nm", "path_mm", "n_rayleigh", "n_mie"]
+    chunks = []
+    for path in paths:
+        data = np.genfromtxt(path, delimiter=",", names=True, ndmin=1)
+        missing = [c for c in columns if c not in (data.dtype.names or ())]
+        if missing:
+            raise ValueError(f"{path}: missing columns {', '.join(missing)}")
+        chunks.append(data)
+    data = np.concatenate(chunks) if chunks else np.zeros(0)
+    return {c: np.asarray(data[c], dtype=float) for c in columns}
+
+
+def load_qe(path: Optional[Path]):
+    """QE(lambda) * QE_scale as the digitizer applies it (linear in wavelength)."""
+    if path is None:
+        return None
+    with path.open() as f:
+        cfg = yaml.safe_load(f) or {}
+    lam = find_key(cfg, ["wavelength_nm"])
+    qe = find_key(cfg, ["QE_curve", "qe"])
+    if lam is None or qe is None:
+        raise ValueError(f"{path}: needs 'wavelength_nm' and 'QE_curve'")
+    scale = float(find_key(cfg, ["QE_scale", "qe_scale"]) or 1.0)
+    lam = np.asarray(lam, dtype=float)
+    qe = np.asarray(qe, dtype=float)
+    order = np.argsort(lam)
+    return lambda wl: np.clip(scale * np.interp(wl, lam[order], qe[order]), 0.0, 1.0)
+
+
+def weighted_quantile(values: np.ndarray, weights: np.ndarray, q: float) -> float:
+    if values.size == 0 or weights.sum() <= 0.0:
+        return float("nan")
+    order = np.argsort(values)
+    cum = np.cumsum(weights[order])
+    return float(values[order][np.searchsorted(cum, q * cum[-1])])
+
+
+def summarise(model: WaterModel, gen: WaterModel, rec: Dict[str, np.ndarray],
+              qe, n_events: int, edges: np.ndarray):
+    wl = rec["wavelength_nm"]
+    path = rec["path_mm"]
+    n_ray = rec["n_rayleigh"]
+    mu_a0, mu_s0 = gen.inverse_lengths(wl)
+    mu_a1, mu_s1 = model.inverse_lengths(wl)
+    if model.rayleigh and not gen.rayleigh:
+        raise ValueError(f"{model.name}: Rayleigh is on but was off in the generation; cannot reweight")
+
+    log_w = -path * (mu_a1 - mu_a0) - path * (mu_s1 - mu_s0)
+    scattered = n_ray > 0
+    if model.rayleigh:
+        log_w[scattered] += n_ray[scattered] * np.log(mu_s1[scattered] / mu_s0[scattered])
+    else:
+        log_w[scattered] = -np.inf  # a scattered path has no probability without Rayleigh
+    w = rec["weight"] * np.exp(log_w)
+    pe_w = w * qe(wl) if qe is not None else w
+    t = rec["t_rel_ns"]
+
+    total = float(pe_w.sum())
+    sum_w2 = float((pe_w * pe_w).sum())
+    mean_t = float((pe_w * t).sum() / total) if total > 0.0 else float("nan")
+    rms_t = float(math.sqrt(max(0.0, (pe_w * (t - mean_t) ** 2).sum() / total))) if total > 0.0 else float("nan")
+    hist, _ = np.histogram(t, bins=edges, weights=pe_w)
+    return {
+        "model": model.name,
+        "optics": model.path,
+        "photons": int(t.size),
+        "events": n_events,
+        "detected": float(w.sum()),
+        "pe": total,
+        "pe_per_event": total / n_events if n_events > 0 else float("nan"),
+        "t_mean_ns": mean_t,
+        "t_rms_ns": rms_t,
+        "t_p10_ns": weighted_quantile(t, pe_w, 0.10),
+        "t_p50_ns": weighted_quantile(t, pe_w, 0.50),
+        "t_p90_ns": weighted_quantile(t, pe_w, 0.90),
+        # Kish effective sample size: how many unweighted photons the estimate is worth.
+        "ess": total * total / sum_w2 if sum_w2 > 0.0 else 0.0,
+        "max_weight": float(np.max(w / np.maximum(rec["weight"], 1e-300))) if w.size else 0.0,
+    }, hist
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("records", nargs="+", type=Path, help="--photon_records CSV file(s)")
+    parser.add_argument("--generated", type=Path, required=True, help="optics YAML of the generating run")
+    parser.add_argument("--gen_opt_enable", default=None,
+                        help="--opt_enable list of the generating run (default: all processes)")
+    parser.add_argument("--model", type=Path, action="append", default=None,
+                        help="target optics YAML (repeatable; default: optics_clear/lake/poor)")
+    parser.add_argument("--opt_enable", default="cerenkov,abs,rayleigh,boundary",
+                        help="optical processes of the target models")
+    parser.add_argument("--pmt", type=Path, default=Path("detector/config/pmt.yaml"),
+                        help="PMT config for QE(lambda); PE are expected photoelectrons before threshold")
+    parser.add_argument("--no_qe", action="store_true", help="report photocathode hits instead of PE")
+    parser.add_argument("--events", type=int, default=0,
+                        help="events simulated (default: events with at least one detected photon)")
+    parser.add_argument("--t_max_ns", type=float, default=600.0)
+    parser.add_argument("--t_bin_ns", type=float, default=2.0)
+    parser.add_argument("--json", type=Path, default=Path("out/day2/qc/optics_reweight.json"))
+    parser.add_argument("--csv", type=Path, default=Path("out/day2/qc/optics_reweight.csv"))
+    parser.add_argument("--time_csv", type=Path, default=Path("out/day2/qc/optics_reweight_time.csv"))
+    args = parser.parse_args(argv)
+
+    try:
+        gen = WaterModel(args.generated, parse_processes(args.gen_opt_enable))
+        target_procs = parse_processes(args.opt_enable)
+        model_paths = args.model or [Path("detector/config") / f"optics_{n}.yaml" for n in ("clear", "lake", "poor")]
+        models = [WaterModel(p, target_procs) for p in model_paths]
+        rec = load_records(args.records)
+        qe = None if args.no_qe else load_qe(args.pmt)
+    except (OSError, ValueError) as ex:
+        print(f"[Reweight] ERROR: {ex}", file=sys.stderr)
+        return 2
+
+    n_events = args.events if args.events > 0 else int(np.unique(rec["event"]).size)
+    edges = np.arange(0.0, args.t_max_ns + args.t_bin_ns, args.t_bin_ns)
+    results, hists = [], []
+    for model in models:
+        try:
+            summary, hist = summarise(model, gen, rec, qe, n_events, edges)
+        except ValueError as ex:
+            print(f"[Reweight] ERROR: {ex}", file=sys.stderr)
+            return 2
+        results.append(summary)
+        hists.append(hist)
+        print(f"[Reweight] {summary['model']}: pe/event={summary['pe_per_event']:.4g}"
+              f" t50={summary['t_p50_ns']:.4g} ns ess={summary['ess']:.4g}/{summary['photons']}")
+
+    for path in (args.json, args.csv, args.time_csv):
+        path.parent.mkdir(parents=True, exist_ok=True)
+    args.json.write_text(json.dumps(results, indent=2))
+    with args.csv.open("w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=list(results[0].keys()))
+        writer.writeheader()
+        writer.writerows(results)
+    with args.time_csv.open("w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["t_lo_ns", "t_hi_ns"] + [r["model"] for r in results])
+        for i in range(len(edges) - 1):
+            writer.writerow([edges[i], edges[i + 1]] + [float(h[i]) for h in hists])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,78 @@
+#!/usr/bin/env bash
+# Photocathode surface benchmark: one skin surface on PMT_cathode_log vs one
+# border surface per PMT copy, at several PMT counts (flndr_navbench with
+# per-copy placement, one process per configuration). Reports the startup
+# cost of creating and listing the surfaces and the optical surface lookup
+# time per boundary crossing. Fails if the two forms resolve a different set
+# of disc entries to the photocathode surface.
+#
+#   QC_NAVBENCH_PMTS="500 2000 10000" QC_NAVBENCH_RAYS=200000 \
+#     bash detector/tools/qc/photocathode_surface_bench.sh
+set -euo pipefail
+
+script_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_root="$(cd "$script_dir/../../.." && pwd)"
+source "$repo_root/detector/GEANT4.sh"
+
+outdir="$repo_root/out/day2/qc"
+mkdir -p "$outdir"
+counts="${QC_NAVBENCH_PMTS:-500 2000 10000}"
+rays="${QC_NAVBENCH_RAYS:-200000}"
+seed="${QC_NAVBENCH_SEED:-12345}"
+log="$outdir/photocathode_surface_bench.log"
+
+rm -f "$log.tmp"
+for n in $counts; do
+  for surface in border skin; do
+    echo "[SURFBENCH] pmts=${n} cathode_surface=${surface} ..."
+    "$repo_root/detector/build/flndr_navbench" --pmts="$n" --placement=copies --cathode_surface="$surface" \
+      --rays="$rays" --seed="$seed" | grep '^\[NavBench\]' | tee -a "$log.tmp"
+  done
+done
+mv "$log.tmp" "$log"
+
+python - "$log" "$outdir" <<'PY'
+import csv
+import json
+import sys
+from pathlib import Path
+
+log, outdir = Path(sys.argv[1]), Path(sys.argv[2])
+rows = []
+for line in log.read_text().splitlines():
+    fields = dict(kv.split("=", 1) for kv in line.split()[1:])
+    rows.append({k: (v if k in ("placement", "cathode_surface") else float(v)) for k, v in fields.items()})
+
+summary, bad = [], []
+for n in sorted({int(r["pmts"]) for r in rows}):
+    by = {r["cathode_surface"]: r for r in rows if int(r["pmts"]) == n}
+    if set(by) != {"border", "skin"}:
+        continue
+    b, s = by["border"], by["skin"]
+    same = (b["entries"], b["cathode_resolved"]) == (s["entries"], s["cathode_resolved"]) \
+        and s["cathode_resolved"] == s["entries"]
+    if not same:
+        bad.append(n)
+    summary.append({
+        "pmts": n,
+        "surfaces": {"border": int(b["surfaces"]), "skin": int(s["surfaces"])},
+        "surface_ms": {"border": b["surface_ms"], "skin": s["surface_ms"]},
+        "close_ms": {"border": b["close_ms"], "skin": s["close_ms"]},
+        "lookup_ns_per_boundary": {"border": b["lookup_ns_per_boundary"], "skin": s["lookup_ns_per_boundary"]},
+        "ns_per_step": {"border": b["ns_per_step"], "skin": s["ns_per_step"]},
+        "boundaries": int(s["boundaries"]),
+        "entries": int(s["entries"]),
+        "same_response": same,
+    })
+    print(f"[SURFBENCH] pmts={n}: surface_ms border={b['surface_ms']:.2f} skin={s['surface_ms']:.2f}"
+          f" lookup_ns/boundary border={b['lookup_ns_per_boundary']:.1f} skin={s['lookup_ns_per_boundary']:.1f}")
+
+(outdir / "photocathode_surface_bench.json").write_text(json.dumps(summary, indent=2))
+with (outdir / "photocathode_surface_bench.csv").open("w", newline="") as f:
+    writer = csv.DictWriter(f, fieldnames=list(rows[0].keys()))
+    writer.writeheader()
+    writer.writerows(rows)
+if bad:
+    raise SystemExit(f"[SURFBENCH] skin and border surfaces resolve different cathode hits at pmts={bad}")
+print(f"[SURFBENCH] Wrote {outdir / 'photocathode_surface_bench.json'}")
+PY
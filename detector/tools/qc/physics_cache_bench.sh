@@ -0,0 +1,81 @@
+#!/usr/bin/env bash
+# Physics table cache benchmark: the same short flndr job without a cache,
+# with an empty cache (tables built, then stored) and with the filled cache
+# (tables retrieved). Collects the [STARTUP] phase times and the wall time
+# of each, and checks that all three give exactly the same total PE: the
+# cache is binary and every event is reseeded from its key, so storing or
+# retrieving the tables must not change a single hit.
+#
+#   QC_PHYSICS_CACHE_MACRO=macros/detector/dev/mu50_fast_5.mac \
+#     bash detector/tools/qc/physics_cache_bench.sh
+set -euo pipefail
+
+script_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_root="$(cd "$script_dir/../../.." && pwd)"
+source "$repo_root/detector/GEANT4.sh"
+
+outdir="$repo_root/out/day2/qc"
+mkdir -p "$outdir"
+macro="${QC_PHYSICS_CACHE_MACRO:-$repo_root/macros/detector/dev/mu50_fast_5.mac}"
+cache="$outdir/physics_cache_bench.d"
+rm -rf "$cache"
+
+rm -f "$outdir/physics_cache_wall.txt.tmp"
+for mode in off cold warm; do
+  out_root="$outdir/physics_cache_${mode}.root"
+  log="$outdir/physics_cache_${mode}.log"
+  cache_arg="$cache"
+  [[ "$mode" == off ]] && cache_arg=off
+  echo "[PHYS_CACHE] Running ${mode}..."
+  rm -f "$out_root"
+  start=$(date +%s%N)
+  FLNDR_PMTHITS_OUT="$out_root" \
+    "$repo_root/detector/build/flndr" --profile=day2 --quiet --summary_every=0 \
+    --seed=12345 --event_seeding=1 --threshold_pe=0 --physics_cache="$cache_arg" "$macro" > "$log" 2>&1
+  end=$(date +%s%N)
+  echo "$mode $(( (end - start) / 1000000 ))" >> "$outdir/physics_cache_wall.txt.tmp"
+done
+mv "$outdir/physics_cache_wall.txt.tmp" "$outdir/physics_cache_wall.txt"
+
+python "$repo_root/detector/tools/qc/pe_yield.py" \
+  --json "$outdir/physics_cache_detail.json" --csv "$outdir/physics_cache_detail.csv" \
+  "$outdir/physics_cache_off.root" "$outdir/physics_cache_cold.root" "$outdir/physics_cache_warm.root"
+
+python - "$outdir" <<'PY'
+import json
+import re
+import sys
+from pathlib import Path
+
+qc = Path(sys.argv[1])
+by_file = {Path(e["file"]).name: e for e in json.loads((qc / "physics_cache_detail.json").read_text())}
+wall = dict(line.split() for line in (qc / "physics_cache_wall.txt").read_text().splitlines())
+
+summary = {}
+for mode in ("off", "cold", "warm"):
+    log = (qc / f"physics_cache_{mode}.log").read_text()
+    startup = re.search(r"^\[STARTUP\] (.*)$", log, re.M)
+    if not startup:
+        raise SystemExit(f"[PHYS_CACHE] no [STARTUP] line in physics_cache_{mode}.log")
+    fields = dict(kv.split("=", 1) for kv in startup.group(1).split())
+    row = {k: (v if k in ("physics_tables", "cache") else float(v)) for k, v in fields.items()}
+    row["wall_s"] = float(wall[mode]) / 1000.0
+    row["totalPE"] = by_file[f"physics_cache_{mode}.root"]["totalPE"]
+    summary[mode] = row
+
+off, warm = summary["off"], summary["warm"]
+summary["run_init_saving_ms"] = off["run_init_ms"] - warm["run_init_ms"]
+summary["to_first_run_saving_ms"] = off["to_first_run_ms"] - warm["to_first_run_ms"]
+out_path = qc / "physics_cache.json"
+out_path.write_text(json.dumps(summary, indent=2))
+for mode in ("off", "cold", "warm"):
+    r = summary[mode]
+    print(f"[PHYS_CACHE] {mode:>4}: tables={r['physics_tables']} run_init_ms={r['run_init_ms']:.0f}"
+          f" to_first_run_ms={r['to_first_run_ms']:.0f} wall_s={r['wall_s']:.2f} PE={r['totalPE']}")
+print(f"[PHYS_CACHE] Wrote summary JSON: {out_path}")
+if warm["physics_tables"] != "retrieved":
+    raise SystemExit("[PHYS_CACHE] the warm run did not retrieve the stored tables")
+pe = {mode: summary[mode]["totalPE"] for mode in ("off", "cold", "warm")}
+if len(set(pe.values())) != 1:
+    raise SystemExit(f"[PHYS_CACHE] total PE differs between runs: {pe}")
+PY
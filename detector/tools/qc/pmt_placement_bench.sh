@@ -0,0 +1,73 @@
+#!/usr/bin/env bash
+# Navigation benchmark: parameterised vs per-copy PMT placement at several
+# PMT counts (flndr_navbench, one process per configuration so the peak RSS
+# is per configuration). Fails if the two forms disagree on which discs the
+# rays enter.
+#
+#   QC_NAVBENCH_PMTS="500 2000 10000" QC_NAVBENCH_RAYS=200000 \
+#     bash detector/tools/qc/pmt_placement_bench.sh
+set -euo pipefail
+
+script_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_root="$(cd "$script_dir/../../.." && pwd)"
+source "$repo_root/detector/GEANT4.sh"
+
+outdir="$repo_root/out/day2/qc"
+mkdir -p "$outdir"
+counts="${QC_NAVBENCH_PMTS:-500 2000 10000}"
+rays="${QC_NAVBENCH_RAYS:-200000}"
+seed="${QC_NAVBENCH_SEED:-12345}"
+log="$outdir/pmt_placement_bench.log"
+
+rm -f "$log.tmp"
+for n in $counts; do
+  for placement in copies param; do
+    echo "[NAVBENCH] pmts=${n} placement=${placement} ..."
+    "$repo_root/detector/build/flndr_navbench" --pmts="$n" --placement="$placement" \
+      --rays="$rays" --seed="$seed" | grep '^\[NavBench\]' | tee -a "$log.tmp"
+  done
+done
+mv "$log.tmp" "$log"
+
+python - "$log" "$outdir" <<'PY'
+import csv
+import json
+import sys
+from pathlib import Path
+
+log, outdir = Path(sys.argv[1]), Path(sys.argv[2])
+rows = []
+for line in log.read_text().splitlines():
+    fields = dict(kv.split("=", 1) for kv in line.split()[1:])
+    rows.append({k: (v if k in ("placement", "cathode_surface") else float(v)) for k, v in fields.items()})
+
+summary, bad = [], []
+for n in sorted({int(r["pmts"]) for r in rows}):
+    by = {r["placement"]: r for r in rows if int(r["pmts"]) == n}
+    if set(by) != {"copies", "param"}:
+        continue
+    c, p = by["copies"], by["param"]
+    if (c["entries"], c["copy_sum"]) != (p["entries"], p["copy_sum"]):
+        bad.append(n)
+    summary.append({
+        "pmts": n,
+        "close_ms": {"copies": c["close_ms"], "param": p["close_ms"]},
+        "ns_per_step": {"copies": c["ns_per_step"], "param": p["ns_per_step"]},
+        "peak_rss_mb": {"copies": c["peak_rss_mb"], "param": p["peak_rss_mb"]},
+        "step_time_ratio": p["ns_per_step"] / c["ns_per_step"] if c["ns_per_step"] else float("nan"),
+        "entries": int(c["entries"]),
+        "same_hits": (c["entries"], c["copy_sum"]) == (p["entries"], p["copy_sum"]),
+    })
+    print(f"[NAVBENCH] pmts={n}: ns/step copies={c['ns_per_step']:.1f} param={p['ns_per_step']:.1f}"
+          f" close_ms copies={c['close_ms']:.1f} param={p['close_ms']:.1f}"
+          f" rss_mb copies={c['peak_rss_mb']:.1f} param={p['peak_rss_mb']:.1f}")
+
+(outdir / "pmt_placement_bench.json").write_text(json.dumps(summary, indent=2))
+with (outdir / "pmt_placement_bench.csv").open("w", newline="") as f:
+    writer = csv.DictWriter(f, fieldnames=list(rows[0].keys()))
+    writer.writeheader()
+    writer.writerows(rows)
+if bad:
+    raise SystemExit(f"[NAVBENCH] parameterised and copy placement disagree at pmts={bad}")
+print(f"[NAVBENCH] Wrote {outdir / 'pmt_placement_bench.json'}")
+PY
@@ -5,6 +5,7 @@ OUT=out/day2/qc
 mkdir -p "$OUT"
 
 source detector/GEANT4.sh
+# The physics table cache is opt-in: export FLNDR_PHYSICS_CACHE=<dir> to reuse tables across runs.
 
 # 1) Muon 50 GeV (fast, quiet)
 detector/build/flndr --profile=day2 --quiet \